@@ -4,7 +4,9 @@
 
 #include <algorithm>
 #include <iterator>
+#include <stdexcept>
 #include <tuple>
+#include <vector>
 
 namespace gdsb
 {
@@ -181,4 +183,85 @@ thread_batch(EdgeIt batch_begin, EdgeIt batch_end, unsigned int thread_count, un
     return Batch<EdgeContainer>{ start, end };
 }
 
+//! A partition of edges sorted by source which owns all edges of the source
+//! vertices [vertex_begin, vertex_end), these are the edges [edge_begin,
+//! edge_end).
+struct VertexPartition
+{
+    uint64_t vertex_begin = 0;
+    uint64_t vertex_end = 0;
+    uint64_t edge_begin = 0;
+    uint64_t edge_end = 0;
+
+    uint64_t edge_count() const { return edge_end - edge_begin; }
+};
+
+//! A partition of edges sorted by timestamp which owns all edges of the
+//! timestamps [timestamp_begin, timestamp_end), these are the edges
+//! [edge_begin, edge_end).
+struct TimePartition
+{
+    uint64_t timestamp_begin = 0;
+    uint64_t timestamp_end = 0;
+    uint64_t edge_begin = 0;
+    uint64_t edge_end = 0;
+
+    uint64_t edge_count() const { return edge_end - edge_begin; }
+};
+
+//! Cuts the source vertices [0, degrees.size()) into partition_count
+//! partitions of consecutive vertices, balancing the sum of cost(vertex,
+//! degree) of each partition. Just as thread_batch() for batches in memory,
+//! all edges of a source vertex belong to exactly one partition. Thus, the
+//! cost of a partition may deviate from the balanced cost by the cost of a
+//! vertex and partitions may be empty if there are fewer vertices than
+//! partitions.
+template <typename CostF>
+std::vector<VertexPartition> vertex_partitions(std::vector<Degree64> const& degrees, uint32_t const partition_count, CostF&& cost)
+{
+    if (partition_count == 0)
+    {
+        throw std::invalid_argument("Partition count must be greater than zero.");
+    }
+
+    uint64_t const vertex_count = degrees.size();
+    std::vector<double> cost_prefix(vertex_count + 1, 0.);
+    std::vector<uint64_t> edge_prefix(vertex_count + 1, 0u);
+    for (uint64_t v = 0; v < vertex_count; ++v)
+    {
+        cost_prefix[v + 1] = cost_prefix[v] + double(cost(v, degrees[v]));
+        edge_prefix[v + 1] = edge_prefix[v] + degrees[v];
+    }
+
+    // Partition p starts at the vertex boundary closest to p / partition_count
+    // of the total cost.
+    std::vector<uint64_t> cuts(partition_count + 1, vertex_count);
+    cuts[0] = 0;
+    for (uint32_t p = 1; p < partition_count; ++p)
+    {
+        double const target = cost_prefix.back() * double(p) / double(partition_count);
+        uint64_t cut = std::distance(std::begin(cost_prefix),
+                                     std::lower_bound(std::begin(cost_prefix), std::end(cost_prefix), target));
+        if (cut > 0 && target - cost_prefix[cut - 1] < cost_prefix[cut] - target)
+        {
+            --cut;
+        }
+        cuts[p] = std::max(cuts[p - 1], std::min(cut, vertex_count));
+    }
+
+    std::vector<VertexPartition> partitions(partition_count);
+    for (uint32_t p = 0; p < partition_count; ++p)
+    {
+        partitions[p] = { cuts[p], cuts[p + 1], edge_prefix[cuts[p]], edge_prefix[cuts[p + 1]] };
+    }
+
+    return partitions;
+}
+
+//! Cuts source vertices into partitions balancing the count of edges.
+inline std::vector<VertexPartition> vertex_partitions(std::vector<Degree64> const& degrees, uint32_t const partition_count)
+{
+    return vertex_partitions(degrees, partition_count, [](uint64_t, Degree64 const degree) { return degree; });
+}
+
 } // namespace gdsb
@@ -0,0 +1,416 @@
+#pragma once
+
+//! This file contains the serialization of edges to the raw edge layout of
+//! GDSB binary graph files: field by field (source, target, [weight],
+//! [timestamp]) without any padding. The byte sizes of the fields are declared
+//! by the binary graph header and may differ from the in-memory edge type:
+//! vertex IDs and timestamps may use 1 to 8 bytes, weights 4 (float) or 8
+//! (double) bytes. Thus, small graphs can be stored using narrow vertex IDs and
+//! graphs exceeding 32 bit vertex IDs can be stored and read into 64 bit edge
+//! types.
+
+#include <gdsb/graph.h>
+#include <gdsb/graph_io_parameters.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace gdsb
+{
+namespace binary
+{
+
+struct EdgeLayout
+{
+    uint8_t vertex_id_byte_size = 4u;
+    uint8_t weight_byte_size = 4u;
+    uint8_t timestamp_byte_size = 4u;
+    bool weighted = false;
+    bool dynamic = false;
+
+    size_t weight_offset() const { return 2 * size_t(vertex_id_byte_size); }
+
+    size_t timestamp_offset() const { return weight_offset() + (weighted ? weight_byte_size : 0u); }
+
+    size_t edge_size_in_bytes() const { return timestamp_offset() + (dynamic ? timestamp_byte_size : 0u); }
+
+    bool operator==(EdgeLayout const& other) const
+    {
+        return vertex_id_byte_size == other.vertex_id_byte_size && weighted == other.weighted &&
+            dynamic == other.dynamic && (!weighted || weight_byte_size == other.weight_byte_size) &&
+            (!dynamic || timestamp_byte_size == other.timestamp_byte_size);
+    }
+};
+
+//! Throws if the layout uses byte sizes the codec does not support.
+inline void check_edge_layout(EdgeLayout const& layout)
+{
+    if (layout.vertex_id_byte_size < 1 || layout.vertex_id_byte_size > 8)
+    {
+        throw std::logic_error("Unsupported vertex ID byte size: " + std::to_string(layout.vertex_id_byte_size));
+    }
+
+    if (layout.weighted && layout.weight_byte_size != sizeof(float) && layout.weight_byte_size != sizeof(double))
+    {
+        throw std::logic_error("Unsupported weight byte size: " + std::to_string(layout.weight_byte_size));
+    }
+
+    if (layout.dynamic && (layout.timestamp_byte_size < 1 || layout.timestamp_byte_size > 8))
+    {
+        throw std::logic_error("Unsupported timestamp byte size: " + std::to_string(layout.timestamp_byte_size));
+    }
+}
+
+inline EdgeLayout edge_layout(BinaryGraphHeader const& header)
+{
+    EdgeLayout layout;
+    layout.vertex_id_byte_size = header.vertex_id_byte_size;
+    layout.weight_byte_size = header.weight_byte_size;
+    layout.timestamp_byte_size = header.timestamp_byte_size;
+    layout.weighted = header.weighted;
+    layout.dynamic = header.dynamic;
+    return layout;
+}
+
+//! The layout storing each field using the size of the in-memory edge type.
+template <typename EdgeT> EdgeLayout native_edge_layout()
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    EdgeLayout layout;
+    layout.vertex_id_byte_size = sizeof(typename Traits::Vertex);
+    layout.weight_byte_size = sizeof(typename Traits::Weight);
+    layout.timestamp_byte_size = sizeof(typename Traits::Timestamp);
+    layout.weighted = Traits::is_weighted();
+    layout.dynamic = Traits::is_dynamic();
+    return layout;
+}
+
+template <typename EdgeT> size_t edge_size_in_bytes() { return native_edge_layout<EdgeT>().edge_size_in_bytes(); }
+
+//! Returns the smallest count of bytes (at least one) to represent value.
+inline uint8_t byte_width(uint64_t value)
+{
+    uint8_t width = 1;
+    while (value >>= 8)
+    {
+        ++width;
+    }
+
+    return width;
+}
+
+template <unsigned Width> uint64_t load_uint(uint8_t const* const in)
+{
+    // Files are written using the byte order of the host just as the header,
+    // which on all supported platforms is little endian.
+    if constexpr (Width == 1)
+    {
+        return *in;
+    }
+    else if constexpr (Width == 2)
+    {
+        uint16_t value;
+        std::memcpy(&value, in, Width);
+        return value;
+    }
+    else if constexpr (Width == 4)
+    {
+        uint32_t value;
+        std::memcpy(&value, in, Width);
+        return value;
+    }
+    else
+    {
+        uint64_t value = 0;
+        std::memcpy(&value, in, Width);
+        return value;
+    }
+}
+
+template <unsigned Width> void store_uint(uint8_t* const out, uint64_t const value)
+{
+    if constexpr (Width == 1)
+    {
+        *out = uint8_t(value);
+    }
+    else if constexpr (Width == 2)
+    {
+        uint16_t const narrow = uint16_t(value);
+        std::memcpy(out, &narrow, Width);
+    }
+    else if constexpr (Width == 4)
+    {
+        uint32_t const narrow = uint32_t(value);
+        std::memcpy(out, &narrow, Width);
+    }
+    else
+    {
+        std::memcpy(out, &value, Width);
+    }
+}
+
+// Field wise loops with a compile time width, thus the compiler can unroll and
+// vectorize widening (decoding) and narrowing (encoding) of the integers.
+// Both return all values combined by bitwise or to check their range.
+template <unsigned Width, typename SetF>
+uint64_t decode_uint_field(uint8_t const* const in, size_t const stride, size_t const count, SetF&& set)
+{
+    uint64_t all = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64_t const value = load_uint<Width>(in + i * stride);
+        all |= value;
+        set(i, value);
+    }
+
+    return all;
+}
+
+template <unsigned Width, typename GetF>
+uint64_t encode_uint_field(uint8_t* const out, size_t const stride, size_t const count, GetF&& get)
+{
+    uint64_t all = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64_t const value = get(i);
+        all |= value;
+        store_uint<Width>(out + i * stride, value);
+    }
+
+    return all;
+}
+
+template <typename SetF>
+uint64_t decode_uint_field(unsigned const width, uint8_t const* const in, size_t const stride, size_t const count, SetF&& set)
+{
+    switch (width)
+    {
+    case 1:
+        return decode_uint_field<1>(in, stride, count, set);
+    case 2:
+        return decode_uint_field<2>(in, stride, count, set);
+    case 3:
+        return decode_uint_field<3>(in, stride, count, set);
+    case 4:
+        return decode_uint_field<4>(in, stride, count, set);
+    case 5:
+        return decode_uint_field<5>(in, stride, count, set);
+    case 6:
+        return decode_uint_field<6>(in, stride, count, set);
+    case 7:
+        return decode_uint_field<7>(in, stride, count, set);
+    case 8:
+        return decode_uint_field<8>(in, stride, count, set);
+    default:
+        throw std::logic_error("Unsupported integer byte size: " + std::to_string(width));
+    }
+}
+
+template <typename GetF>
+uint64_t encode_uint_field(unsigned const width, uint8_t* const out, size_t const stride, size_t const count, GetF&& get)
+{
+    switch (width)
+    {
+    case 1:
+        return encode_uint_field<1>(out, stride, count, get);
+    case 2:
+        return encode_uint_field<2>(out, stride, count, get);
+    case 3:
+        return encode_uint_field<3>(out, stride, count, get);
+    case 4:
+        return encode_uint_field<4>(out, stride, count, get);
+    case 5:
+        return encode_uint_field<5>(out, stride, count, get);
+    case 6:
+        return encode_uint_field<6>(out, stride, count, get);
+    case 7:
+        return encode_uint_field<7>(out, stride, count, get);
+    case 8:
+        return encode_uint_field<8>(out, stride, count, get);
+    default:
+        throw std::logic_error("Unsupported integer byte size: " + std::to_string(width));
+    }
+}
+
+template <typename FloatT, typename GetF>
+void encode_float_field(uint8_t* const out, size_t const stride, size_t const count, GetF&& get)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        FloatT const value = FloatT(get(i));
+        std::memcpy(out + i * stride, &value, sizeof(value));
+    }
+}
+
+template <typename FloatT, typename SetF>
+void decode_float_field(uint8_t const* const in, size_t const stride, size_t const count, SetF&& set)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        FloatT value;
+        std::memcpy(&value, in + i * stride, sizeof(value));
+        set(i, value);
+    }
+}
+
+template <typename T> void check_fits(uint64_t const all, char const* const field)
+{
+    if (all > uint64_t(std::numeric_limits<T>::max()))
+    {
+        throw std::out_of_range(std::string(field) + " exceeds the range of the edge type.");
+    }
+}
+
+inline void check_fits_width(uint64_t const all, unsigned const width, char const* const field)
+{
+    if (width < 8 && (all >> (8 * width)) != 0)
+    {
+        throw std::out_of_range(std::string(field) + " exceeds the byte size of the edge layout.");
+    }
+}
+
+//! Returns true if edges of type EdgeT are stored in memory exactly as in the
+//! given layout, thus they can be copied as a whole.
+template <typename EdgeT> bool is_memory_layout(EdgeLayout const& layout)
+{
+    return layout == native_edge_layout<EdgeT>() && sizeof(EdgeT) == layout.edge_size_in_bytes();
+}
+
+//! Serializes count edges to out using the given layout, out must provide
+//! count * layout.edge_size_in_bytes() bytes. Throws if a value exceeds the
+//! byte size of its field. Returns the position after the last written byte.
+template <typename EdgeT> uint8_t* encode_edges(EdgeT const* const edges, size_t const count, EdgeLayout const& layout, uint8_t* const out)
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    size_t const stride = layout.edge_size_in_bytes();
+    if (is_memory_layout<EdgeT>(layout))
+    {
+        std::memcpy(out, edges, count * stride);
+        return out + count * stride;
+    }
+
+    unsigned const v_width = layout.vertex_id_byte_size;
+    check_fits_width(encode_uint_field(v_width, out, stride, count,
+                                       [&](size_t i) { return uint64_t(Traits::source(edges[i])); }),
+                     v_width, "Source vertex ID");
+    check_fits_width(encode_uint_field(v_width, out + v_width, stride, count,
+                                       [&](size_t i) { return uint64_t(Traits::target(edges[i])); }),
+                     v_width, "Target vertex ID");
+
+    if (layout.weighted)
+    {
+        uint8_t* const weights = out + layout.weight_offset();
+        auto const get = [&](size_t i) { return Traits::weight(edges[i]); };
+        if (layout.weight_byte_size == sizeof(float))
+        {
+            encode_float_field<float>(weights, stride, count, get);
+        }
+        else
+        {
+            encode_float_field<double>(weights, stride, count, get);
+        }
+    }
+
+    if (layout.dynamic)
+    {
+        unsigned const t_width = layout.timestamp_byte_size;
+        check_fits_width(encode_uint_field(t_width, out + layout.timestamp_offset(), stride, count,
+                                           [&](size_t i) { return uint64_t(Traits::timestamp(edges[i])); }),
+                         t_width, "Timestamp");
+    }
+
+    return out + count * stride;
+}
+
+//! Deserializes count edges from in using the given layout, see
+//! encode_edges(). Throws if a value exceeds the range of the edge type.
+//! Returns the position after the last read byte.
+template <typename EdgeT>
+uint8_t const* decode_edges(uint8_t const* const in, size_t const count, EdgeLayout const& layout, EdgeT* const edges)
+{
+    using Traits = EdgeTraits<EdgeT>;
+    using Vertex_t = typename Traits::Vertex;
+    using Timestamp_t = typename Traits::Timestamp;
+
+    size_t const stride = layout.edge_size_in_bytes();
+    if (is_memory_layout<EdgeT>(layout))
+    {
+        std::memcpy(edges, in, count * stride);
+        return in + count * stride;
+    }
+
+    unsigned const v_width = layout.vertex_id_byte_size;
+    check_fits<Vertex_t>(decode_uint_field(v_width, in, stride, count,
+                                           [&](size_t i, uint64_t v) { Traits::source(edges[i]) = Vertex_t(v); }),
+                         "Source vertex ID");
+    check_fits<Vertex_t>(decode_uint_field(v_width, in + v_width, stride, count,
+                                           [&](size_t i, uint64_t v) { Traits::target(edges[i]) = Vertex_t(v); }),
+                         "Target vertex ID");
+
+    if constexpr (Traits::is_weighted())
+    {
+        uint8_t const* const weights = in + layout.weight_offset();
+        auto const set = [&](size_t i, auto w) { Traits::set_weight(edges[i], typename Traits::Weight(w)); };
+        if (layout.weight_byte_size == sizeof(float))
+        {
+            decode_float_field<float>(weights, stride, count, set);
+        }
+        else
+        {
+            decode_float_field<double>(weights, stride, count, set);
+        }
+    }
+
+    if constexpr (Traits::is_dynamic())
+    {
+        check_fits<Timestamp_t>(decode_uint_field(layout.timestamp_byte_size, in + layout.timestamp_offset(), stride, count,
+                                                  [&](size_t i, uint64_t t)
+                                                  { Traits::set_timestamp(edges[i], Timestamp_t(t)); }),
+                                "Timestamp");
+    }
+
+    return in + count * stride;
+}
+
+//! Serializes edges using their native layout, see native_edge_layout().
+template <typename EdgeT> uint8_t* encode_edges(EdgeT const* const edges, size_t const count, uint8_t* const out)
+{
+    return encode_edges(edges, count, native_edge_layout<EdgeT>(), out);
+}
+
+template <typename EdgeT> uint8_t const* decode_edges(uint8_t const* const in, size_t const count, EdgeT* const edges)
+{
+    return decode_edges(in, count, native_edge_layout<EdgeT>(), edges);
+}
+
+//! Returns the narrowest layout for the given edges: vertex IDs and timestamps
+//! use the fewest bytes to represent the largest value, weights keep the size
+//! of the edge type.
+template <typename EdgeT> EdgeLayout narrowest_edge_layout(EdgeT const* const edges, size_t const count, uint64_t const vertex_count)
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    uint64_t max_vertex = vertex_count > 0 ? vertex_count - 1 : 0;
+    uint64_t max_timestamp = 0;
+
+#pragma omp parallel for reduction(max : max_vertex, max_timestamp)
+    for (int64_t i = 0; i < int64_t(count); ++i)
+    {
+        max_vertex = std::max(max_vertex, uint64_t(std::max(Traits::source(edges[i]), Traits::target(edges[i]))));
+        max_timestamp = std::max(max_timestamp, uint64_t(Traits::timestamp(edges[i])));
+    }
+
+    EdgeLayout layout = native_edge_layout<EdgeT>();
+    layout.vertex_id_byte_size = byte_width(max_vertex);
+    layout.timestamp_byte_size = byte_width(max_timestamp);
+    return layout;
+}
+
+} // namespace binary
+} // namespace gdsb
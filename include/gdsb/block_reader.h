@@ -0,0 +1,80 @@
+#pragma once
+
+//! This file contains a reader of large byte ranges of a file, e.g. the edges
+//! of a binary graph. The range is read in blocks while a configurable count
+//! of reads is kept in flight, and completed blocks are handed to OpenMP tasks
+//! for processing (e.g. decoding) while further reads are pending. On Linux
+//! the reads are submitted using io_uring into registered buffers, otherwise or
+//! if io_uring is not available at runtime, blocks are read using pread().
+//! Reads may bypass the page cache using O_DIRECT, e.g. to load huge graphs
+//! once without evicting the data structure under test or to measure the
+//! throughput of cold storage.
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+
+namespace gdsb
+{
+
+enum class BlockReaderBackend
+{
+    // io_uring if available at runtime, pread otherwise.
+    automatic,
+    io_uring,
+    pread
+};
+
+struct BlockReaderOptions
+{
+    BlockReaderBackend backend = BlockReaderBackend::automatic;
+    // Size of a read in bytes, rounded down to a multiple of the unit of
+    // BlockReader::read().
+    size_t block_size = size_t(4) << 20;
+    // Count of reads in flight.
+    unsigned queue_depth = 8;
+    // Opens the file using O_DIRECT. Reads then cover the requested blocks
+    // rounded to direct_io_alignment. Falls back to buffered reads dropping
+    // the page cache if the file system does not support O_DIRECT.
+    bool direct = false;
+    // Buffered reads only: drops read blocks from the page cache using
+    // posix_fadvise(POSIX_FADV_DONTNEED) once they are processed.
+    bool drop_page_cache = false;
+};
+
+//! Alignment of file offsets, sizes and buffers of direct reads.
+constexpr size_t direct_io_alignment = 4096;
+
+class BlockReader
+{
+public:
+    //! Called for every block with the file offset of its first byte, in
+    //! parallel and in any order. The data is valid during the call only.
+    using BlockF = std::function<void(uint64_t offset, uint8_t const* data, size_t size)>;
+
+    explicit BlockReader(std::filesystem::path const& file_path, BlockReaderOptions const& options = BlockReaderOptions{});
+    ~BlockReader();
+
+    BlockReader(BlockReader const&) = delete;
+    BlockReader& operator=(BlockReader const&) = delete;
+
+    //! Returns the backend in use, never automatic.
+    BlockReaderBackend backend() const;
+
+    //! Returns true if the file is read using O_DIRECT.
+    bool direct() const;
+
+    //! Reads the bytes [begin, end) of the file in blocks of a multiple of
+    //! unit bytes each (except for the last one) and calls f for each
+    //! completed block from an OpenMP task. Returns once all blocks are
+    //! processed, rethrows the exceptions thrown by f.
+    void read(uint64_t begin, uint64_t end, size_t unit, BlockF const& f);
+
+private:
+    struct Implementation;
+    std::unique_ptr<Implementation> m_implementation;
+};
+
+} // namespace gdsb
@@ -0,0 +1,346 @@
+#pragma once
+
+//! This file contains composable edge predicates for the binary graph readers:
+//! source and target ranges, a timestamp window, weight thresholds and a
+//! vertex bitmap. Readers evaluate the filter over blocks of decoded edges and
+//! keep the matching edges only, thus the result is never materialized in
+//! full. If a binary graph is sorted by source or by timestamp (see
+//! BinaryGraphStatistics), the edges outside of the source range or the time
+//! window are not read at all.
+
+#include <gdsb/graph.h>
+#include <gdsb/graph_input.h>
+#include <gdsb/graph_io_parameters.h>
+#include <gdsb/graph_sections.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdsb
+{
+
+//! A set of vertices [0, size()), e.g. to read an induced subgraph.
+class VertexBitmap
+{
+public:
+    VertexBitmap() = default;
+    explicit VertexBitmap(uint64_t const vertex_count)
+        : m_words((vertex_count + 63) / 64, 0u)
+        , m_size(vertex_count)
+    {
+    }
+
+    void set(uint64_t const v) { m_words.at(v / 64) |= uint64_t(1) << (v % 64); }
+    void reset(uint64_t const v) { m_words.at(v / 64) &= ~(uint64_t(1) << (v % 64)); }
+
+    //! Returns false for vertices not less than size().
+    bool test(uint64_t const v) const { return v < m_size && (m_words[v / 64] >> (v % 64)) & 1u; }
+
+    uint64_t size() const { return m_size; }
+
+    //! Returns the vertices set in both bitmaps.
+    VertexBitmap operator&(VertexBitmap const& other) const
+    {
+        VertexBitmap result(std::min(m_size, other.m_size));
+        for (size_t w = 0; w < result.m_words.size(); ++w)
+        {
+            result.m_words[w] = m_words[w] & other.m_words[w];
+        }
+        if (result.m_size % 64 != 0 && !result.m_words.empty())
+        {
+            result.m_words.back() &= (uint64_t(1) << (result.m_size % 64)) - 1;
+        }
+
+        return result;
+    }
+
+private:
+    std::vector<uint64_t> m_words;
+    uint64_t m_size = 0;
+};
+
+//! Conjunction of edge predicates, all of them match any edge by default.
+//! Restrict a filter using the member functions or combine filters using
+//! operator&&, e.g.
+//!   EdgeFilter{}.sources(0, 100).window(t0, t1) && EdgeFilter{}.min_weight(.5f)
+struct EdgeFilter
+{
+    // Half-open ranges [begin, end).
+    uint64_t source_begin = 0;
+    uint64_t source_end = std::numeric_limits<uint64_t>::max();
+    uint64_t target_begin = 0;
+    uint64_t target_end = std::numeric_limits<uint64_t>::max();
+    uint64_t timestamp_begin = 0;
+    uint64_t timestamp_end = std::numeric_limits<uint64_t>::max();
+    // Closed range [weight_min, weight_max].
+    Weight weight_min = std::numeric_limits<Weight>::lowest();
+    Weight weight_max = std::numeric_limits<Weight>::max();
+    // Keeps edges with both vertices set only, all vertices if nullptr.
+    std::shared_ptr<VertexBitmap const> vertices;
+
+    EdgeFilter& sources(uint64_t const begin, uint64_t const end)
+    {
+        source_begin = std::max(source_begin, begin);
+        source_end = std::max(source_begin, std::min(source_end, end));
+        return *this;
+    }
+
+    EdgeFilter& targets(uint64_t const begin, uint64_t const end)
+    {
+        target_begin = std::max(target_begin, begin);
+        target_end = std::max(target_begin, std::min(target_end, end));
+        return *this;
+    }
+
+    EdgeFilter& window(uint64_t const t0, uint64_t const t1)
+    {
+        timestamp_begin = std::max(timestamp_begin, t0);
+        timestamp_end = std::max(timestamp_begin, std::min(timestamp_end, t1));
+        return *this;
+    }
+
+    EdgeFilter& min_weight(Weight const w)
+    {
+        weight_min = std::max(weight_min, w);
+        return *this;
+    }
+
+    EdgeFilter& max_weight(Weight const w)
+    {
+        weight_max = std::min(weight_max, w);
+        return *this;
+    }
+
+    EdgeFilter& within(VertexBitmap bitmap)
+    {
+        vertices = std::make_shared<VertexBitmap const>(vertices ? *vertices & bitmap : std::move(bitmap));
+        return *this;
+    }
+
+    bool restricts_sources() const { return source_begin > 0 || source_end < std::numeric_limits<uint64_t>::max(); }
+    bool restricts_timestamps() const { return timestamp_begin > 0 || timestamp_end < std::numeric_limits<uint64_t>::max(); }
+    bool restricts_weights() const
+    {
+        return weight_min > std::numeric_limits<Weight>::lowest() || weight_max < std::numeric_limits<Weight>::max();
+    }
+
+    template <typename EdgeT> bool operator()(EdgeT const& e) const
+    {
+        using Traits = EdgeTraits<EdgeT>;
+
+        uint64_t const u = uint64_t(Traits::source(e));
+        uint64_t const v = uint64_t(Traits::target(e));
+        uint64_t const t = uint64_t(Traits::timestamp(e));
+        Weight const w = Traits::weight(e);
+        return u - source_begin < source_end - source_begin && v - target_begin < target_end - target_begin &&
+            t - timestamp_begin < timestamp_end - timestamp_begin && w >= weight_min && w <= weight_max &&
+            (!vertices || (vertices->test(u) && vertices->test(v)));
+    }
+};
+
+//! Returns a filter matching the edges matched by both filters.
+inline EdgeFilter operator&&(EdgeFilter a, EdgeFilter const& b)
+{
+    a.sources(b.source_begin, b.source_end).targets(b.target_begin, b.target_end).window(b.timestamp_begin, b.timestamp_end);
+    a.min_weight(b.weight_min).max_weight(b.weight_max);
+    if (b.vertices)
+    {
+        a.within(*b.vertices);
+    }
+
+    return a;
+}
+
+//! Returns the filter extracting the subgraph as read_graph() does.
+template <typename V> EdgeFilter subgraph_filter(Subgraph<V> const& subgraph)
+{
+    return EdgeFilter{}.sources(subgraph.source_begin, subgraph.source_end).targets(subgraph.target_begin, subgraph.target_end);
+}
+
+//! Throws if the filter restricts fields the edge type does not have.
+template <typename EdgeT> void check_edge_filter(EdgeFilter const& filter)
+{
+    if (filter.restricts_timestamps() && !EdgeTraits<EdgeT>::is_dynamic())
+    {
+        throw std::logic_error("Time windows require a dynamic edge type.");
+    }
+    if (filter.restricts_weights() && !EdgeTraits<EdgeT>::is_weighted())
+    {
+        throw std::logic_error("Weight thresholds require a weighted edge type.");
+    }
+}
+
+//! Moves the edges of [edges, edges + count) matching the filter to the front,
+//! keeping their order, and returns their count. The range predicates are
+//! evaluated without branches for all edges first such that the compiler may
+//! vectorize the loop, keep is used as scratch space.
+template <typename EdgeT>
+size_t filter_edges(EdgeT* const edges, size_t const count, EdgeFilter const& filter, std::vector<uint8_t>& keep)
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    keep.resize(count);
+    uint8_t* const k = keep.data();
+
+    uint64_t const source_begin = filter.source_begin;
+    uint64_t const source_width = filter.source_end - filter.source_begin;
+    uint64_t const target_begin = filter.target_begin;
+    uint64_t const target_width = filter.target_end - filter.target_begin;
+
+#pragma omp simd
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64_t const u = uint64_t(Traits::source(edges[i]));
+        uint64_t const v = uint64_t(Traits::target(edges[i]));
+        k[i] = uint8_t(u - source_begin < source_width) & uint8_t(v - target_begin < target_width);
+    }
+
+    if constexpr (Traits::is_dynamic())
+    {
+        uint64_t const timestamp_begin = filter.timestamp_begin;
+        uint64_t const timestamp_width = filter.timestamp_end - filter.timestamp_begin;
+#pragma omp simd
+        for (size_t i = 0; i < count; ++i)
+        {
+            k[i] &= uint8_t(uint64_t(Traits::timestamp(edges[i])) - timestamp_begin < timestamp_width);
+        }
+    }
+
+    if constexpr (Traits::is_weighted())
+    {
+        Weight const weight_min = filter.weight_min;
+        Weight const weight_max = filter.weight_max;
+#pragma omp simd
+        for (size_t i = 0; i < count; ++i)
+        {
+            Weight const w = Traits::weight(edges[i]);
+            k[i] &= uint8_t(w >= weight_min) & uint8_t(w <= weight_max);
+        }
+    }
+
+    if (filter.vertices)
+    {
+        VertexBitmap const& vertices = *filter.vertices;
+        for (size_t i = 0; i < count; ++i)
+        {
+            k[i] &= uint8_t(vertices.test(uint64_t(Traits::source(edges[i]))) && vertices.test(uint64_t(Traits::target(edges[i]))));
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        edges[kept] = edges[i];
+        kept += k[i];
+    }
+
+    return kept;
+}
+
+//! Returns the edge range [begin, end) of a binary graph holding all edges
+//! matching the filter: narrowed to the source range if the edges are sorted
+//! by source, and to the time window if they are sorted by timestamp. Input
+//! must be positioned at the end of the header, the position is restored
+//! afterwards.
+template <typename EdgeT>
+std::pair<uint64_t, uint64_t> filtered_edge_range(std::ifstream& input, BinaryGraphHeader const& header, EdgeFilter const& filter)
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    uint64_t begin = 0;
+    uint64_t end = header.edge_count;
+
+    std::optional<BinaryGraphStatistics> const statistics = read_binary_graph_statistics(input, header);
+    if (!statistics)
+    {
+        return { begin, end };
+    }
+
+    if (statistics->sorted_by_source && filter.restricts_sources())
+    {
+        auto const source = [](EdgeT const& e) { return Traits::source(e); };
+        begin = edge_lower_bound<EdgeT>(input, header, begin, end, source, filter.source_begin);
+        end = std::max(begin, edge_lower_bound<EdgeT>(input, header, begin, end, source, filter.source_end));
+    }
+
+    if constexpr (Traits::is_dynamic())
+    {
+        if (statistics->sorted_by_timestamp && filter.restricts_timestamps())
+        {
+            std::optional<TimestampIndex> const index = read_timestamp_index(input, header);
+            TimestampIndex const* const index_ptr = index ? &*index : nullptr;
+            begin = std::max(begin, timestamp_lower_bound<EdgeT>(input, header, index_ptr, filter.timestamp_begin));
+            end = std::max(begin, std::min(end, timestamp_lower_bound<EdgeT>(input, header, index_ptr, filter.timestamp_end)));
+        }
+    }
+
+    return { begin, end };
+}
+
+//! Reads the edges of a binary graph matching the filter, regardless of the
+//! edge encoding. Only the edge range returned by filtered_edge_range() is
+//! read, block by block for raw edges and chunk by chunk for chunk encoded
+//! edges, and each decoded block is filtered using filter_edges() before the
+//! matching edges are appended. Input must be positioned at the end of the
+//! header, the position is restored afterwards.
+template <typename EdgeT>
+std::vector<EdgeT> read_binary_edges(std::ifstream& input, BinaryGraphHeader const& header, EdgeFilter const& filter)
+{
+    check_binary_edge_type<EdgeT>(header);
+    check_edge_filter<EdgeT>(filter);
+
+    auto const [begin, end] = filtered_edge_range<EdgeT>(input, header, filter);
+
+    std::vector<EdgeT> edges;
+    std::vector<uint8_t> keep;
+    auto const append = [&](EdgeT* const block, size_t const count)
+    {
+        size_t const kept = filter_edges(block, count, filter, keep);
+        edges.insert(edges.end(), block, block + kept);
+    };
+
+    if (is_chunked(header.encoding))
+    {
+        if (begin == end)
+        {
+            return edges;
+        }
+
+        std::streampos const edges_begin = input.tellg();
+        EdgeChunkDirectory const directory = read_chunk_directory(input);
+        std::streampos const chunks_begin = input.tellg();
+        std::vector<uint8_t> bytes;
+        std::vector<EdgeT> chunk;
+        for (uint64_t c = begin / directory.chunk_edge_count; c <= (end - 1) / directory.chunk_edge_count; ++c)
+        {
+            read_edge_chunk(input, header, directory, chunks_begin, c, bytes, chunk);
+            uint64_t const chunk_begin = directory.chunk_edge_offset(c);
+            uint64_t const copy_begin = std::max(begin, chunk_begin) - chunk_begin;
+            uint64_t const copy_end = std::min(end, chunk_begin + chunk.size()) - chunk_begin;
+            append(chunk.data() + copy_begin, copy_end - copy_begin);
+        }
+
+        input.clear();
+        input.seekg(edges_begin);
+        return edges;
+    }
+
+    uint64_t const block_edge_count = uint64_t(1) << 16;
+    for (uint64_t block_begin = begin; block_begin < end; block_begin += block_edge_count)
+    {
+        std::vector<EdgeT> block =
+            read_binary_edge_range<EdgeT>(input, header, block_begin, std::min(end, block_begin + block_edge_count));
+        append(block.data(), block.size());
+    }
+
+    return edges;
+}
+
+} // namespace gdsb
@@ -80,36 +80,94 @@ using TimestampedEdges64 = std::vector<TimestampedEdge64>;
 using WeightedTimestampedEdge64 = TimestampedEdge<WeightedEdge64, Timestamp64>;
 using WeightedTimestampedEdges64 = std::vector<WeightedTimestampedEdge64>;
 
-template <typename EdgesT> auto max_nnz(EdgesT const& edges)
+//! Uniform access to the fields of all edge types defined above. Code that is
+//! generic over plain, weighted and timestamped edges (e.g. binary encoders)
+//! should use EdgeTraits<EdgeT>::source(e) etc. instead of accessing members.
+//! Unweighted edges report a weight of 1 and static edges a timestamp of 0,
+//! the respective setters are no-ops.
+template <typename EdgeT> struct EdgeTraits;
+
+template <typename VertexT> struct EdgeTraits<Edge<VertexT, VertexT>>
 {
-    std::vector<EdgesT> ids;
+    using Vertex = VertexT;
+    using Weight = gdsb::Weight;
+    using Timestamp = Timestamp32;
+
+    static constexpr bool is_weighted() { return false; }
+    static constexpr bool is_dynamic() { return false; }
+
+    template <typename E> static auto& source(E& e) { return e.source; }
+    template <typename E> static auto& target(E& e) { return e.target; }
+    template <typename E> static Weight weight(E const&) { return 1.f; }
+    template <typename E> static void set_weight(E&, Weight) {}
+    template <typename E> static Timestamp timestamp(E const&) { return 0u; }
+    template <typename E> static void set_timestamp(E&, Timestamp) {}
+};
+
+template <typename VertexT, typename WeightT> struct EdgeTraits<Edge<VertexT, Target<VertexT, WeightT>>>
+{
+    using Vertex = VertexT;
+    using Weight = WeightT;
+    using Timestamp = Timestamp32;
+
+    static constexpr bool is_weighted() { return true; }
+    static constexpr bool is_dynamic() { return false; }
+
+    template <typename E> static auto& source(E& e) { return e.source; }
+    template <typename E> static auto& target(E& e) { return e.target.vertex; }
+    template <typename E> static Weight weight(E const& e) { return e.target.weight; }
+    template <typename E> static void set_weight(E& e, Weight w) { e.target.weight = w; }
+    template <typename E> static Timestamp timestamp(E const&) { return 0u; }
+    template <typename E> static void set_timestamp(E&, Timestamp) {}
+};
+
+template <typename EdgeT, typename TimestampT> struct EdgeTraits<TimestampedEdge<EdgeT, TimestampT>>
+{
+    using Vertex = typename EdgeTraits<EdgeT>::Vertex;
+    using Weight = typename EdgeTraits<EdgeT>::Weight;
+    using Timestamp = TimestampT;
+
+    static constexpr bool is_weighted() { return EdgeTraits<EdgeT>::is_weighted(); }
+    static constexpr bool is_dynamic() { return true; }
+
+    template <typename E> static auto& source(E& e) { return EdgeTraits<EdgeT>::source(e.edge); }
+    template <typename E> static auto& target(E& e) { return EdgeTraits<EdgeT>::target(e.edge); }
+    template <typename E> static Weight weight(E const& e) { return EdgeTraits<EdgeT>::weight(e.edge); }
+    template <typename E> static void set_weight(E& e, Weight w) { EdgeTraits<EdgeT>::set_weight(e.edge, w); }
+    template <typename E> static Timestamp timestamp(E const& e) { return e.timestamp; }
+    template <typename E> static void set_timestamp(E& e, Timestamp t) { e.timestamp = t; }
+};
+
+//! Returns the maximum count of edges sharing a source vertex.
+template <typename EdgesT> Degree64 max_nnz(EdgesT const& edges)
+{
+    using Traits = EdgeTraits<typename EdgesT::value_type>;
 
+    std::vector<Degree64> degrees;
     for (auto const& e : edges)
     {
-        if (e.source >= ids.size())
-        {
-            ids.resize(e.source + 1);
-            ids[e.source] = 1;
-        }
-        else
+        auto const source = Traits::source(e);
+        if (source >= degrees.size())
         {
-            ids[e.source]++;
+            degrees.resize(source + 1, 0u);
         }
+
+        ++degrees[source];
     }
 
-    return *std::max_element(std::begin(ids), std::end(ids));
+    return degrees.empty() ? 0u : *std::max_element(std::begin(degrees), std::end(degrees));
 }
 
-template <typename Edges_t> decltype(Edges_t::value_type::source) vertex_count(Edges_t const& edges)
+template <typename Edges_t> typename EdgeTraits<typename Edges_t::value_type>::Vertex vertex_count(Edges_t const& edges)
 {
-    using Vertex_t = decltype(Edges_t::value_type::source);
+    using Traits = EdgeTraits<typename Edges_t::value_type>;
+    using Vertex_t = typename Traits::Vertex;
 
     // Determine n as the maximal node ID.
     Vertex_t n = 0;
-    using Edge_type = typename Edges_t::value_type;
-    for (Edge_type const& edge : edges)
+    for (auto const& edge : edges)
     {
-        Vertex_t const vertex = std::max(edge.source, edge.target.vertex);
+        Vertex_t const vertex = std::max(Traits::source(edge), Traits::target(edge));
         n = std::max(n, vertex);
     }
     n++;
@@ -117,6 +175,43 @@ template <typename Edges_t> decltype(Edges_t::value_type::source) vertex_count(E
     return n;
 }
 
+//! Orders edges of any edge type by source, then target, then timestamp.
+struct EdgeLess
+{
+    template <typename EdgeT> bool operator()(EdgeT const& a, EdgeT const& b) const
+    {
+        using Traits = EdgeTraits<EdgeT>;
+
+        if (Traits::source(a) != Traits::source(b))
+        {
+            return Traits::source(a) < Traits::source(b);
+        }
+        if (Traits::target(a) != Traits::target(b))
+        {
+            return Traits::target(a) < Traits::target(b);
+        }
+        return Traits::timestamp(a) < Traits::timestamp(b);
+    }
+};
+
+//! Orders edges of any edge type by source only.
+struct SourceLess
+{
+    template <typename EdgeT> bool operator()(EdgeT const& a, EdgeT const& b) const
+    {
+        return EdgeTraits<EdgeT>::source(a) < EdgeTraits<EdgeT>::source(b);
+    }
+};
+
+//! Orders edges of any edge type by timestamp only.
+struct TimestampLess
+{
+    template <typename EdgeT> bool operator()(EdgeT const& a, EdgeT const& b) const
+    {
+        return EdgeTraits<EdgeT>::timestamp(a) < EdgeTraits<EdgeT>::timestamp(b);
+    }
+};
+
 template <typename Edges, typename TStamps> struct TimestampedEdges
 {
     Edges edges;
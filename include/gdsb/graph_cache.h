@@ -0,0 +1,198 @@
+#pragma once
+
+//! This file contains an opt-in cache of text graph files: on the first read,
+//! the parsed edges are written as a GDSB binary graph into a cache directory.
+//! Later reads of the same file using the same parameters map the binary graph
+//! instead of parsing the text again. Cache files are keyed by the path, size
+//! and modification time of the text file, the GraphParameters and the
+//! maximum edge count, thus modified text files are parsed again.
+
+#include <gdsb/binary_codec.h>
+#include <gdsb/graph.h>
+#include <gdsb/graph_input.h>
+#include <gdsb/graph_io_parameters.h>
+#include <gdsb/graph_output.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace gdsb
+{
+
+//! Name of the environment variable holding the default cache directory, see
+//! read_graph_cached().
+constexpr char const* graph_cache_directory_variable = "GDSB_GRAPH_CACHE_DIR";
+
+//! Flags of the GraphParameters which change the parsed edges, part of the
+//! cache key.
+struct GraphCacheParameters
+{
+    FileType file_type = FileType::edge_list;
+    bool directed = false;
+    bool weighted = false;
+    bool dynamic = false;
+    bool loop = false;
+    uint64_t edge_count_max = std::numeric_limits<uint64_t>::max();
+};
+
+template <typename GraphParameters> GraphCacheParameters graph_cache_parameters(uint64_t const edge_count_max)
+{
+    GraphCacheParameters parameters;
+    parameters.file_type = GraphParameters::filetype();
+    parameters.directed = GraphParameters::is_directed();
+    parameters.weighted = GraphParameters::is_weighted();
+    parameters.dynamic = GraphParameters::is_dynamic();
+    parameters.loop = GraphParameters::loop();
+    parameters.edge_count_max = edge_count_max;
+    return parameters;
+}
+
+//! Returns the path of the cache file of the text graph at graph_path within
+//! cache_directory. Throws if the text graph does not exist.
+std::filesystem::path
+graph_cache_path(std::filesystem::path const& cache_directory, std::filesystem::path const& graph_path, GraphCacheParameters const& parameters);
+
+//! Returns the cache directory set by the environment variable
+//! graph_cache_directory_variable, an empty path if it is not set.
+std::filesystem::path default_graph_cache_directory();
+
+//! Returns a path next to cache_path which is unique to the calling process.
+std::filesystem::path temporary_graph_cache_path(std::filesystem::path const& cache_path);
+
+//! Writes the edges as binary graph to cache_path. The file is written under
+//! a temporary name first and renamed afterwards, thus concurrent readers
+//! either see a complete cache file or none.
+template <typename GraphParameters, typename Edges>
+void write_graph_cache(std::filesystem::path const& cache_path, Edges const& edges, uint64_t const vertex_count)
+{
+    std::filesystem::create_directories(cache_path.parent_path());
+
+    std::filesystem::path const temporary_path = temporary_graph_cache_path(cache_path);
+    write_graph<GraphParameters>(temporary_path, edges, vertex_count);
+    std::filesystem::rename(temporary_path, cache_path);
+}
+
+//! Edge type used to store cached graphs of the given GraphParameters. The 64
+//! bit edge types hold any parsed value, the binary graph stores narrow byte
+//! sizes anyways.
+template <typename GraphParameters>
+using GraphCacheEdge = std::conditional_t<
+    GraphParameters::is_dynamic(),
+    std::conditional_t<GraphParameters::is_weighted(), WeightedTimestampedEdge64, TimestampedEdge64>,
+    std::conditional_t<GraphParameters::is_weighted(), WeightedEdge64, Edge64>>;
+
+//! Calls emplace for every edge of a cached graph as read_graph() would. The
+//! edges are decoded block wise straight from the memory mapped cache file.
+//! Returns false without calling emplace if the cache file does not match the
+//! GraphParameters.
+template <typename GraphParameters, typename EmplaceF>
+bool read_graph_cache(std::filesystem::path const& cache_path, EmplaceF&& emplace, BinaryGraphHeader& header)
+{
+    using EdgeT = GraphCacheEdge<GraphParameters>;
+    using Traits = EdgeTraits<EdgeT>;
+
+    std::ifstream input(cache_path, std::ios::binary);
+    header = read_binary_graph_header(input);
+    if (header.weighted != Traits::is_weighted() || header.dynamic != Traits::is_dynamic() || header.encoding != EdgeEncoding::raw)
+    {
+        return false;
+    }
+
+    binary::EdgeLayout const layout = binary::edge_layout(header);
+    binary::check_edge_layout(layout);
+
+    MappedFile const file(cache_path);
+    uint64_t const edges_begin = sizeof(BinaryGraphHeaderIdentifier) + sizeof(BinaryGraphHeader);
+    if (edges_begin + header.edge_count * layout.edge_size_in_bytes() > file.size())
+    {
+        return false;
+    }
+
+    size_t const block_edge_count = size_t(1) << 16;
+    std::vector<EdgeT> block(std::min(size_t(header.edge_count), block_edge_count));
+    for (uint64_t begin = 0; begin < header.edge_count; begin += block_edge_count)
+    {
+        size_t const count = std::min(uint64_t(block_edge_count), header.edge_count - begin);
+        binary::decode_edges(file.data() + edges_begin + begin * layout.edge_size_in_bytes(), count, layout, block.data());
+        for (size_t i = 0; i < count; ++i)
+        {
+            EdgeT const& e = block[i];
+            emplace_directed<GraphParameters>(emplace, Traits::source(e), Traits::target(e), Traits::weight(e), Traits::timestamp(e));
+        }
+    }
+
+    return true;
+}
+
+//! Reads a text graph file as read_graph() does, using the binary cache within
+//! cache_directory if possible. An empty cache_directory defaults to
+//! default_graph_cache_directory(), if both are empty the cache is not used.
+//! On a cache miss the text file is parsed and the cache file is written.
+template <typename Vertex, typename EmplaceF, typename GraphParameters = GraphParameters<FileType::edge_list>, typename Timestamp = uint64_t>
+std::tuple<Vertex, uint64_t> read_graph_cached(std::string const& path,
+                                               EmplaceF&& emplace,
+                                               std::filesystem::path cache_directory = {},
+                                               uint64_t const edge_count_max = std::numeric_limits<uint64_t>::max())
+{
+    using EdgeT = GraphCacheEdge<GraphParameters>;
+    using Traits = EdgeTraits<EdgeT>;
+
+    if (cache_directory.empty())
+    {
+        cache_directory = default_graph_cache_directory();
+    }
+    if (cache_directory.empty())
+    {
+        auto forward = [&](auto const... values) { emplace(values...); };
+        return read_graph<Vertex, decltype(forward), GraphParameters, Timestamp>(path, std::move(forward), edge_count_max);
+    }
+
+    std::filesystem::path const cache_path =
+        graph_cache_path(cache_directory, path, graph_cache_parameters<GraphParameters>(edge_count_max));
+
+    if (std::filesystem::exists(cache_path))
+    {
+        BinaryGraphHeader header;
+        if (read_graph_cache<GraphParameters>(cache_path, emplace, header))
+        {
+            return { Vertex(header.vertex_count), header.edge_count };
+        }
+    }
+
+    std::vector<EdgeT> edges;
+    auto collect = [&](auto const... values)
+    {
+        // Only the vertex and timestamp arguments are converted, the weight
+        // may be any floating point value.
+        auto const arguments = std::forward_as_tuple(values...);
+        EdgeT e{};
+        Traits::source(e) = typename Traits::Vertex(std::get<0>(arguments));
+        Traits::target(e) = typename Traits::Vertex(std::get<1>(arguments));
+        if constexpr (GraphParameters::is_weighted())
+        {
+            Traits::set_weight(e, std::get<2>(arguments));
+        }
+        if constexpr (GraphParameters::is_dynamic())
+        {
+            Traits::set_timestamp(e, typename Traits::Timestamp(std::get<sizeof...(values) - 1>(arguments)));
+        }
+        edges.push_back(e);
+        emplace(values...);
+    };
+
+    auto const [vertex_count, edge_count] =
+        read_graph<Vertex, decltype(collect), GraphParameters, Timestamp>(path, std::move(collect), edge_count_max);
+    write_graph_cache<GraphParameters>(cache_path, edges, uint64_t(vertex_count));
+
+    return { vertex_count, edge_count };
+}
+
+} // namespace gdsb
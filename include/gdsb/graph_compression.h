@@ -0,0 +1,448 @@
+#pragma once
+
+//! This file contains the graph aware compression of binary edge data. Edges
+//! are split into chunks of a fixed edge count. Each chunk is encoded
+//! independently of all other chunks, thus chunks can be encoded and decoded
+//! in parallel. Within a chunk, sources are delta encoded to the previous
+//! source and targets are delta encoded to the previous target of the same
+//! source. Using data sorted by source, most deltas are small integers which
+//! are then stored using Stream VByte.
+//!
+//! For edges without such an order, e.g. temporal edge streams, chunks may
+//! instead hold the raw edge layout compressed by a general purpose block
+//! compressor (LZ4 or Zstandard). These block codecs are optional
+//! dependencies, see the CMake options GDSB_LZ4 and GDSB_ZSTD.
+//!
+//! The edge data of a file using a chunked encoding starts with the chunk
+//! directory followed by the encoded chunks:
+//! - uint64_t chunk edge count (all chunks but the last one hold that count)
+//! - uint64_t chunk count
+//! - uint64_t offsets[chunk count + 1] relative to the end of the directory
+
+#include <gdsb/binary_codec.h>
+#include <gdsb/graph.h>
+#include <gdsb/graph_io_parameters.h>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace gdsb
+{
+
+namespace stream_vbyte
+{
+
+//! Returns the maximum count of bytes needed to encode count integers.
+size_t max_encoded_size(size_t count);
+
+//! Encodes count integers into out which must provide at least
+//! max_encoded_size(count) bytes. Returns the count of bytes written.
+size_t encode(uint32_t const* values, size_t count, uint8_t* out);
+
+//! Decodes count integers from in. The decoder uses SIMD instructions if
+//! available, reading 16 bytes at once but never past in_end. Returns the
+//! count of bytes consumed. Throws if the input ends before count integers are
+//! decoded.
+size_t decode(uint8_t const* in, uint8_t const* in_end, size_t count, uint32_t* values);
+
+} // namespace stream_vbyte
+
+namespace block_codec
+{
+
+//! Returns true if encoding is a block codec GDSB has been built with.
+bool supported(EdgeEncoding encoding);
+
+//! Returns the maximum count of bytes needed to compress size bytes.
+size_t max_compressed_size(EdgeEncoding encoding, size_t size);
+
+//! Compresses [src, src + size) into dst providing capacity bytes. The
+//! compression level is only used by Zstandard. Returns the count of bytes
+//! written.
+size_t compress(EdgeEncoding encoding, uint8_t const* src, size_t size, uint8_t* dst, size_t capacity, int level);
+
+//! Decompresses [src, src + size) into dst which must hold exactly
+//! decompressed_size bytes afterwards, throws otherwise.
+void decompress(EdgeEncoding encoding, uint8_t const* src, size_t size, uint8_t* dst, size_t decompressed_size);
+
+} // namespace block_codec
+
+inline bool is_chunked(EdgeEncoding const encoding) { return encoding != EdgeEncoding::raw; }
+
+inline uint32_t zigzag_encode(int32_t const value) { return (uint32_t(value) << 1) ^ uint32_t(value >> 31); }
+
+inline int32_t zigzag_decode(uint32_t const value) { return int32_t(value >> 1) ^ -int32_t(value & 1u); }
+
+//! Delta between two values in the 32 bit modular arithmetic, thus the delta of
+//! any two 32 bit values can be represented and decoded again.
+inline uint32_t zigzag_delta(uint32_t const value, uint32_t const previous)
+{
+    return zigzag_encode(int32_t(value - previous));
+}
+
+inline uint32_t zigzag_undelta(uint32_t const delta, uint32_t const previous)
+{
+    return previous + uint32_t(zigzag_decode(delta));
+}
+
+struct EdgeChunkDirectory
+{
+    uint64_t chunk_edge_count = 0;
+    // Byte offsets of all chunks relative to the end of the directory, the last
+    // entry marks the end of the last chunk.
+    std::vector<uint64_t> offsets{ 0 };
+
+    uint64_t chunk_count() const { return offsets.size() - 1; }
+
+    uint64_t size_in_bytes() const { return sizeof(uint64_t) * (2 + offsets.size()); }
+
+    uint64_t chunk_size_in_bytes(uint64_t const chunk) const { return offsets[chunk + 1] - offsets[chunk]; }
+
+    uint64_t chunk_edge_offset(uint64_t const chunk) const { return chunk * chunk_edge_count; }
+
+    uint64_t edge_count(uint64_t const chunk, uint64_t const total_edge_count) const
+    {
+        return std::min(chunk_edge_count, total_edge_count - chunk_edge_offset(chunk));
+    }
+};
+
+void write_chunk_directory(std::ostream& output, EdgeChunkDirectory const& directory);
+
+EdgeChunkDirectory read_chunk_directory(std::istream& input);
+
+inline uint64_t chunk_count(uint64_t const edge_count, uint64_t const chunk_edge_count)
+{
+    return (edge_count + chunk_edge_count - 1) / chunk_edge_count;
+}
+
+template <typename T> uint32_t narrow_to_uint32(T const value)
+{
+    if (value > std::numeric_limits<uint32_t>::max())
+    {
+        throw std::out_of_range("Value " + std::to_string(value) + " exceeds the 32 bit range of Stream VByte.");
+    }
+
+    return static_cast<uint32_t>(value);
+}
+
+template <typename EdgeT> size_t max_stream_vbyte_chunk_size(size_t const count)
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    size_t size = 2 * stream_vbyte::max_encoded_size(count);
+    if constexpr (Traits::is_weighted())
+    {
+        size += count * sizeof(typename Traits::Weight);
+    }
+    if constexpr (Traits::is_dynamic())
+    {
+        size += stream_vbyte::max_encoded_size(count);
+    }
+
+    return size;
+}
+
+//! Encodes count edges into out using: Stream VByte encoded source deltas,
+//! Stream VByte encoded target deltas, raw weights if weighted and Stream
+//! VByte encoded timestamp deltas if dynamic.
+template <typename EdgeT>
+void encode_stream_vbyte_chunk(EdgeT const* const edges, size_t const count, std::vector<uint8_t>& out)
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    out.resize(max_stream_vbyte_chunk_size<EdgeT>(count));
+    uint8_t* position = out.data();
+    std::vector<uint32_t> values(count);
+
+    uint32_t previous_source = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t const source = narrow_to_uint32(Traits::source(edges[i]));
+        values[i] = zigzag_delta(source, previous_source);
+        previous_source = source;
+    }
+    position += stream_vbyte::encode(values.data(), count, position);
+
+    // The first target of a source is stored as is since the decoder can tell
+    // by the decoded sources where a new source begins.
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t const target = narrow_to_uint32(Traits::target(edges[i]));
+        bool const same_source = i > 0 && Traits::source(edges[i]) == Traits::source(edges[i - 1]);
+        values[i] = same_source ? zigzag_delta(target, uint32_t(Traits::target(edges[i - 1]))) : target;
+    }
+    position += stream_vbyte::encode(values.data(), count, position);
+
+    if constexpr (Traits::is_weighted())
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            typename Traits::Weight const weight = Traits::weight(edges[i]);
+            std::memcpy(position, &weight, sizeof(weight));
+            position += sizeof(weight);
+        }
+    }
+
+    if constexpr (Traits::is_dynamic())
+    {
+        // Time sorted edges result in small non negative deltas, unsorted ones
+        // are still encoded correctly using zigzag deltas.
+        uint32_t previous_timestamp = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t const timestamp = narrow_to_uint32(Traits::timestamp(edges[i]));
+            values[i] = zigzag_delta(timestamp, previous_timestamp);
+            previous_timestamp = timestamp;
+        }
+        position += stream_vbyte::encode(values.data(), count, position);
+    }
+
+    out.resize(position - out.data());
+}
+
+//! Decodes count edges encoded by encode_stream_vbyte_chunk() from [in, in_end).
+template <typename EdgeT>
+void decode_stream_vbyte_chunk(uint8_t const* in, uint8_t const* const in_end, size_t const count, EdgeT* const edges)
+{
+    using Traits = EdgeTraits<EdgeT>;
+    using Vertex_t = typename Traits::Vertex;
+
+    std::vector<uint32_t> values(count);
+
+    in += stream_vbyte::decode(in, in_end, count, values.data());
+    uint32_t previous_source = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        previous_source = zigzag_undelta(values[i], previous_source);
+        Traits::source(edges[i]) = Vertex_t(previous_source);
+    }
+
+    in += stream_vbyte::decode(in, in_end, count, values.data());
+    for (size_t i = 0; i < count; ++i)
+    {
+        bool const same_source = i > 0 && Traits::source(edges[i]) == Traits::source(edges[i - 1]);
+        uint32_t const target =
+            same_source ? zigzag_undelta(values[i], uint32_t(Traits::target(edges[i - 1]))) : values[i];
+        Traits::target(edges[i]) = Vertex_t(target);
+    }
+
+    if constexpr (Traits::is_weighted())
+    {
+        typename Traits::Weight weight;
+        if (in + count * sizeof(weight) > in_end)
+        {
+            throw std::runtime_error("Encoded edge chunk is truncated.");
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::memcpy(&weight, in, sizeof(weight));
+            Traits::set_weight(edges[i], weight);
+            in += sizeof(weight);
+        }
+    }
+
+    if constexpr (Traits::is_dynamic())
+    {
+        in += stream_vbyte::decode(in, in_end, count, values.data());
+        uint32_t previous_timestamp = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            previous_timestamp = zigzag_undelta(values[i], previous_timestamp);
+            Traits::set_timestamp(edges[i], typename Traits::Timestamp(previous_timestamp));
+        }
+    }
+}
+
+//! Encodes count edges into out using the chunked encoding. Block codecs
+//! compress the edges serialized using layout, see binary_codec.h.
+template <typename EdgeT>
+void encode_edge_chunk(EdgeEncoding const encoding,
+                       EdgeT const* const edges,
+                       size_t const count,
+                       std::vector<uint8_t>& out,
+                       binary::EdgeLayout const& layout = binary::native_edge_layout<EdgeT>(),
+                       int const level = 1)
+{
+    switch (encoding)
+    {
+    case EdgeEncoding::stream_vbyte:
+        encode_stream_vbyte_chunk(edges, count, out);
+        break;
+    case EdgeEncoding::lz4:
+    case EdgeEncoding::zstd:
+    {
+        std::vector<uint8_t> raw(count * layout.edge_size_in_bytes());
+        binary::encode_edges(edges, count, layout, raw.data());
+        out.resize(block_codec::max_compressed_size(encoding, raw.size()));
+        out.resize(block_codec::compress(encoding, raw.data(), raw.size(), out.data(), out.size(), level));
+        break;
+    }
+    default:
+        throw std::logic_error("Edge encoding is not a chunked encoding: " + std::to_string(int(encoding)));
+    }
+}
+
+//! Decodes count edges encoded by encode_edge_chunk() from [in, in_end).
+template <typename EdgeT>
+void decode_edge_chunk(EdgeEncoding const encoding,
+                       uint8_t const* const in,
+                       uint8_t const* const in_end,
+                       size_t const count,
+                       EdgeT* const edges,
+                       binary::EdgeLayout const& layout = binary::native_edge_layout<EdgeT>())
+{
+    switch (encoding)
+    {
+    case EdgeEncoding::stream_vbyte:
+        decode_stream_vbyte_chunk(in, in_end, count, edges);
+        break;
+    case EdgeEncoding::lz4:
+    case EdgeEncoding::zstd:
+    {
+        std::vector<uint8_t> raw(count * layout.edge_size_in_bytes());
+        block_codec::decompress(encoding, in, in_end - in, raw.data(), raw.size());
+        binary::decode_edges(raw.data(), count, layout, edges);
+        break;
+    }
+    default:
+        throw std::logic_error("Edge encoding is not a chunked encoding: " + std::to_string(int(encoding)));
+    }
+}
+
+//! Encodes all edges chunk wise in parallel, one byte vector per chunk.
+template <typename EdgeT>
+std::vector<std::vector<uint8_t>> encode_edge_chunks(EdgeEncoding const encoding,
+                                                     EdgeT const* const edges,
+                                                     uint64_t const edge_count,
+                                                     uint64_t const chunk_edge_count,
+                                                     binary::EdgeLayout const& layout = binary::native_edge_layout<EdgeT>(),
+                                                     int const level = 1)
+{
+    if (encoding != EdgeEncoding::stream_vbyte && !block_codec::supported(encoding))
+    {
+        throw std::logic_error("GDSB has not been built with support for edge encoding: " + std::to_string(int(encoding)));
+    }
+
+    if (chunk_edge_count == 0)
+    {
+        throw std::invalid_argument("Chunk edge count must be greater than zero.");
+    }
+
+    std::vector<std::vector<uint8_t>> chunks(chunk_count(edge_count, chunk_edge_count));
+    int64_t const chunks_size = static_cast<int64_t>(chunks.size());
+
+    // Exceptions must not escape the parallel region, thus we rethrow the
+    // (last) caught one afterwards.
+    std::exception_ptr error;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t c = 0; c < chunks_size; ++c)
+    {
+        try
+        {
+            uint64_t const begin = c * chunk_edge_count;
+            uint64_t const count = std::min(chunk_edge_count, edge_count - begin);
+            encode_edge_chunk(encoding, edges + begin, count, chunks[c], layout, level);
+        }
+        catch (...)
+        {
+#pragma omp critical
+            error = std::current_exception();
+        }
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    return chunks;
+}
+
+inline EdgeChunkDirectory make_chunk_directory(std::vector<std::vector<uint8_t>> const& chunks, uint64_t const chunk_edge_count)
+{
+    EdgeChunkDirectory directory;
+    directory.chunk_edge_count = chunk_edge_count;
+    directory.offsets.reserve(chunks.size() + 1);
+    for (std::vector<uint8_t> const& chunk : chunks)
+    {
+        directory.offsets.push_back(directory.offsets.back() + chunk.size());
+    }
+
+    return directory;
+}
+
+//! Reads and decodes all chunks of a chunk encoded edge section, input must be
+//! positioned at the chunk directory. One thread reads the chunks sequentially
+//! while the decoding of already read chunks runs in parallel as OpenMP tasks.
+//! Parameter edges must point to storage for header.edge_count edges.
+template <typename EdgeT> void read_edge_chunks(std::istream& input, BinaryGraphHeader const& header, EdgeT* const edges)
+{
+    if (header.encoding != EdgeEncoding::stream_vbyte && !block_codec::supported(header.encoding))
+    {
+        throw std::logic_error("GDSB has not been built with support for edge encoding: " +
+                               std::to_string(int(header.encoding)));
+    }
+
+    EdgeChunkDirectory const directory = read_chunk_directory(input);
+    if (directory.chunk_count() != chunk_count(header.edge_count, directory.chunk_edge_count))
+    {
+        throw std::runtime_error("Chunk directory does not match the edge count of the header.");
+    }
+
+    binary::EdgeLayout const layout = binary::edge_layout(header);
+    std::vector<std::vector<uint8_t>> buffers(directory.chunk_count());
+    bool read_ok = true;
+    std::exception_ptr error;
+
+#pragma omp parallel
+#pragma omp single
+    for (uint64_t c = 0; c < directory.chunk_count() && read_ok; ++c)
+    {
+        std::vector<uint8_t>& buffer = buffers[c];
+        buffer.resize(directory.chunk_size_in_bytes(c));
+        read_ok = bool(input.read(reinterpret_cast<char*>(buffer.data()), buffer.size()));
+
+        if (read_ok)
+        {
+#pragma omp task firstprivate(c) shared(buffers, directory, header, layout, error)
+            {
+                std::vector<uint8_t>& chunk = buffers[c];
+                try
+                {
+                    decode_edge_chunk(header.encoding, chunk.data(), chunk.data() + chunk.size(),
+                                      directory.edge_count(c, header.edge_count), edges + directory.chunk_edge_offset(c), layout);
+                }
+                catch (...)
+                {
+#pragma omp critical
+                    error = std::current_exception();
+                }
+                std::vector<uint8_t>().swap(chunk);
+            }
+        }
+    }
+
+    if (!read_ok)
+    {
+        throw std::runtime_error("Could not read all edge chunks from binary graph file.");
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace gdsb
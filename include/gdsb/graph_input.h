@@ -1,8 +1,11 @@
 #pragma once
 
 #include <gdsb/batcher.h>
+#include <gdsb/block_reader.h>
 #include <gdsb/graph.h>
+#include <gdsb/graph_compression.h>
 #include <gdsb/graph_io_parameters.h>
+#include <gdsb/graph_sections.h>
 
 #include <omp.h>
 
@@ -11,7 +14,10 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <optional>
 #include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 namespace gdsb
@@ -262,6 +268,28 @@ read_graph(std::string const& path, EmplaceF&& emplace, uint64_t const edge_coun
     return read_graph<Vertex, EmplaceF, GraphParameters, Timestamp>(graph_input, std::move(emplace), edge_count_max);
 }
 
+//! A read only memory mapping of a whole file, e.g. to access the edges of a
+//! binary graph without copying them into a buffer first. The mapping is
+//! released on destruction.
+class MappedFile
+{
+public:
+    explicit MappedFile(std::filesystem::path const& file_path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    uint8_t const* data() const { return static_cast<uint8_t const*>(m_data); }
+    size_t size() const { return m_size; }
+
+private:
+    void* m_data = nullptr;
+    size_t m_size = 0;
+};
+
 inline BinaryGraphHeader read_binary_graph_header(std::ifstream& input)
 {
     BinaryGraphHeaderIdentifier id;
@@ -271,6 +299,7 @@ inline BinaryGraphHeader read_binary_graph_header(std::ifstream& input)
 
     switch (id.version)
     {
+    case binary_graph_header_version_raw_only:
     case binary_graph_header_version:
     {
         if (!std::strcmp(id.identifier, "GDSB"))
@@ -281,6 +310,12 @@ inline BinaryGraphHeader read_binary_graph_header(std::ifstream& input)
         BinaryGraphHeader meta_data;
         input.read(reinterpret_cast<char*>(&meta_data), sizeof(BinaryGraphHeader));
 
+        if (id.version == binary_graph_header_version_raw_only)
+        {
+            meta_data.encoding = EdgeEncoding::raw;
+            meta_data.has_sections = false;
+        }
+
         return meta_data;
     }
     default:
@@ -291,6 +326,11 @@ inline BinaryGraphHeader read_binary_graph_header(std::ifstream& input)
 template <typename Header, typename ReadF>
 std::tuple<Vertex64, uint64_t> read_binary_graph(std::ifstream& input, Header const& header, ReadF&& read)
 {
+    if (header.encoding != EdgeEncoding::raw)
+    {
+        throw std::logic_error("Reading edge by edge requires raw encoded edges, use read_binary_edges().");
+    }
+
     bool continue_reading = true;
     uint64_t edge_count = header.edge_count;
 
@@ -312,6 +352,11 @@ std::tuple<Vertex64, uint64_t> read_binary_graph_partition(std::ifstream& input,
 {
     assert(partition_size > 0);
 
+    if (data.encoding != EdgeEncoding::raw)
+    {
+        throw std::logic_error("Reading edge by edge requires raw encoded edges, use read_binary_edges().");
+    }
+
     size_t const offset = batch_offset(data.edge_count, partition_id, partition_size);
     input.seekg(offset * edge_size_in_bytes, std::ios_base::cur);
 
@@ -325,6 +370,571 @@ std::tuple<Vertex64, uint64_t> read_binary_graph_partition(std::ifstream& input,
     return std::make_tuple(data.vertex_count, edge_count);
 }
 
+//! Reads the edges of the given vertex partition, e.g. determined using
+//! read_vertex_partitions(). Input must be positioned at the end of the
+//! header.
+template <typename ReadF>
+std::tuple<Vertex64, uint64_t> read_binary_graph_partition(std::ifstream& input,
+                                                           BinaryGraphHeader const& data,
+                                                           ReadF&& read,
+                                                           size_t edge_size_in_bytes,
+                                                           VertexPartition const& partition)
+{
+    if (data.encoding != EdgeEncoding::raw)
+    {
+        throw std::logic_error("Reading edge by edge requires raw encoded edges, use read_binary_edges().");
+    }
+
+    input.seekg(partition.edge_begin * edge_size_in_bytes, std::ios_base::cur);
+
+    bool continue_reading = true;
+    for (uint64_t e = 0; e < partition.edge_count() && input.is_open() && continue_reading; ++e)
+    {
+        continue_reading = read(input);
+    }
+
+    return std::make_tuple(data.vertex_count, partition.edge_count());
+}
+
+//! Returns the out-degree of every vertex [0, header.vertex_count) of a binary
+//! graph sorted by source. Uses the degrees section if the file has one,
+//! otherwise a first pass reads the sources of all (raw encoded) edges. Throws
+//! if the edges are not sorted by source. The position of input is restored
+//! afterwards.
+inline std::vector<Degree64> read_source_degrees(std::ifstream& input, BinaryGraphHeader const& header)
+{
+    std::optional<BinaryGraphStatistics> const statistics = read_binary_graph_statistics(input, header);
+    if (statistics && !statistics->sorted_by_source)
+    {
+        throw std::logic_error("Vertex partitions require binary graph edges sorted by source.");
+    }
+
+    std::vector<Degree64> degrees = read_binary_graph_degrees(input, header);
+    if (!degrees.empty())
+    {
+        degrees.resize(std::max(uint64_t(degrees.size()), header.vertex_count), 0u);
+        return degrees;
+    }
+
+    if (header.encoding != EdgeEncoding::raw)
+    {
+        throw std::logic_error("Counting source degrees requires raw encoded edges or a degrees section.");
+    }
+
+    std::streampos const position = input.tellg();
+    degrees.assign(header.vertex_count, 0u);
+
+    binary::EdgeLayout const layout = binary::edge_layout(header);
+    size_t const stride = layout.edge_size_in_bytes();
+    size_t const block_edge_count = size_t(1) << 16;
+    std::vector<uint8_t> block(std::min(header.edge_count, uint64_t(block_edge_count)) * stride);
+    std::vector<uint64_t> sources(block_edge_count);
+    uint64_t previous = 0;
+
+    for (uint64_t begin = 0; begin < header.edge_count; begin += block_edge_count)
+    {
+        size_t const count = std::min(uint64_t(block_edge_count), header.edge_count - begin);
+        if (!input.read(reinterpret_cast<char*>(block.data()), count * stride))
+        {
+            throw std::runtime_error("Could not read all edges from binary graph file.");
+        }
+
+        binary::decode_uint_field(layout.vertex_id_byte_size, block.data(), stride, count,
+                                  [&](size_t i, uint64_t source) { sources[i] = source; });
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (sources[i] < previous)
+            {
+                throw std::logic_error("Vertex partitions require binary graph edges sorted by source.");
+            }
+
+            if (sources[i] >= degrees.size())
+            {
+                degrees.resize(sources[i] + 1, 0u);
+            }
+
+            ++degrees[sources[i]];
+            previous = sources[i];
+        }
+    }
+
+    input.seekg(position);
+    return degrees;
+}
+
+//! Cuts a binary graph sorted by source into partition_count partitions on
+//! source vertex boundaries, balancing the sum of cost(vertex, degree), see
+//! vertex_partitions(). The position of input is restored afterwards.
+template <typename CostF>
+std::vector<VertexPartition>
+read_vertex_partitions(std::ifstream& input, BinaryGraphHeader const& header, uint32_t const partition_count, CostF&& cost)
+{
+    return vertex_partitions(read_source_degrees(input, header), partition_count, std::forward<CostF>(cost));
+}
+
+//! Cuts a binary graph sorted by source into partitions balancing the count of
+//! edges.
+inline std::vector<VertexPartition>
+read_vertex_partitions(std::ifstream& input, BinaryGraphHeader const& header, uint32_t const partition_count)
+{
+    return vertex_partitions(read_source_degrees(input, header), partition_count);
+}
+
+//! Throws if edges of type EdgeT can not be read from a binary graph using
+//! the given header. The byte sizes of the fields may differ from the edge
+//! type, values are checked to fit while decoding.
+template <typename EdgeT> void check_binary_edge_type(BinaryGraphHeader const& header)
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    if (header.weighted != Traits::is_weighted() || header.dynamic != Traits::is_dynamic())
+    {
+        throw std::logic_error("Edge type does not match the binary graph header.");
+    }
+
+    binary::check_edge_layout(binary::edge_layout(header));
+}
+
+//! Reads all edges following the header of a binary graph file, regardless of
+//! the edge encoding declared in the header. Input must be positioned at the
+//! end of the header, see read_binary_graph_header(). Chunk encoded edges are
+//! decoded in parallel.
+template <typename EdgeT> std::vector<EdgeT> read_binary_edges(std::ifstream& input, BinaryGraphHeader const& header)
+{
+    check_binary_edge_type<EdgeT>(header);
+
+    std::vector<EdgeT> edges(header.edge_count);
+
+    switch (header.encoding)
+    {
+    case EdgeEncoding::raw:
+    {
+        // Read blocks of edges and widen them from the layout of the file to
+        // the edge type.
+        binary::EdgeLayout const layout = binary::edge_layout(header);
+        size_t const block_edge_count = size_t(1) << 16;
+        std::vector<uint8_t> block(std::min(size_t(header.edge_count), block_edge_count) * layout.edge_size_in_bytes());
+        for (size_t begin = 0; begin < edges.size(); begin += block_edge_count)
+        {
+            size_t const count = std::min(block_edge_count, edges.size() - begin);
+            if (!input.read(reinterpret_cast<char*>(block.data()), count * layout.edge_size_in_bytes()))
+            {
+                throw std::runtime_error("Could not read all edges from binary graph file.");
+            }
+
+            binary::decode_edges(block.data(), count, layout, edges.data() + begin);
+        }
+        break;
+    }
+    case EdgeEncoding::stream_vbyte:
+    case EdgeEncoding::lz4:
+    case EdgeEncoding::zstd:
+        read_edge_chunks(input, header, edges.data());
+        break;
+    default:
+        throw std::logic_error("Binary graph edge encoding not supported: " + std::to_string(int(header.encoding)));
+    }
+
+    return edges;
+}
+
+//! Reads all edges of the binary graph file at file_path, of which input has
+//! already read the header, thus input is positioned at the end of the header.
+//! Raw edges are read by a BlockReader, thus using io_uring if available, and
+//! decoded by the OpenMP tasks processing the completed blocks while further
+//! reads are in flight. Chunk encoded edges are read from input as by
+//! read_binary_edges().
+template <typename EdgeT>
+std::vector<EdgeT> read_binary_edges(std::filesystem::path const& file_path,
+                                     std::ifstream& input,
+                                     BinaryGraphHeader const& header,
+                                     BlockReaderOptions const& options = BlockReaderOptions{})
+{
+    if (header.encoding != EdgeEncoding::raw)
+    {
+        return read_binary_edges<EdgeT>(input, header);
+    }
+
+    check_binary_edge_type<EdgeT>(header);
+
+    binary::EdgeLayout const layout = binary::edge_layout(header);
+    size_t const edge_size = layout.edge_size_in_bytes();
+    uint64_t const edges_begin = sizeof(BinaryGraphHeaderIdentifier) + sizeof(BinaryGraphHeader);
+    std::vector<EdgeT> edges(header.edge_count);
+
+    BlockReader reader(file_path, options);
+    reader.read(edges_begin, edges_begin + header.edge_count * edge_size, edge_size,
+                [&](uint64_t const offset, uint8_t const* const data, size_t const size)
+                { binary::decode_edges(data, size / edge_size, layout, edges.data() + (offset - edges_begin) / edge_size); });
+
+    return edges;
+}
+
+//! Reads the header and all edges of the binary graph file at file_path, see
+//! above.
+template <typename EdgeT>
+std::vector<EdgeT> read_binary_edges(std::filesystem::path const& file_path,
+                                     BinaryGraphHeader& header,
+                                     BlockReaderOptions const& options = BlockReaderOptions{})
+{
+    std::ifstream input(file_path, std::ios::binary);
+    if (!input)
+    {
+        throw std::runtime_error("Could not open binary graph file: " + file_path.string());
+    }
+
+    header = read_binary_graph_header(input);
+    return read_binary_edges<EdgeT>(file_path, input, header, options);
+}
+
+//! Reads and decodes the chunk c of chunk encoded edges into edges, bytes holds
+//! the encoded chunk. Parameter chunks_begin is the position of input
+//! following the chunk directory.
+template <typename EdgeT>
+void read_edge_chunk(std::ifstream& input,
+                     BinaryGraphHeader const& header,
+                     EdgeChunkDirectory const& directory,
+                     std::streampos const chunks_begin,
+                     uint64_t const c,
+                     std::vector<uint8_t>& bytes,
+                     std::vector<EdgeT>& edges)
+{
+    bytes.resize(directory.chunk_size_in_bytes(c));
+    input.seekg(chunks_begin + std::streamoff(directory.offsets[c]));
+    if (!input.read(reinterpret_cast<char*>(bytes.data()), bytes.size()))
+    {
+        throw std::runtime_error("Could not read edge chunk from binary graph file.");
+    }
+
+    edges.resize(directory.edge_count(c, header.edge_count));
+    decode_edge_chunk(header.encoding, bytes.data(), bytes.data() + bytes.size(), edges.size(), edges.data(),
+                      binary::edge_layout(header));
+}
+
+//! Reads the edges [begin, end) of a binary graph regardless of the edge
+//! encoding. Chunk encoded edges are decoded for the overlapping chunks only.
+//! Input must be positioned at the end of the header, the position is
+//! restored afterwards.
+template <typename EdgeT>
+std::vector<EdgeT> read_binary_edge_range(std::ifstream& input, BinaryGraphHeader const& header, uint64_t const begin, uint64_t const end)
+{
+    check_binary_edge_type<EdgeT>(header);
+
+    if (begin > end || end > header.edge_count)
+    {
+        throw std::out_of_range("Edge range exceeds the edge count of the binary graph.");
+    }
+
+    std::streampos const edges_begin = input.tellg();
+    std::vector<EdgeT> edges(end - begin);
+    binary::EdgeLayout const layout = binary::edge_layout(header);
+
+    switch (header.encoding)
+    {
+    case EdgeEncoding::raw:
+    {
+        std::vector<uint8_t> bytes(edges.size() * layout.edge_size_in_bytes());
+        input.seekg(edges_begin + std::streamoff(begin * layout.edge_size_in_bytes()));
+        if (!input.read(reinterpret_cast<char*>(bytes.data()), bytes.size()))
+        {
+            throw std::runtime_error("Could not read edge range from binary graph file.");
+        }
+
+        binary::decode_edges(bytes.data(), edges.size(), layout, edges.data());
+        break;
+    }
+    case EdgeEncoding::stream_vbyte:
+    case EdgeEncoding::lz4:
+    case EdgeEncoding::zstd:
+    {
+        if (edges.empty())
+        {
+            break;
+        }
+
+        EdgeChunkDirectory const directory = read_chunk_directory(input);
+        std::streampos const chunks_begin = input.tellg();
+        std::vector<uint8_t> chunk;
+        std::vector<EdgeT> chunk_edges;
+
+        for (uint64_t c = begin / directory.chunk_edge_count; c <= (end - 1) / directory.chunk_edge_count; ++c)
+        {
+            read_edge_chunk(input, header, directory, chunks_begin, c, chunk, chunk_edges);
+
+            uint64_t const chunk_begin = directory.chunk_edge_offset(c);
+            uint64_t const copy_begin = std::max(begin, chunk_begin);
+            uint64_t const copy_end = std::min(end, chunk_begin + chunk_edges.size());
+            std::copy(chunk_edges.begin() + (copy_begin - chunk_begin), chunk_edges.begin() + (copy_end - chunk_begin),
+                      edges.begin() + (copy_begin - begin));
+        }
+        break;
+    }
+    default:
+        throw std::logic_error("Binary graph edge encoding not supported: " + std::to_string(int(header.encoding)));
+    }
+
+    input.clear();
+    input.seekg(edges_begin);
+    return edges;
+}
+
+//! Returns the offset of the first edge within [lo, hi) of a binary graph
+//! with key(edge) not less than value, where key(edge) must not decrease
+//! along the edges. Single edges are probed until the remaining range is small
+//! enough to be read at once. For chunk encoded edges, the first edges of the
+//! chunks are probed instead, followed by a search within a single decoded
+//! chunk. Input must be positioned at the end of the header, the position is
+//! restored afterwards.
+template <typename EdgeT, typename KeyF>
+uint64_t edge_lower_bound(std::ifstream& input, BinaryGraphHeader const& header, uint64_t lo, uint64_t hi, KeyF&& key, uint64_t const value)
+{
+    auto const less = [&](EdgeT const& e, uint64_t const v) { return uint64_t(key(e)) < v; };
+
+    if (is_chunked(header.encoding) && lo < hi)
+    {
+        check_binary_edge_type<EdgeT>(header);
+        if (hi > header.edge_count)
+        {
+            throw std::out_of_range("Edge range exceeds the edge count of the binary graph.");
+        }
+
+        std::streampos const edges_begin = input.tellg();
+        EdgeChunkDirectory const directory = read_chunk_directory(input);
+        std::streampos const chunks_begin = input.tellg();
+        std::vector<uint8_t> bytes;
+        std::vector<EdgeT> chunk;
+        uint64_t decoded = directory.chunk_count();
+        auto const decode = [&](uint64_t const c)
+        {
+            if (c != decoded)
+            {
+                read_edge_chunk(input, header, directory, chunks_begin, c, bytes, chunk);
+                decoded = c;
+            }
+        };
+
+        // Finds the last chunk overlapping [lo, hi) whose first edge is less
+        // than value, or the first overlapping chunk if there is none.
+        uint64_t first = lo / directory.chunk_edge_count;
+        uint64_t last = (hi - 1) / directory.chunk_edge_count;
+        while (first < last)
+        {
+            uint64_t const mid = first + (last - first + 1) / 2;
+            decode(mid);
+            if (less(chunk.front(), value))
+            {
+                first = mid;
+            }
+            else
+            {
+                last = mid - 1;
+            }
+        }
+
+        decode(first);
+        uint64_t const chunk_begin = directory.chunk_edge_offset(first);
+        auto const it = std::lower_bound(chunk.begin() + (std::max(lo, chunk_begin) - chunk_begin),
+                                         chunk.begin() + (std::min(hi, chunk_begin + chunk.size()) - chunk_begin),
+                                         value, less);
+
+        input.clear();
+        input.seekg(edges_begin);
+        return chunk_begin + std::distance(chunk.begin(), it);
+    }
+
+    uint64_t constexpr probe_range = uint64_t(1) << 12;
+    while (hi - lo > probe_range)
+    {
+        uint64_t const mid = lo + (hi - lo) / 2;
+        EdgeT const e = read_binary_edge_range<EdgeT>(input, header, mid, mid + 1).front();
+        if (uint64_t(key(e)) < value)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    std::vector<EdgeT> const edges = read_binary_edge_range<EdgeT>(input, header, lo, hi);
+    auto const it = std::lower_bound(edges.begin(), edges.end(), value, less);
+    return lo + std::distance(edges.begin(), it);
+}
+
+//! Returns the offset of the first edge with a timestamp not less than t of a
+//! binary graph sorted by timestamp. The timestamp index, if given, limits the
+//! search to the edges between two samples, see edge_lower_bound().
+template <typename EdgeT>
+uint64_t timestamp_lower_bound(std::ifstream& input, BinaryGraphHeader const& header, TimestampIndex const* const index, uint64_t const t)
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    uint64_t lo = 0;
+    uint64_t hi = header.edge_count;
+
+    if (index && index->stride > 0)
+    {
+        uint64_t const sample = std::distance(
+            index->timestamps.begin(), std::lower_bound(index->timestamps.begin(), index->timestamps.end(), t));
+        hi = std::min(hi, sample * index->stride);
+        lo = sample > 0 ? std::min(hi, (sample - 1) * index->stride + 1) : 0;
+    }
+
+    return edge_lower_bound<EdgeT>(
+        input, header, lo, hi, [](EdgeT const& e) { return Traits::timestamp(e); }, t);
+}
+
+template <typename EdgeT> void check_sorted_by_timestamp(std::ifstream& input, BinaryGraphHeader const& header)
+{
+    if (!EdgeTraits<EdgeT>::is_dynamic() || !header.dynamic)
+    {
+        throw std::logic_error("Time windows require a dynamic binary graph and edge type.");
+    }
+
+    std::optional<BinaryGraphStatistics> const statistics = read_binary_graph_statistics(input, header);
+    if (statistics && !statistics->sorted_by_timestamp)
+    {
+        throw std::logic_error("Time windows require binary graph edges sorted by timestamp.");
+    }
+}
+
+//! Reads the edges with timestamps within [t0, t1) of a binary graph sorted by
+//! timestamp, seeking to the window using the timestamp index if the file has
+//! one. Files without statistics are expected to be sorted by timestamp.
+//! Input must be positioned at the end of the header, the position is
+//! restored afterwards.
+template <typename EdgeT>
+std::vector<EdgeT> read_binary_graph_window(std::ifstream& input, BinaryGraphHeader const& header, uint64_t const t0, uint64_t const t1)
+{
+    check_sorted_by_timestamp<EdgeT>(input, header);
+    if (t1 <= t0)
+    {
+        return {};
+    }
+
+    std::optional<TimestampIndex> const index = read_timestamp_index(input, header);
+    TimestampIndex const* const index_ptr = index ? &*index : nullptr;
+    uint64_t const begin = timestamp_lower_bound<EdgeT>(input, header, index_ptr, t0);
+    uint64_t const end = timestamp_lower_bound<EdgeT>(input, header, index_ptr, t1);
+
+    return read_binary_edge_range<EdgeT>(input, header, begin, std::max(begin, end));
+}
+
+//! Cuts a binary graph sorted by timestamp into partition_count partitions of
+//! about equal edge count. Edges sharing a timestamp belong to the same
+//! partition, thus partitions may be empty. Read the edges of a partition
+//! using read_binary_edge_range(). The position of input is restored
+//! afterwards.
+template <typename EdgeT>
+std::vector<TimePartition> read_time_partitions(std::ifstream& input, BinaryGraphHeader const& header, uint32_t const partition_count)
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    check_sorted_by_timestamp<EdgeT>(input, header);
+    if (partition_count == 0)
+    {
+        throw std::invalid_argument("Partition count must be greater than zero.");
+    }
+
+    std::vector<TimePartition> partitions(partition_count);
+    if (header.edge_count == 0)
+    {
+        return partitions;
+    }
+
+    std::optional<TimestampIndex> const index = read_timestamp_index(input, header);
+    TimestampIndex const* const index_ptr = index ? &*index : nullptr;
+
+    uint64_t const last = header.edge_count - 1;
+    partitions.front().timestamp_begin = Traits::timestamp(read_binary_edge_range<EdgeT>(input, header, 0, 1).front());
+    partitions.back().timestamp_end = Traits::timestamp(read_binary_edge_range<EdgeT>(input, header, last, last + 1).front()) + 1;
+    partitions.back().edge_end = header.edge_count;
+
+    for (uint32_t p = 1; p < partition_count; ++p)
+    {
+        uint64_t const position = batch_offset(header.edge_count, p, partition_count);
+        uint64_t const t = Traits::timestamp(read_binary_edge_range<EdgeT>(input, header, position, position + 1).front());
+        uint64_t const cut = std::max(partitions[p - 1].edge_begin, timestamp_lower_bound<EdgeT>(input, header, index_ptr, t));
+
+        partitions[p - 1].timestamp_end = std::max(partitions[p - 1].timestamp_begin, t);
+        partitions[p - 1].edge_end = cut;
+        partitions[p].timestamp_begin = partitions[p - 1].timestamp_end;
+        partitions[p].edge_begin = cut;
+    }
+
+    return partitions;
+}
+
+//! Returns true if the vertex IDs or timestamps of a binary graph do not fit
+//! the 32 bit edge types, see visit_binary_edges().
+inline bool requires_wide_edges(BinaryGraphHeader const& header)
+{
+    return header.vertex_id_byte_size > sizeof(Vertex32) || header.timestamp_byte_size > sizeof(Timestamp32) ||
+        header.vertex_count > uint64_t(std::numeric_limits<Vertex32>::max());
+}
+
+//! Calls f(EdgeT{}) using the edge type matching the header: one of the 32
+//! bit edge types (Edge32, WeightedEdge32, ...), or of the 64 bit edge types if
+//! requires_wide_edges(). Returns the result of f, which must be the same for
+//! all edge types.
+template <typename F> decltype(auto) dispatch_edge_type(BinaryGraphHeader const& header, F&& f)
+{
+    bool const wide = requires_wide_edges(header);
+    if (header.weighted && header.dynamic)
+    {
+        return wide ? f(WeightedTimestampedEdge64{}) : f(WeightedTimestampedEdge32{});
+    }
+    if (header.dynamic)
+    {
+        return wide ? f(TimestampedEdge64{}) : f(TimestampedEdge32{});
+    }
+    if (header.weighted)
+    {
+        return wide ? f(WeightedEdge64{}) : f(WeightedEdge32{});
+    }
+
+    return wide ? f(Edge64{}) : f(Edge32{});
+}
+
+//! Reads all edges of a binary graph using the edge type matching the header,
+//! see dispatch_edge_type(), and calls visitor(header, std::vector<EdgeT>&&
+//! edges) once. Thus, the visitor is instantiated for every edge type while
+//! reading the edges does not branch on the header per edge. Input must be
+//! positioned at the end of the header. Returns the result of the visitor,
+//! which must be the same for all edge types.
+template <typename Visitor> decltype(auto) visit_binary_edges(std::ifstream& input, BinaryGraphHeader const& header, Visitor&& visitor)
+{
+    return dispatch_edge_type(header,
+                              [&](auto const edge) -> decltype(auto)
+                              {
+                                  using EdgeT = std::remove_const_t<decltype(edge)>;
+                                  return std::forward<Visitor>(visitor)(header, read_binary_edges<EdgeT>(input, header));
+                              });
+}
+
+//! Reads the binary graph file at file_path using read_binary_edges() of the
+//! file path and visits its edges, see visit_binary_edges().
+template <typename Visitor>
+decltype(auto) visit_binary_graph(std::filesystem::path const& file_path, Visitor&& visitor, BlockReaderOptions const& options = BlockReaderOptions{})
+{
+    std::ifstream input(file_path, std::ios::binary);
+    if (!input)
+    {
+        throw std::runtime_error("Could not open binary graph file: " + file_path.string());
+    }
+
+    BinaryGraphHeader const header = read_binary_graph_header(input);
+    return dispatch_edge_type(header,
+                              [&](auto const edge) -> decltype(auto)
+                              {
+                                  using EdgeT = std::remove_const_t<decltype(edge)>;
+                                  std::vector<EdgeT> edges = read_binary_edges<EdgeT>(file_path, input, header, options);
+                                  return std::forward<Visitor>(visitor)(header, std::move(edges));
+                              });
+}
+
 namespace binary
 {
 
@@ -336,6 +946,24 @@ void read(std::ifstream&, gdsb::TimestampedEdge32&);
 
 void read(std::ifstream&, gdsb::WeightedTimestampedEdge32&);
 
+void read(std::ifstream&, gdsb::Edge64&);
+
+void read(std::ifstream&, gdsb::WeightedEdge64&);
+
+void read(std::ifstream&, gdsb::TimestampedEdge64&);
+
+void read(std::ifstream&, gdsb::WeightedTimestampedEdge64&);
+
+//! Reads one edge stored using the given layout, e.g. the layout declared by
+//! the binary graph header, see binary::edge_layout().
+template <typename EdgeT> void read(std::istream& input, EdgeLayout const& layout, EdgeT& e)
+{
+    // Two 8 byte vertex IDs, an 8 byte weight and an 8 byte timestamp at most.
+    uint8_t bytes[32];
+    input.read(reinterpret_cast<char*>(bytes), layout.edge_size_in_bytes());
+    decode_edges(bytes, 1, layout, &e);
+}
+
 } // namespace binary
 
 template <typename Vertex, typename Label, typename F> void read_labels(std::istream& ins, F&& emplace)
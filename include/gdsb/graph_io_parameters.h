@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 namespace gdsb
 {
 template <bool value> class GraphParameter
@@ -124,7 +126,28 @@ using BinaryUndirectedWeightedDynamic = GraphParameters<FileType::binary, Undire
 using BinaryUndirectedUnweightedStatic = GraphParameters<FileType::binary, Undirected, Unweighted, NoLoop, Static>;
 using BinaryUndirectedUnweightedDynamic = GraphParameters<FileType::binary, Undirected, Unweighted, NoLoop, Dynamic>;
 
-uint8_t constexpr binary_graph_header_version = 3u;
+uint8_t constexpr binary_graph_header_version = 4u;
+
+//! Version 3 files share the header layout of version 4. The bytes now holding
+//! the edge encoding and the sections flag were padding, thus they always store
+//! raw edges and no sections.
+uint8_t constexpr binary_graph_header_version_raw_only = 3u;
+
+//! Encoding of the edges following the binary graph header.
+//! - raw: edges are stored field by field (source, target, [weight],
+//!   [timestamp]) using the byte sizes declared in the header.
+//! - stream_vbyte: edges are split into chunks which are listed in a chunk
+//!   directory. Within a chunk, sources and targets are delta encoded and all
+//!   integers are stored using Stream VByte, see graph_compression.h.
+//! - lz4, zstd: edges are split into chunks as above, each chunk holds the raw
+//!   edges compressed by the respective block compressor.
+enum class EdgeEncoding : uint8_t
+{
+    raw = 0,
+    stream_vbyte = 1,
+    lz4 = 2,
+    zstd = 3
+};
 
 struct alignas(8) BinaryGraphHeaderIdentifier
 {
@@ -142,6 +165,11 @@ struct alignas(8) BinaryGraphHeader
     bool directed = false;
     bool weighted = false;
     bool dynamic = false;
+    EdgeEncoding encoding = EdgeEncoding::raw;
+    // Sections (e.g. graph statistics) follow the edges, see graph_sections.h.
+    bool has_sections = false;
 };
 
+static_assert(sizeof(BinaryGraphHeader) == 24u, "The binary graph header layout must not change.");
+
 } // namespace gdsb
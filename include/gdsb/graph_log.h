@@ -0,0 +1,415 @@
+#pragma once
+
+//! This file contains an appendable, log structured variant of the binary
+//! graph format for evolving graphs. A graph log is a directory holding an
+//! immutable base graph (a regular GDSB binary graph file) and delta segments
+//! appended afterwards:
+//! - base_<sequence>.bin: all edges of the segments up to and including
+//!   sequence, created by compaction (sequence 0 if it was written directly)
+//! - segment_<sequence>.bin: a segment header, the edges using the layout
+//!   declared by the header, and one EdgeOp per edge
+//!
+//! Appending a segment writes the new edges only. Readers present the latest
+//! base followed by all younger segments as one logical stream of edge
+//! operations. Compaction merges them into a new base in the background.
+//!
+//! Concurrent appends, reads and compactions are safe among users of the same
+//! GraphLog object. Readers and compaction only consider segments up to the
+//! highest sequence of which all lower sequences are completely appended, thus
+//! a segment still being written never gets skipped.
+
+#include <gdsb/binary_codec.h>
+#include <gdsb/graph.h>
+#include <gdsb/graph_input.h>
+#include <gdsb/graph_io_parameters.h>
+#include <gdsb/graph_output.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace gdsb
+{
+
+enum class EdgeOp : uint8_t
+{
+    insert = 0,
+    remove = 1
+};
+
+struct alignas(8) SegmentHeader
+{
+    char identifier[4] = { 'G', 'D', 'S', 'S' };
+    uint8_t version = 1u;
+    uint8_t vertex_id_byte_size = 4u;
+    uint8_t weight_byte_size = 4u;
+    uint8_t timestamp_byte_size = 4u;
+    uint64_t sequence = 0;
+    uint64_t edge_count = 0;
+    // Timestamp range [min_timestamp, max_timestamp] of the segment's edges,
+    // e.g. to skip segments outside of a time window.
+    uint64_t min_timestamp = 0;
+    uint64_t max_timestamp = 0;
+    bool weighted = false;
+    bool dynamic = false;
+};
+
+static_assert(sizeof(SegmentHeader) == 48u, "The segment header layout must not change.");
+
+struct SegmentFile
+{
+    std::filesystem::path path;
+    SegmentHeader header;
+};
+
+//! Returns the segments of the graph log directory with a sequence greater
+//! than after and not greater than until, ordered by sequence.
+std::vector<SegmentFile> list_segments(std::filesystem::path const& directory,
+                                       uint64_t after = 0,
+                                       uint64_t until = std::numeric_limits<uint64_t>::max());
+
+//! Returns the path and sequence of the latest base of the graph log
+//! directory, an empty path if there is none.
+std::pair<std::filesystem::path, uint64_t> latest_base(std::filesystem::path const& directory);
+
+std::filesystem::path segment_path(std::filesystem::path const& directory, uint64_t sequence);
+
+std::filesystem::path base_path(std::filesystem::path const& directory, uint64_t sequence);
+
+SegmentHeader read_segment_header(std::istream& input);
+
+//! Reads the edges and operations of a segment, calling f(edge, op) for each.
+template <typename EdgeT, typename F> void read_segment(SegmentFile const& segment, F&& f)
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    std::ifstream input(segment.path, std::ios::binary);
+    SegmentHeader const header = read_segment_header(input);
+    if (header.weighted != Traits::is_weighted() || header.dynamic != Traits::is_dynamic())
+    {
+        throw std::logic_error("Edge type does not match the segment header: " + segment.path.string());
+    }
+
+    binary::EdgeLayout layout;
+    layout.vertex_id_byte_size = header.vertex_id_byte_size;
+    layout.weight_byte_size = header.weight_byte_size;
+    layout.timestamp_byte_size = header.timestamp_byte_size;
+    layout.weighted = header.weighted;
+    layout.dynamic = header.dynamic;
+    binary::check_edge_layout(layout);
+
+    std::vector<uint8_t> bytes(header.edge_count * layout.edge_size_in_bytes());
+    std::vector<EdgeOp> ops(header.edge_count);
+    input.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+    input.read(reinterpret_cast<char*>(ops.data()), ops.size() * sizeof(EdgeOp));
+    if (!input)
+    {
+        throw std::runtime_error("Could not read segment: " + segment.path.string());
+    }
+
+    std::vector<EdgeT> edges(header.edge_count);
+    binary::decode_edges(bytes.data(), edges.size(), layout, edges.data());
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        f(edges[i], ops[i]);
+    }
+}
+
+//! An appendable graph stored in a graph log directory, see above. Appends and
+//! reads may run concurrently to a background compaction.
+template <typename GraphParameters, typename EdgeT> class GraphLog
+{
+public:
+    using Edge = EdgeT;
+    using Traits = EdgeTraits<EdgeT>;
+
+    explicit GraphLog(std::filesystem::path directory)
+        : m_directory(std::move(directory))
+    {
+        std::filesystem::create_directories(m_directory);
+
+        std::vector<SegmentFile> const segments = list_segments(m_directory);
+        uint64_t const last_sequence = segments.empty() ? 0 : segments.back().header.sequence;
+        m_next_sequence = std::max(latest_base(m_directory).second, last_sequence) + 1;
+        m_completed_sequence = m_next_sequence - 1;
+    }
+
+    //! Appends a segment holding the given edges and operations, all edges are
+    //! inserted if ops is empty. Returns the sequence of the segment.
+    uint64_t append(std::vector<EdgeT> const& edges, std::vector<EdgeOp> const& ops = {})
+    {
+        if (!ops.empty() && ops.size() != edges.size())
+        {
+            throw std::invalid_argument("Count of edge operations must match the count of edges.");
+        }
+
+        uint64_t sequence = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            sequence = m_next_sequence++;
+        }
+
+        // Sequences complete in any order, a failed append leaves a gap which
+        // must not hold back readers and compaction either.
+        try
+        {
+            write_segment(sequence, edges, ops);
+        }
+        catch (...)
+        {
+            complete(sequence);
+            throw;
+        }
+        complete(sequence);
+
+        return sequence;
+    }
+
+    //! Calls f(edge, op) for all edges of the latest base (as inserts) and of
+    //! all younger segments, in order.
+    template <typename F> void for_each(F&& f) const
+    {
+        std::shared_lock<std::shared_mutex> lock(m_files_mutex);
+        Snapshot const files = snapshot();
+        read_base(files.base, f);
+        for (SegmentFile const& segment : files.segments)
+        {
+            read_segment<EdgeT>(segment, f);
+        }
+    }
+
+    //! Returns the current edges: inserted edges in order of insertion, where
+    //! a remove operation removes the latest inserted edge with equal source,
+    //! target, and timestamp (if dynamic).
+    std::vector<EdgeT> edges() const
+    {
+        std::shared_lock<std::shared_mutex> lock(m_files_mutex);
+        return materialize(snapshot());
+    }
+
+    //! Merges the latest base and all completely appended segments existing at
+    //! the time of the call into a new base on a background thread. Appends and
+    //! reads remain possible meanwhile, merged segments are deleted afterwards.
+    std::future<void> compact_async(uint64_t const vertex_count = 0)
+    {
+        return std::async(std::launch::async, [this, vertex_count]() { compact(vertex_count); });
+    }
+
+    //! Merges the latest base and all segments into a new base, see
+    //! compact_async().
+    void compact(uint64_t vertex_count = 0)
+    {
+        std::lock_guard<std::mutex> lock(m_compaction_mutex);
+
+        // Only compaction removes files, thus the snapshot stays valid without
+        // holding the files lock while merging.
+        Snapshot const files = snapshot();
+        if (files.segments.empty())
+        {
+            return;
+        }
+
+        std::vector<EdgeT> const merged = materialize(files);
+        vertex_count = std::max(vertex_count, uint64_t(merged.empty() ? 0 : gdsb::vertex_count(merged)));
+
+        uint64_t const sequence = files.segments.back().header.sequence;
+        std::filesystem::path const path = base_path(m_directory, sequence);
+        std::filesystem::path temporary_path = path;
+        temporary_path += ".tmp";
+        write_graph<GraphParameters>(temporary_path, merged, vertex_count);
+
+        // Readers hold the files lock while reading, thus no reader sees the
+        // new base next to merged segments or opens a removed file.
+        std::unique_lock<std::shared_mutex> files_lock(m_files_mutex);
+        std::filesystem::rename(temporary_path, path);
+        if (!files.base.empty())
+        {
+            std::filesystem::remove(files.base);
+        }
+        for (SegmentFile const& segment : files.segments)
+        {
+            std::filesystem::remove(segment.path);
+        }
+    }
+
+    std::filesystem::path const& directory() const { return m_directory; }
+
+private:
+    struct Snapshot
+    {
+        std::filesystem::path base;
+        std::vector<SegmentFile> segments;
+    };
+
+    struct EdgeKey
+    {
+        uint64_t source;
+        uint64_t target;
+        uint64_t timestamp;
+
+        bool operator==(EdgeKey const& other) const
+        {
+            return source == other.source && target == other.target && timestamp == other.timestamp;
+        }
+    };
+
+    struct EdgeKeyHash
+    {
+        size_t operator()(EdgeKey const& key) const
+        {
+            size_t hash = std::hash<uint64_t>{}(key.source);
+            hash ^= std::hash<uint64_t>{}(key.target) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+            hash ^= std::hash<uint64_t>{}(key.timestamp) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+            return hash;
+        }
+    };
+
+    void write_segment(uint64_t const sequence, std::vector<EdgeT> const& edges, std::vector<EdgeOp> const& ops)
+    {
+        binary::EdgeLayout const layout = binary::narrowest_edge_layout(edges.data(), edges.size(), 0);
+
+        SegmentHeader header;
+        header.vertex_id_byte_size = layout.vertex_id_byte_size;
+        header.weight_byte_size = layout.weight_byte_size;
+        header.timestamp_byte_size = layout.timestamp_byte_size;
+        header.sequence = sequence;
+        header.edge_count = edges.size();
+        header.weighted = layout.weighted;
+        header.dynamic = layout.dynamic;
+        if (!edges.empty())
+        {
+            auto const [min_it, max_it] = std::minmax_element(edges.begin(), edges.end(), [](EdgeT const& a, EdgeT const& b)
+                                                              { return Traits::timestamp(a) < Traits::timestamp(b); });
+            header.min_timestamp = Traits::timestamp(*min_it);
+            header.max_timestamp = Traits::timestamp(*max_it);
+        }
+
+        std::vector<uint8_t> bytes(edges.size() * layout.edge_size_in_bytes());
+        binary::encode_edges(edges.data(), edges.size(), layout, bytes.data());
+        std::vector<EdgeOp> const all_ops = ops.empty() ? std::vector<EdgeOp>(edges.size(), EdgeOp::insert) : ops;
+
+        // Readers never see partially written segments since the segment is
+        // renamed once complete.
+        std::filesystem::path const path = segment_path(m_directory, sequence);
+        std::filesystem::path temporary_path = path;
+        temporary_path += ".tmp";
+        {
+            std::ofstream output(temporary_path, std::ios::binary);
+            output.write(reinterpret_cast<char const*>(&header), sizeof(SegmentHeader));
+            output.write(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+            output.write(reinterpret_cast<char const*>(all_ops.data()), all_ops.size() * sizeof(EdgeOp));
+            if (!output.flush())
+            {
+                throw std::runtime_error("Could not write segment: " + temporary_path.string());
+            }
+        }
+        std::filesystem::rename(temporary_path, path);
+    }
+
+    void complete(uint64_t const sequence)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_completed.insert(sequence);
+        while (!m_completed.empty() && *m_completed.begin() == m_completed_sequence + 1)
+        {
+            m_completed_sequence = *m_completed.begin();
+            m_completed.erase(m_completed.begin());
+        }
+    }
+
+    //! Returns the latest base and the completely appended segments younger
+    //! than the base.
+    Snapshot snapshot() const
+    {
+        uint64_t completed_sequence = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            completed_sequence = m_completed_sequence;
+        }
+
+        auto const [base, base_sequence] = latest_base(m_directory);
+        return Snapshot{ base, list_segments(m_directory, base_sequence, completed_sequence) };
+    }
+
+    template <typename F> static void read_base(std::filesystem::path const& base, F&& f)
+    {
+        if (base.empty())
+        {
+            return;
+        }
+
+        std::ifstream input(base, std::ios::binary);
+        BinaryGraphHeader const header = read_binary_graph_header(input);
+        for (EdgeT const& e : read_binary_edges<EdgeT>(input, header))
+        {
+            f(e, EdgeOp::insert);
+        }
+    }
+
+    std::vector<EdgeT> materialize(Snapshot const& files) const
+    {
+        std::vector<EdgeT> edges;
+        std::vector<bool> removed;
+        std::unordered_map<EdgeKey, std::vector<size_t>, EdgeKeyHash> positions;
+
+        auto apply = [&](EdgeT const& e, EdgeOp const op)
+        {
+            EdgeKey const key{ uint64_t(Traits::source(e)), uint64_t(Traits::target(e)), uint64_t(Traits::timestamp(e)) };
+            if (op == EdgeOp::insert)
+            {
+                positions[key].push_back(edges.size());
+                edges.push_back(e);
+                removed.push_back(false);
+                return;
+            }
+
+            auto it = positions.find(key);
+            if (it != positions.end() && !it->second.empty())
+            {
+                removed[it->second.back()] = true;
+                it->second.pop_back();
+            }
+        };
+
+        read_base(files.base, apply);
+        for (SegmentFile const& segment : files.segments)
+        {
+            read_segment<EdgeT>(segment, apply);
+        }
+
+        size_t live = 0;
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            if (!removed[i])
+            {
+                edges[live++] = edges[i];
+            }
+        }
+        edges.resize(live);
+
+        return edges;
+    }
+
+    std::filesystem::path m_directory;
+    uint64_t m_next_sequence = 1;
+    // All sequences up to m_completed_sequence are appended (or failed),
+    // m_completed holds completed sequences above the next missing one.
+    uint64_t m_completed_sequence = 0;
+    std::set<uint64_t> m_completed;
+    mutable std::mutex m_mutex;
+    std::mutex m_compaction_mutex;
+    // Shared by readers, exclusive while compaction replaces files.
+    mutable std::shared_mutex m_files_mutex;
+};
+
+} // namespace gdsb
@@ -4,22 +4,47 @@
 //! functionality is specifically used to process graphs of different formats,
 //! converting them to a common binary format.
 
+#include <gdsb/batcher.h>
+#include <gdsb/graph.h>
+#include <gdsb/graph_compression.h>
+#include <gdsb/graph_io_parameters.h>
+#include <gdsb/graph_sections.h>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <exception>
 #include <filesystem>
 #include <fstream>
+#include <sstream>
 #include <stdexcept>
+#include <vector>
 
 namespace gdsb
 {
 
-std::ofstream open_binary_file(std::filesystem::path const& file_path)
+inline std::ofstream open_binary_file(std::filesystem::path const& file_path)
 {
     std::ofstream output_file;
     output_file.open(file_path.c_str(), std::ios::out | std::ios::binary);
     return output_file;
 }
 
+//! Writes the identifier of the current binary graph version followed by the
+//! given header.
+inline void write_header(std::ofstream& output_file, BinaryGraphHeader const& header)
+{
+    BinaryGraphHeaderIdentifier const header_id;
+    output_file.write(reinterpret_cast<char const*>(&header_id), sizeof(BinaryGraphHeaderIdentifier));
+    output_file.write(reinterpret_cast<char const*>(&header), sizeof(BinaryGraphHeader));
+}
+
 template <typename GraphParameters = GraphParameters<FileType::binary>, typename VertexT, typename WeightT, typename TimestampT>
-void write_header(std::ofstream& output_file, BinaryGraphHeaderIdentifier&& header_id, uint64_t const vertex_count, uint64_t const edge_count)
+void write_header(std::ofstream& output_file,
+                  BinaryGraphHeaderIdentifier&& header_id,
+                  uint64_t const vertex_count,
+                  uint64_t const edge_count,
+                  EdgeEncoding const encoding = EdgeEncoding::raw)
 {
     if constexpr (GraphParameters::filetype() == FileType::binary)
     {
@@ -39,6 +64,7 @@ void write_header(std::ofstream& output_file, BinaryGraphHeaderIdentifier&& head
             header_data.directed = GraphParameters::is_directed();
             header_data.weighted = GraphParameters::is_weighted();
             header_data.dynamic = GraphParameters::is_dynamic();
+            header_data.encoding = encoding;
 
             char* const header_data_byte_array = reinterpret_cast<char*>(&header_data);
             output_file.write(header_data_byte_array, sizeof(BinaryGraphHeader));
@@ -55,13 +81,215 @@ void write_graph(std::ofstream& output_file, Edges&& edges, uint64_t const verte
 {
     write_header<GraphParameters, VertexT, WeightT, TimestampT>(output_file, BinaryGraphHeaderIdentifier{}, vertex_count, edge_count);
 
-    for (auto const e : edges)
+    for (auto const& e : edges)
     {
         write_edge_f(output_file, e);
     }
 
-    // flush file
-    output_file << std::endl;
+    output_file.flush();
+}
+
+//! Owns a file opened for writing. Threads may write disjoint byte ranges of
+//! the file concurrently, each at a precomputed offset, see pwrite(2).
+class ParallelFileWriter
+{
+public:
+    explicit ParallelFileWriter(std::filesystem::path const& file_path);
+    ~ParallelFileWriter();
+
+    ParallelFileWriter(ParallelFileWriter const&) = delete;
+    ParallelFileWriter& operator=(ParallelFileWriter const&) = delete;
+
+    //! Writes size bytes of data at offset of the file, throws on failure.
+    void write(void const* data, size_t size, uint64_t offset) const;
+
+private:
+    int m_fd;
+};
+
+struct BinaryWriteOptions
+{
+    EdgeEncoding encoding = EdgeEncoding::raw;
+    // Count of edges per independently encoded chunk, not used for raw edges.
+    uint64_t chunk_edge_count = uint64_t(1) << 16;
+    // Compression level of block codecs, only used by Zstandard.
+    int compression_level = 1;
+    // Store vertex IDs and timestamps using the fewest bytes for the largest
+    // value instead of the byte sizes of the edge type.
+    bool narrow_widths = true;
+    // Append the graph statistics, see graph_sections.h.
+    bool statistics = true;
+    // Append the out-degree of every vertex, requires statistics.
+    bool degrees = false;
+    // Append a timestamp index sampling every n-th edge if the edges are
+    // sorted by timestamp (zero disables the index), requires statistics.
+    uint64_t timestamp_index_stride = uint64_t(1) << 12;
+    // Further sections to append, e.g. vertex property columns, see
+    // vertex_properties.h.
+    std::vector<BinaryGraphSection> sections;
+};
+
+struct BinaryWriteStatistics
+{
+    uint64_t edge_count = 0;
+    // Bytes used to store all edges, including a chunk directory but excluding
+    // the header.
+    uint64_t edge_bytes = 0;
+
+    double bits_per_edge() const { return edge_count ? 8. * double(edge_bytes) / double(edge_count) : 0.; }
+};
+
+//! Writes all edges to a GDSB binary graph file at file_path using the
+//! encoding set in options. In contrast to write_graph() using a write edge
+//! function, the edges are serialized according to their type, see
+//! EdgeTraits, and by default using the narrowest byte sizes for vertex IDs and
+//! timestamps, see binary::narrowest_edge_layout(). By default the graph
+//! statistics are appended as a section, see graph_sections.h. Edges are
+//! serialized and written in parallel: each thread writes its slice of edges
+//! (or its encoded chunks) at the precomputed file offset. Returns the size of
+//! the written edge data, e.g. to report the bits per edge of a compressed
+//! encoding.
+template <typename GraphParameters, typename Edges>
+BinaryWriteStatistics write_graph(std::filesystem::path const& file_path,
+                                  Edges const& edges,
+                                  uint64_t const vertex_count,
+                                  BinaryWriteOptions const& options = BinaryWriteOptions{})
+{
+    using Edge_t = typename Edges::value_type;
+    using Traits = EdgeTraits<Edge_t>;
+    static_assert(GraphParameters::is_weighted() == Traits::is_weighted(), "Edge type must match graph parameters.");
+    static_assert(GraphParameters::is_dynamic() == Traits::is_dynamic(), "Edge type must match graph parameters.");
+
+    ParallelFileWriter const output_file(file_path);
+
+    uint64_t const edge_count = edges.size();
+    binary::EdgeLayout const layout = options.narrow_widths
+        ? binary::narrowest_edge_layout(edges.data(), edge_count, vertex_count)
+        : binary::native_edge_layout<Edge_t>();
+
+    BinaryGraphHeader header;
+    header.vertex_count = vertex_count;
+    header.edge_count = edge_count;
+    header.vertex_id_byte_size = layout.vertex_id_byte_size;
+    header.weight_byte_size = layout.weight_byte_size;
+    header.timestamp_byte_size = layout.timestamp_byte_size;
+    header.directed = GraphParameters::is_directed();
+    header.weighted = GraphParameters::is_weighted();
+    header.dynamic = GraphParameters::is_dynamic();
+    header.encoding = options.encoding;
+    header.has_sections = options.statistics || !options.sections.empty();
+
+    BinaryGraphHeaderIdentifier const header_id;
+    output_file.write(&header_id, sizeof(BinaryGraphHeaderIdentifier), 0);
+    output_file.write(&header, sizeof(BinaryGraphHeader), sizeof(BinaryGraphHeaderIdentifier));
+    uint64_t const edges_begin = sizeof(BinaryGraphHeaderIdentifier) + sizeof(BinaryGraphHeader);
+    uint64_t edge_bytes = 0;
+
+    // Exceptions must not escape the parallel regions, thus we rethrow the
+    // (last) caught one afterwards.
+    std::exception_ptr error;
+
+    switch (options.encoding)
+    {
+    case EdgeEncoding::raw:
+    {
+        // Each thread serializes a contiguous slice of edges block wise and
+        // writes the blocks at their final position in the file.
+        size_t const edge_size = layout.edge_size_in_bytes();
+        edge_bytes = edge_count * edge_size;
+
+#pragma omp parallel
+        {
+            uint32_t const thread_id = omp_get_thread_num();
+            uint32_t const thread_count = omp_get_num_threads();
+            uint64_t const slice_begin = batch_offset(edge_count, thread_id, thread_count);
+            uint64_t const slice_end = slice_begin + partition_batch_count(edge_count, thread_id, thread_count);
+
+            size_t const block_edge_count = size_t(1) << 16;
+            try
+            {
+                std::vector<uint8_t> block(std::min(slice_end - slice_begin, uint64_t(block_edge_count)) * edge_size);
+                for (uint64_t begin = slice_begin; begin < slice_end; begin += block_edge_count)
+                {
+                    size_t const count = std::min(uint64_t(block_edge_count), slice_end - begin);
+                    binary::encode_edges(edges.data() + begin, count, layout, block.data());
+                    output_file.write(block.data(), count * edge_size, edges_begin + begin * edge_size);
+                }
+            }
+            catch (...)
+            {
+#pragma omp critical
+                error = std::current_exception();
+            }
+        }
+        break;
+    }
+    case EdgeEncoding::stream_vbyte:
+    case EdgeEncoding::lz4:
+    case EdgeEncoding::zstd:
+    {
+        std::vector<std::vector<uint8_t>> const chunks = encode_edge_chunks(
+            options.encoding, edges.data(), edge_count, options.chunk_edge_count, layout, options.compression_level);
+        EdgeChunkDirectory const directory = make_chunk_directory(chunks, options.chunk_edge_count);
+
+        std::ostringstream directory_bytes;
+        write_chunk_directory(directory_bytes, directory);
+        output_file.write(directory_bytes.str().data(), directory.size_in_bytes(), edges_begin);
+
+        uint64_t const chunks_begin = edges_begin + directory.size_in_bytes();
+        edge_bytes = directory.size_in_bytes() + directory.offsets.back();
+        int64_t const chunks_size = static_cast<int64_t>(chunks.size());
+
+#pragma omp parallel for schedule(dynamic)
+        for (int64_t c = 0; c < chunks_size; ++c)
+        {
+            try
+            {
+                output_file.write(chunks[c].data(), chunks[c].size(), chunks_begin + directory.offsets[c]);
+            }
+            catch (...)
+            {
+#pragma omp critical
+                error = std::current_exception();
+            }
+        }
+        break;
+    }
+    default:
+        throw std::logic_error("Edge encoding not supported for writing.");
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    if (header.has_sections)
+    {
+        std::vector<BinaryGraphSection> sections;
+        if (options.statistics)
+        {
+            std::vector<Degree64> degrees;
+            BinaryGraphStatistics const statistics =
+                compute_statistics(edges.data(), edge_count, options.degrees ? &degrees : nullptr);
+            sections = make_statistics_sections(statistics, degrees);
+            if (Traits::is_dynamic() && statistics.sorted_by_timestamp && options.timestamp_index_stride > 0)
+            {
+                sections.push_back(make_timestamp_index_section(
+                    make_timestamp_index(edges.data(), edge_count, options.timestamp_index_stride)));
+            }
+        }
+        sections.insert(std::end(sections), std::begin(options.sections), std::end(options.sections));
+
+        uint64_t const sections_begin = edges_begin + edge_bytes;
+        std::vector<uint8_t> const section_bytes = serialize_sections(sections, sections_begin);
+        output_file.write(section_bytes.data(), section_bytes.size(), sections_begin);
+    }
+
+    BinaryWriteStatistics statistics;
+    statistics.edge_count = edge_count;
+    statistics.edge_bytes = edge_bytes;
+    return statistics;
 }
 
 } // namespace gdsb
@@ -0,0 +1,227 @@
+#pragma once
+
+//! This file contains the sections of GDSB binary graph files. Sections hold
+//! data about the graph besides its edges, e.g. precomputed statistics, and
+//! follow the edge data. Each section starts at a file offset aligned to 8
+//! bytes. The file ends with the section table and the section footer:
+//! - SectionEntry entries[section count]
+//! - SectionFooter (table offset, section count, magic)
+//! Readers locate the table using the footer at the end of the file. Files
+//! holding sections set BinaryGraphHeader::has_sections.
+
+#include <gdsb/binary_codec.h>
+#include <gdsb/graph.h>
+#include <gdsb/graph_io_parameters.h>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace gdsb
+{
+
+enum class SectionType : uint32_t
+{
+    statistics = 1,
+    degrees = 2,
+    timestamp_index = 3,
+    // One section per column, see vertex_properties.h.
+    vertex_property = 4
+};
+
+struct SectionEntry
+{
+    SectionType type = SectionType::statistics;
+    uint32_t reserved = 0;
+    // Absolute offset within the file.
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+
+static_assert(sizeof(SectionEntry) == 24u, "The section entry layout must not change.");
+
+struct SectionFooter
+{
+    uint64_t table_offset = 0;
+    uint64_t section_count = 0;
+    char magic[8] = { 'G', 'D', 'S', 'B', 'S', 'E', 'C', 'T' };
+};
+
+static_assert(sizeof(SectionFooter) == 24u, "The section footer layout must not change.");
+
+struct BinaryGraphSection
+{
+    SectionType type = SectionType::statistics;
+    std::vector<uint8_t> data;
+};
+
+//! Serializes the sections followed by the section table and footer. The
+//! returned bytes are meant to be written at file offset begin, e.g. right
+//! after the edge data, and start with padding to align the first section.
+std::vector<uint8_t> serialize_sections(std::vector<BinaryGraphSection> const& sections, uint64_t begin);
+
+//! Reads the section table of a file with BinaryGraphHeader::has_sections set.
+//! The position of input is restored afterwards.
+std::vector<SectionEntry> read_section_table(std::istream& input);
+
+std::optional<SectionEntry> find_section(std::vector<SectionEntry> const& table, SectionType type);
+
+//! Reads the data of a section, the position of input is restored afterwards.
+std::vector<uint8_t> read_section(std::istream& input, SectionEntry const& entry);
+
+//! Statistics of a graph computed once when writing the binary graph such that
+//! readers may pre-size data structures and skip scanning or sorting passes.
+struct BinaryGraphStatistics
+{
+    // Largest vertex ID of all edges + 1, zero without edges.
+    uint64_t vertex_count = 0;
+    uint64_t edge_count = 0;
+    // Maximum count of edges sharing a source vertex, see max_nnz().
+    uint64_t max_degree = 0;
+    uint64_t min_timestamp = 0;
+    uint64_t max_timestamp = 0;
+    bool sorted_by_source = false;
+    bool sorted_by_timestamp = false;
+    // Byte size of the entries of the degrees section, zero without one.
+    uint8_t degree_byte_size = 0;
+    uint8_t reserved[5] = {};
+};
+
+static_assert(sizeof(BinaryGraphStatistics) == 48u, "The statistics layout must not change.");
+
+//! Computes the statistics of count edges in parallel. If degrees is not
+//! nullptr, it is set to the out-degree of every vertex [0, vertex_count).
+template <typename EdgeT>
+BinaryGraphStatistics compute_statistics(EdgeT const* const edges, uint64_t const count, std::vector<Degree64>* const degrees = nullptr)
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    BinaryGraphStatistics statistics;
+    statistics.edge_count = count;
+
+    uint64_t max_vertex = 0;
+    uint64_t min_timestamp = std::numeric_limits<uint64_t>::max();
+    uint64_t max_timestamp = 0;
+    bool sorted_by_source = true;
+    bool sorted_by_timestamp = true;
+
+#pragma omp parallel for reduction(max : max_vertex, max_timestamp) reduction(min : min_timestamp) \
+    reduction(&& : sorted_by_source, sorted_by_timestamp)
+    for (int64_t i = 0; i < int64_t(count); ++i)
+    {
+        EdgeT const& e = edges[i];
+        max_vertex = std::max(max_vertex, uint64_t(std::max(Traits::source(e), Traits::target(e))));
+        min_timestamp = std::min(min_timestamp, uint64_t(Traits::timestamp(e)));
+        max_timestamp = std::max(max_timestamp, uint64_t(Traits::timestamp(e)));
+
+        if (i > 0)
+        {
+            sorted_by_source = sorted_by_source && Traits::source(edges[i - 1]) <= Traits::source(e);
+            sorted_by_timestamp = sorted_by_timestamp && Traits::timestamp(edges[i - 1]) <= Traits::timestamp(e);
+        }
+    }
+
+    if (count == 0)
+    {
+        return statistics;
+    }
+
+    statistics.vertex_count = max_vertex + 1;
+    statistics.min_timestamp = min_timestamp;
+    statistics.max_timestamp = max_timestamp;
+    statistics.sorted_by_source = sorted_by_source;
+    statistics.sorted_by_timestamp = sorted_by_timestamp;
+
+    if (degrees)
+    {
+        degrees->assign(statistics.vertex_count, 0u);
+
+#pragma omp parallel for
+        for (int64_t i = 0; i < int64_t(count); ++i)
+        {
+#pragma omp atomic
+            ++(*degrees)[Traits::source(edges[i])];
+        }
+
+        statistics.max_degree = *std::max_element(std::begin(*degrees), std::end(*degrees));
+        return statistics;
+    }
+
+    // Without a degree array the maximum degree is the longest run of equal
+    // sources, thus unsorted sources are sorted first. This avoids allocating
+    // one counter per vertex for sparse vertex IDs.
+    std::vector<typename Traits::Vertex> sources;
+    if (!sorted_by_source)
+    {
+        sources.resize(count);
+#pragma omp parallel for
+        for (int64_t i = 0; i < int64_t(count); ++i)
+        {
+            sources[i] = Traits::source(edges[i]);
+        }
+        std::sort(std::begin(sources), std::end(sources));
+    }
+
+    auto source = [&](uint64_t const i) { return sorted_by_source ? Traits::source(edges[i]) : sources[i]; };
+    uint64_t run_begin = 0;
+    for (uint64_t i = 1; i <= count; ++i)
+    {
+        if (i == count || source(i) != source(run_begin))
+        {
+            statistics.max_degree = std::max(statistics.max_degree, i - run_begin);
+            run_begin = i;
+        }
+    }
+
+    return statistics;
+}
+
+//! Returns the statistics section and, if degrees is not empty, the degrees
+//! section stored using the narrowest byte size for the maximum degree.
+std::vector<BinaryGraphSection> make_statistics_sections(BinaryGraphStatistics statistics, std::vector<Degree64> const& degrees);
+
+//! Reads the statistics written along with the graph, if any. The position of
+//! input is restored afterwards.
+std::optional<BinaryGraphStatistics> read_binary_graph_statistics(std::istream& input, BinaryGraphHeader const& header);
+
+//! Reads the out-degree of every vertex written along with the graph. Returns
+//! an empty vector if the file has no degrees section. The position of input
+//! is restored afterwards.
+std::vector<Degree64> read_binary_graph_degrees(std::istream& input, BinaryGraphHeader const& header);
+
+//! Sparse index of a time sorted graph: the timestamp of every stride-th edge.
+//! Thus, the edges with timestamp t are found within the stride edges
+//! following the last sample less than t.
+struct TimestampIndex
+{
+    uint64_t stride = 0;
+    std::vector<uint64_t> timestamps;
+};
+
+template <typename EdgeT> TimestampIndex make_timestamp_index(EdgeT const* const edges, uint64_t const count, uint64_t const stride)
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    TimestampIndex index;
+    index.stride = stride;
+    index.timestamps.resize((count + stride - 1) / stride);
+    for (uint64_t i = 0; i < index.timestamps.size(); ++i)
+    {
+        index.timestamps[i] = uint64_t(Traits::timestamp(edges[i * stride]));
+    }
+
+    return index;
+}
+
+BinaryGraphSection make_timestamp_index_section(TimestampIndex const& index);
+
+//! Reads the timestamp index written along with the graph, if any. The
+//! position of input is restored afterwards.
+std::optional<TimestampIndex> read_timestamp_index(std::istream& input, BinaryGraphHeader const& header);
+
+} // namespace gdsb
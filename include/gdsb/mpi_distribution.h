@@ -0,0 +1,688 @@
+#pragma once
+
+//! This file contains the redistribution of edges among MPI processes, e.g.
+//! after reading arbitrary slices of a binary graph using
+//! all_read_binary_graph_partition(), such that every process holds the edges
+//! of the source vertices it owns. The ownership of vertices is pluggable:
+//! any function mapping a vertex to a rank of the communicator may be used,
+//! see BlockOwner, HashOwner and RangeOwner.
+
+#include <gdsb/batcher.h>
+#include <gdsb/graph.h>
+#include <gdsb/mpi_graph_io.h>
+
+#include <mpi.h>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdsb
+{
+namespace mpi
+{
+
+//! Owns blocks of consecutive vertices as batch_offset() cuts them: process p
+//! owns [p * (n / size), (p + 1) * (n / size)), the last one the remainder.
+class BlockOwner
+{
+public:
+    BlockOwner(uint64_t const vertex_count, int const process_count)
+        : m_block_size(std::max(uint64_t(1), vertex_count / uint64_t(process_count)))
+        , m_process_count(process_count)
+    {
+    }
+
+    int operator()(uint64_t const v) const { return int(std::min(v / m_block_size, uint64_t(m_process_count - 1))); }
+
+private:
+    uint64_t m_block_size;
+    int m_process_count;
+};
+
+//! Scatters vertices among the processes by a hash of their ID, balancing the
+//! edges of graphs where high degree vertices have consecutive IDs.
+class HashOwner
+{
+public:
+    explicit HashOwner(int const process_count)
+        : m_process_count(process_count)
+    {
+    }
+
+    int operator()(uint64_t v) const
+    {
+        // Finalizer of splitmix64.
+        v = (v ^ (v >> 30)) * 0xbf58476d1ce4e5b9ull;
+        v = (v ^ (v >> 27)) * 0x94d049bb133111ebull;
+        v = v ^ (v >> 31);
+        return int(v % uint64_t(m_process_count));
+    }
+
+private:
+    int m_process_count;
+};
+
+//! Owns ranges of consecutive vertices, process p owns [vertex_begins[p],
+//! vertex_begins[p + 1]) and the last one all vertices from its begin on.
+class RangeOwner
+{
+public:
+    explicit RangeOwner(std::vector<uint64_t> vertex_begins);
+
+    int operator()(uint64_t const v) const
+    {
+        return int(std::distance(m_vertex_begins.begin(), std::upper_bound(m_vertex_begins.begin(), m_vertex_begins.end(), v))) - 1;
+    }
+
+    std::vector<uint64_t> const& vertex_begins() const { return m_vertex_begins; }
+
+private:
+    std::vector<uint64_t> m_vertex_begins;
+};
+
+//! Sums the source degrees of the edges of all processes of comm for the
+//! vertices [0, vertex_count), the histogram is reduced using MPI_Allreduce().
+template <typename EdgeT>
+std::vector<Degree64> all_source_degrees(std::vector<EdgeT> const& edges, uint64_t const vertex_count, MPI_Comm const comm = MPI_COMM_WORLD)
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    std::vector<Degree64> degrees(vertex_count, 0u);
+    for (EdgeT const& e : edges)
+    {
+        uint64_t const source = uint64_t(Traits::source(e));
+        if (source >= vertex_count)
+        {
+            throw std::out_of_range("Source vertex exceeds the vertex count.");
+        }
+        ++degrees[source];
+    }
+
+    uint64_t const max_count = uint64_t(std::numeric_limits<int>::max());
+    for (uint64_t begin = 0; begin < vertex_count; begin += max_count)
+    {
+        MPI_Allreduce(MPI_IN_PLACE, degrees.data() + begin, int(std::min(max_count, vertex_count - begin)), MPI_UINT64_T, MPI_SUM, comm);
+    }
+
+    return degrees;
+}
+
+//! Returns the ranges of consecutive source vertices balancing the edges of
+//! all processes of comm, computed from the global degree histogram, see
+//! all_source_degrees() and vertex_partitions().
+template <typename EdgeT>
+RangeOwner degree_balanced_owner(std::vector<EdgeT> const& edges, uint64_t const vertex_count, MPI_Comm const comm = MPI_COMM_WORLD)
+{
+    int size = 1;
+    MPI_Comm_size(comm, &size);
+
+    std::vector<VertexPartition> const partitions = vertex_partitions(all_source_degrees(edges, vertex_count, comm), uint32_t(size));
+    std::vector<uint64_t> vertex_begins(partitions.size());
+    std::transform(partitions.begin(), partitions.end(), vertex_begins.begin(), [](VertexPartition const& p) { return p.vertex_begin; });
+    return RangeOwner(std::move(vertex_begins));
+}
+
+//! Exchanges elements of datatype among all processes of comm as
+//! MPI_Alltoallv(), counts and displacements given in elements. Exchanges
+//! exceeding max_count elements (i.e. the int count type of MPI) are
+//! exchanged using MPI_Alltoallv_c() if the MPI library implements MPI 4,
+//! otherwise in rounds of at most max_count elements per process. The rounds
+//! use MPI_Alltoallw() with derived datatypes describing the elements in place,
+//! thus they need no buffers besides send and receive.
+void alltoallv(void const* send,
+               std::vector<uint64_t> const& send_counts,
+               std::vector<uint64_t> const& send_displacements,
+               void* receive,
+               std::vector<uint64_t> const& receive_counts,
+               std::vector<uint64_t> const& receive_displacements,
+               MPI_Datatype datatype,
+               MPI_Comm comm = MPI_COMM_WORLD,
+               uint64_t max_count = uint64_t(std::numeric_limits<int>::max()));
+
+//! Merges the consecutive sorted runs [run_begins[i], run_begins[i + 1]) of
+//! [begin, end) into one sorted range, merging pairs of runs in parallel.
+template <typename It, typename Compare> void merge_runs(It const begin, It const end, std::vector<uint64_t> run_begins, Compare cmp)
+{
+    run_begins.push_back(uint64_t(std::distance(begin, end)));
+    while (run_begins.size() > 2)
+    {
+        int64_t const pair_count = int64_t(run_begins.size() - 1) / 2;
+#pragma omp parallel for schedule(dynamic)
+        for (int64_t i = 0; i < pair_count; ++i)
+        {
+            std::inplace_merge(begin + run_begins[2 * i], begin + run_begins[2 * i + 1], begin + run_begins[2 * i + 2], cmp);
+        }
+
+        std::vector<uint64_t> merged;
+        for (size_t i = 0; i < run_begins.size(); i += 2)
+        {
+            merged.push_back(run_begins[i]);
+        }
+        if (merged.back() != run_begins.back())
+        {
+            merged.push_back(run_begins.back());
+        }
+        run_begins = std::move(merged);
+    }
+}
+
+//! Sorts [begin, end) using all OpenMP threads: each thread sorts a slice,
+//! the sorted slices are merged using merge_runs().
+template <typename It, typename Compare> void parallel_sort(It const begin, It const end, Compare cmp)
+{
+    uint64_t const count = uint64_t(std::distance(begin, end));
+    int const thread_count = int(std::min(uint64_t(omp_get_max_threads()), std::max(uint64_t(1), count)));
+    std::vector<uint64_t> run_begins(thread_count);
+    for (int t = 0; t < thread_count; ++t)
+    {
+        run_begins[t] = batch_offset(count, t, thread_count);
+    }
+
+#pragma omp parallel for schedule(static, 1)
+    for (int t = 0; t < thread_count; ++t)
+    {
+        std::sort(begin + run_begins[t], begin + run_begins[t] + partition_batch_count(count, t, thread_count), cmp);
+    }
+
+    merge_runs(begin, end, std::move(run_begins), cmp);
+}
+
+//! Sends every edge to the process edge_owner(edge) of comm and returns the
+//! received edges sorted by EdgeLess. Edges are packed and sorted per
+//! destination, exchanged using alltoallv() and the received runs are merged
+//! (see merge_runs()), thus also exchanges beyond the int count type
+//! of MPI are supported. Throws on all processes if edge_owner() returns an
+//! invalid rank on any of them.
+template <typename EdgeT, typename EdgeOwnerF>
+std::vector<EdgeT> redistribute_edges_by(std::vector<EdgeT> const& edges, EdgeOwnerF&& edge_owner, MPI_Comm const comm = MPI_COMM_WORLD)
+{
+    int size = 1;
+    MPI_Comm_size(comm, &size);
+
+    int64_t const edge_count = int64_t(edges.size());
+    std::vector<int> owners(edges.size());
+    int invalid_owner = 0;
+#pragma omp parallel for reduction(| : invalid_owner)
+    for (int64_t i = 0; i < edge_count; ++i)
+    {
+        owners[i] = edge_owner(edges[i]);
+        invalid_owner |= int(owners[i] < 0 || owners[i] >= size);
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, &invalid_owner, 1, MPI_INT, MPI_LOR, comm);
+    if (invalid_owner)
+    {
+        throw std::out_of_range("Owner of edge is not a rank of the communicator.");
+    }
+
+    // Counting sort by destination keeps the order of the edges per process.
+    std::vector<uint64_t> send_counts(size, 0u);
+    for (int const o : owners)
+    {
+        ++send_counts[o];
+    }
+    std::vector<uint64_t> send_displacements(size, 0u);
+    for (int p = 1; p < size; ++p)
+    {
+        send_displacements[p] = send_displacements[p - 1] + send_counts[p - 1];
+    }
+    std::vector<EdgeT> send(edges.size());
+    std::vector<uint64_t> position = send_displacements;
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        send[position[owners[i]]++] = edges[i];
+    }
+
+    // Each process receives sorted runs which are merged afterwards.
+#pragma omp parallel for schedule(dynamic)
+    for (int p = 0; p < size; ++p)
+    {
+        std::sort(send.begin() + send_displacements[p], send.begin() + send_displacements[p] + send_counts[p], EdgeLess{});
+    }
+
+    std::vector<uint64_t> receive_counts(size, 0u);
+    MPI_Alltoall(send_counts.data(), 1, MPI_UINT64_T, receive_counts.data(), 1, MPI_UINT64_T, comm);
+    std::vector<uint64_t> receive_displacements(size, 0u);
+    for (int p = 1; p < size; ++p)
+    {
+        receive_displacements[p] = receive_displacements[p - 1] + receive_counts[p - 1];
+    }
+
+    std::vector<EdgeT> received(receive_displacements.back() + receive_counts.back());
+    typename MPIEdgeDataType<EdgeT>::type const datatype;
+    alltoallv(send.data(), send_counts, send_displacements, received.data(), receive_counts, receive_displacements, datatype.get(), comm);
+
+    merge_runs(received.begin(), received.end(), std::move(receive_displacements), EdgeLess{});
+    return received;
+}
+
+//! Sends every edge to the process owner(source) of comm, see
+//! redistribute_edges_by().
+template <typename EdgeT, typename OwnerF>
+std::vector<EdgeT> redistribute_edges(std::vector<EdgeT> const& edges, OwnerF&& owner, MPI_Comm const comm = MPI_COMM_WORLD)
+{
+    using Traits = EdgeTraits<EdgeT>;
+    return redistribute_edges_by(
+        edges, [&](EdgeT const& e) { return owner(uint64_t(Traits::source(e))); }, comm);
+}
+
+//! Sorts the edges of all processes of comm globally using sample sort: the
+//! edges of each process are sorted locally (see parallel_sort()), the root
+//! process selects up to size - 1 splitters from oversampling (at least one)
+//! regular samples of every process and broadcasts them, then the edges are exchanged among the
+//! processes using alltoallv() and the received sorted runs are merged (see
+//! merge_runs()). Afterwards, the edges of process p precede those of
+//! process p + 1 according to cmp, e.g. SourceLess, EdgeLess (source, then
+//! target) or TimestampLess, thus they may be written using
+//! all_write_binary_graph(). Edges equal according to cmp belong to the same
+//! process, thus many equal edges may unbalance the processes.
+template <typename EdgeT, typename Compare = EdgeLess>
+std::vector<EdgeT> sample_sort(std::vector<EdgeT> edges,
+                               Compare cmp = Compare{},
+                               MPI_Comm const comm = MPI_COMM_WORLD,
+                               uint32_t const oversampling = 16,
+                               int const root = 0)
+{
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    if (oversampling == 0)
+    {
+        throw std::invalid_argument("Sample sort requires at least one sample per process.");
+    }
+
+    parallel_sort(edges.begin(), edges.end(), cmp);
+    if (size == 1)
+    {
+        return edges;
+    }
+
+    typename MPIEdgeDataType<EdgeT>::type const datatype;
+
+    // Regular samples of the sorted local edges.
+    int const sample_count = int(std::min(uint64_t(oversampling), uint64_t(edges.size())));
+    std::vector<EdgeT> samples(sample_count);
+    for (int i = 0; i < sample_count; ++i)
+    {
+        samples[i] = edges[(2 * uint64_t(i) + 1) * edges.size() / (2 * uint64_t(sample_count))];
+    }
+
+    std::vector<int> sample_counts(rank == root ? size : 0);
+    MPI_Gather(&sample_count, 1, MPI_INT, sample_counts.data(), 1, MPI_INT, root, comm);
+    std::vector<int> sample_displacements(sample_counts.size(), 0);
+    std::vector<EdgeT> all_samples;
+    if (rank == root)
+    {
+        for (int p = 1; p < size; ++p)
+        {
+            sample_displacements[p] = sample_displacements[p - 1] + sample_counts[p - 1];
+        }
+        all_samples.resize(sample_displacements.back() + sample_counts.back());
+    }
+    MPI_Gatherv(samples.data(), sample_count, datatype.get(), all_samples.data(), sample_counts.data(), sample_displacements.data(),
+                datatype.get(), root, comm);
+
+    // Splitter i is the greatest edge of process i. With fewer samples than
+    // processes, each sample is a splitter and the last processes receive no
+    // edges. There are no samples only if there are no edges at all.
+    int splitter_count = 0;
+    std::vector<EdgeT> splitters(size - 1);
+    if (rank == root)
+    {
+        std::sort(all_samples.begin(), all_samples.end(), cmp);
+        splitter_count = int(std::min(uint64_t(size - 1), uint64_t(all_samples.size())));
+        for (int i = 0; i < splitter_count; ++i)
+        {
+            splitters[i] = all_samples[(uint64_t(i) + 1) * all_samples.size() / (uint64_t(splitter_count) + 1)];
+        }
+    }
+    MPI_Bcast(&splitter_count, 1, MPI_INT, root, comm);
+    if (splitter_count == 0)
+    {
+        return edges;
+    }
+    MPI_Bcast(splitters.data(), splitter_count, datatype.get(), root, comm);
+
+    std::vector<uint64_t> send_displacements(size + 1, 0u);
+    send_displacements[size] = edges.size();
+    for (int p = 1; p < size; ++p)
+    {
+        send_displacements[p] = p <= splitter_count
+            ? uint64_t(std::distance(edges.begin(), std::upper_bound(edges.begin(), edges.end(), splitters[p - 1], cmp)))
+            : edges.size();
+    }
+    std::vector<uint64_t> send_counts(size);
+    for (int p = 0; p < size; ++p)
+    {
+        send_counts[p] = send_displacements[p + 1] - send_displacements[p];
+    }
+    send_displacements.pop_back();
+
+    std::vector<uint64_t> receive_counts(size, 0u);
+    MPI_Alltoall(send_counts.data(), 1, MPI_UINT64_T, receive_counts.data(), 1, MPI_UINT64_T, comm);
+    std::vector<uint64_t> receive_displacements(size, 0u);
+    for (int p = 1; p < size; ++p)
+    {
+        receive_displacements[p] = receive_displacements[p - 1] + receive_counts[p - 1];
+    }
+
+    std::vector<EdgeT> received(receive_displacements.back() + receive_counts.back());
+    alltoallv(edges.data(), send_counts, send_displacements, received.data(), receive_counts, receive_displacements, datatype.get(), comm);
+    edges = std::vector<EdgeT>();
+
+    merge_runs(received.begin(), received.end(), std::move(receive_displacements), cmp);
+    return received;
+}
+
+//! Makes the distributed graph of the edges of all processes of comm
+//! undirected in one exchange: every edge (u, v) is sent to owner(u) and its
+//! reverse edge (v, u) to owner(v), see redistribute_edges(). The receiving
+//! process merges the sorted runs and removes self loops and duplicates, i.e.
+//! edges of the same source and target, keeping the first one according to
+//! EdgeLess (e.g. the earliest of a temporal graph). Returns the sorted edges
+//! of the source vertices owned by this process. In contrast to
+//! insert_return_edges(), the edges are not copied into one process first.
+template <typename EdgeT, typename OwnerF>
+std::vector<EdgeT> symmetrize_edges(std::vector<EdgeT> const& edges, OwnerF&& owner, MPI_Comm const comm = MPI_COMM_WORLD)
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    int64_t const edge_count = int64_t(edges.size());
+    std::vector<EdgeT> both_directions(2 * edges.size());
+#pragma omp parallel for
+    for (int64_t i = 0; i < edge_count; ++i)
+    {
+        both_directions[2 * i] = edges[i];
+        EdgeT& reverse = both_directions[2 * i + 1];
+        reverse = edges[i];
+        std::swap(Traits::source(reverse), Traits::target(reverse));
+    }
+
+    // Self loops are not sent at all.
+    both_directions.erase(std::remove_if(both_directions.begin(), both_directions.end(),
+                                         [](EdgeT const& e) { return Traits::source(e) == Traits::target(e); }),
+                          both_directions.end());
+
+    std::vector<EdgeT> symmetric = redistribute_edges(both_directions, std::forward<OwnerF>(owner), comm);
+    symmetric.erase(std::unique(symmetric.begin(), symmetric.end(),
+                                [](EdgeT const& a, EdgeT const& b)
+                                { return Traits::source(a) == Traits::source(b) && Traits::target(a) == Traits::target(b); }),
+                    symmetric.end());
+    return symmetric;
+}
+
+//! Arranges the processes of comm in a grid of rows x columns processes for a
+//! 2D (checkerboard) partitioning of the adjacency matrix: the process of row
+//! i and column j owns the edges with a source of vertex block i and a target
+//! of vertex block j. Compared to the ownership of vertices (1D), high degree
+//! vertices are spread over a row or column of processes and collectives
+//! involve the processes of a row or a column only. The grid is as square as
+//! the process count allows, i.e. rows is its largest divisor not greater
+//! than its square root. Process rank = row * columns + column.
+class ProcessGrid
+{
+public:
+    explicit ProcessGrid(uint64_t vertex_count, MPI_Comm comm = MPI_COMM_WORLD);
+    ~ProcessGrid();
+
+    ProcessGrid(ProcessGrid const&) = delete;
+    ProcessGrid& operator=(ProcessGrid const&) = delete;
+
+    int rows() const { return m_rows; }
+    int columns() const { return m_columns; }
+    int row() const { return m_row; }
+    int column() const { return m_column; }
+
+    //! Processes of the row of this process, ranked by their column, e.g. to
+    //! fold (reduce) the values of the rows of the adjacency matrix.
+    MPI_Comm row_comm() const { return m_row_comm; }
+    //! Processes of the column of this process, ranked by their row, e.g. to
+    //! expand (gather) the frontier of the columns of the adjacency matrix.
+    MPI_Comm column_comm() const { return m_column_comm; }
+
+    //! Row of the source vertex block of v.
+    int vertex_row(uint64_t const v) const { return m_row_owner(v); }
+    //! Column of the target vertex block of v.
+    int vertex_column(uint64_t const v) const { return m_column_owner(v); }
+
+    //! Rank of the process owning the edge (source, target).
+    int owner(uint64_t const source, uint64_t const target) const { return vertex_row(source) * m_columns + vertex_column(target); }
+
+private:
+    int m_rows = 1;
+    int m_columns = 1;
+    int m_row = 0;
+    int m_column = 0;
+    BlockOwner m_row_owner;
+    BlockOwner m_column_owner;
+    MPI_Comm m_row_comm = MPI_COMM_NULL;
+    MPI_Comm m_column_comm = MPI_COMM_NULL;
+};
+
+//! Sends every edge to the process of the grid owning its block, see
+//! ProcessGrid::owner() and redistribute_edges_by().
+template <typename EdgeT>
+std::vector<EdgeT> redistribute_edges(std::vector<EdgeT> const& edges, ProcessGrid const& grid, MPI_Comm const comm = MPI_COMM_WORLD)
+{
+    using Traits = EdgeTraits<EdgeT>;
+    return redistribute_edges_by(
+        edges, [&](EdgeT const& e) { return grid.owner(uint64_t(Traits::source(e)), uint64_t(Traits::target(e))); }, comm);
+}
+
+//! Loads the edge block of this process of a binary graph collectively: each
+//! process reads an equal slice of edges, see
+//! all_read_binary_graph_partition(), which are then redistributed to the
+//! processes of the grid owning them. The grid must be created on the
+//! communicator input was opened with.
+template <typename EdgeT>
+std::vector<EdgeT> all_read_binary_graph_block(MPI_File const input, BinaryGraphHeader const& header, ProcessGrid const& grid, MPI_Comm const comm = MPI_COMM_WORLD)
+{
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    return redistribute_edges(all_read_binary_graph_partition<EdgeT>(input, header, uint32_t(rank), uint32_t(size)), grid, comm);
+}
+
+//! All edges of a binary graph replicated once per node (shared memory
+//! domain) instead of once per process: the processes of comm on a node share
+//! a window allocated using MPI_Win_allocate_shared() on the communicator of
+//! MPI_Comm_split_type(MPI_COMM_TYPE_SHARED). One process per node (the node
+//! leader) reads an equal slice of the edges collectively with the other
+//! leaders, see all_read_binary_edges(), and the leaders broadcast their
+//! slices among each other. Thus, the file is read once in total. All
+//! processes get a read only view of the edges. Construction is collective
+//! and throws on all processes if any leader fails.
+//!
+//! If max_node_size is positive, the processes of a shared memory domain are
+//! split into nodes of at most max_node_size processes, each holding a copy,
+//! e.g. one copy per NUMA domain.
+template <typename EdgeT> class SharedGraph
+{
+public:
+    explicit SharedGraph(std::filesystem::path const& file_path, MPI_Comm const comm = MPI_COMM_WORLD, int const max_node_size = 0)
+    {
+        int rank = 0;
+        MPI_Comm_rank(comm, &rank);
+        MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &m_node_comm);
+        if (max_node_size > 0)
+        {
+            MPI_Comm shared_comm = m_node_comm;
+            int shared_rank = 0;
+            MPI_Comm_rank(shared_comm, &shared_rank);
+            MPI_Comm_split(shared_comm, shared_rank / max_node_size, shared_rank, &m_node_comm);
+            MPI_Comm_free(&shared_comm);
+        }
+        int node_rank = 0;
+        MPI_Comm_rank(m_node_comm, &node_rank);
+        bool const leader = node_rank == 0;
+        MPI_Comm_split(comm, leader ? 0 : MPI_UNDEFINED, rank, &m_leader_comm);
+
+        MPI_File input = MPI_FILE_NULL;
+        int succeeded = 1;
+        if (leader)
+        {
+            succeeded = MPI_File_open(m_leader_comm, file_path.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &input) == MPI_SUCCESS;
+            if (succeeded)
+            {
+                try
+                {
+                    m_header = read_binary_graph_header(input);
+                    require_raw_encoding(m_header);
+                    check_binary_edge_type<EdgeT>(m_header);
+                }
+                catch (std::exception const&)
+                {
+                    succeeded = 0;
+                }
+            }
+
+            // All leaders must fail together, otherwise the others wait in
+            // the collective reads for this one.
+            MPI_Allreduce(MPI_IN_PLACE, &succeeded, 1, MPI_INT, MPI_LAND, m_leader_comm);
+        }
+
+        MPI_Bcast(&succeeded, 1, MPI_INT, 0, m_node_comm);
+        MPI_Bcast(&m_header, sizeof(BinaryGraphHeader), MPI_BYTE, 0, m_node_comm);
+        if (!succeeded)
+        {
+            close(input);
+            release();
+            throw std::runtime_error("Could not read binary graph header: " + file_path.string());
+        }
+
+        MPI_Aint const window_size = leader ? MPI_Aint(m_header.edge_count * sizeof(EdgeT)) : 0;
+        EdgeT* edges = nullptr;
+        MPI_Win_allocate_shared(window_size, int(sizeof(EdgeT)), MPI_INFO_NULL, m_node_comm, &edges, &m_window);
+        MPI_Aint shared_size = 0;
+        int displacement_unit = 0;
+        MPI_Win_shared_query(m_window, 0, &shared_size, &displacement_unit, &edges);
+        m_edges = edges;
+
+        MPI_Win_fence(0, m_window);
+        std::exception_ptr error;
+        if (leader)
+        {
+            succeeded = read_edges(input, edges, error);
+        }
+        close(input);
+        MPI_Win_fence(0, m_window);
+
+        MPI_Bcast(&succeeded, 1, MPI_INT, 0, m_node_comm);
+        if (!succeeded)
+        {
+            release();
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+            throw std::runtime_error("Node leader could not read binary graph: " + file_path.string());
+        }
+    }
+
+    ~SharedGraph() { release(); }
+
+    SharedGraph(SharedGraph const&) = delete;
+    SharedGraph& operator=(SharedGraph const&) = delete;
+
+    BinaryGraphHeader const& header() const { return m_header; }
+
+    EdgeT const* data() const { return m_edges; }
+    uint64_t size() const { return m_header.edge_count; }
+    EdgeT const& operator[](uint64_t const i) const { return m_edges[i]; }
+    EdgeT const* begin() const { return m_edges; }
+    EdgeT const* end() const { return m_edges + m_header.edge_count; }
+
+    //! Processes sharing the edges with this process.
+    MPI_Comm node_comm() const { return m_node_comm; }
+
+private:
+    // Frees the window and communicators, also if construction fails.
+    void release()
+    {
+        if (m_window != MPI_WIN_NULL)
+        {
+            MPI_Win_free(&m_window);
+        }
+        if (m_leader_comm != MPI_COMM_NULL)
+        {
+            MPI_Comm_free(&m_leader_comm);
+        }
+        if (m_node_comm != MPI_COMM_NULL)
+        {
+            MPI_Comm_free(&m_node_comm);
+        }
+    }
+
+    static void close(MPI_File& input)
+    {
+        if (input != MPI_FILE_NULL)
+        {
+            MPI_File_close(&input);
+        }
+    }
+
+    // Reads the slice of this leader and broadcasts the slices among the
+    // leaders. Returns whether all leaders succeeded, the exception of this
+    // leader is stored to error instead of thrown since the others would wait
+    // for the broadcasts of its slice.
+    int read_edges(MPI_File const input, EdgeT* const edges, std::exception_ptr& error)
+    {
+        int leader_rank = 0;
+        int leader_count = 1;
+        MPI_Comm_rank(m_leader_comm, &leader_rank);
+        MPI_Comm_size(m_leader_comm, &leader_count);
+
+        uint64_t const edge_count = m_header.edge_count;
+        uint64_t const begin = batch_offset(edge_count, leader_rank, leader_count);
+        try
+        {
+            all_read_binary_edges(input, m_header, begin, partition_batch_count(edge_count, leader_rank, leader_count), edges + begin);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        int succeeded = !error;
+        MPI_Allreduce(MPI_IN_PLACE, &succeeded, 1, MPI_INT, MPI_LAND, m_leader_comm);
+        if (!succeeded)
+        {
+            return succeeded;
+        }
+
+        typename MPIEdgeDataType<EdgeT>::type const datatype;
+        uint64_t const max_count = uint64_t(std::numeric_limits<int>::max());
+        for (int l = 0; l < leader_count; ++l)
+        {
+            uint64_t const slice_begin = batch_offset(edge_count, l, leader_count);
+            uint64_t const slice_end = slice_begin + partition_batch_count(edge_count, l, leader_count);
+            for (uint64_t b = slice_begin; b < slice_end; b += max_count)
+            {
+                MPI_Bcast(edges + b, int(std::min(max_count, slice_end - b)), datatype.get(), l, m_leader_comm);
+            }
+        }
+
+        return succeeded;
+    }
+
+    BinaryGraphHeader m_header;
+    EdgeT const* m_edges = nullptr;
+    MPI_Comm m_node_comm = MPI_COMM_NULL;
+    MPI_Comm m_leader_comm = MPI_COMM_NULL;
+    MPI_Win m_window = MPI_WIN_NULL;
+};
+
+} // namespace mpi
+} // namespace gdsb
@@ -1,14 +1,22 @@
 #pragma once
 
 #include <gdsb/batcher.h>
+#include <gdsb/edge_filter.h>
 #include <gdsb/graph_input.h>
+#include <gdsb/graph_output.h>
 #include <gdsb/mpi_error_handler.h>
 
 #include <mpi.h>
 
 #include <array>
+#include <cstring>
+#include <exception>
 #include <filesystem>
+#include <fstream>
+#include <limits>
 #include <stdexcept>
+#include <tuple>
+#include <vector>
 
 namespace gdsb
 {
@@ -40,6 +48,7 @@ inline BinaryGraphHeader read_binary_graph_header(MPI_File const input)
 
     switch (id.version)
     {
+    case binary_graph_header_version_raw_only:
     case binary_graph_header_version:
     {
         if (!std::strcmp(id.identifier, "GDSB"))
@@ -54,6 +63,12 @@ inline BinaryGraphHeader read_binary_graph_header(MPI_File const input)
             throw std::runtime_error("Could not read meta data.");
         }
 
+        if (id.version == binary_graph_header_version_raw_only)
+        {
+            meta_data.encoding = EdgeEncoding::raw;
+            meta_data.has_sections = false;
+        }
+
         return meta_data;
     }
     default:
@@ -61,8 +76,29 @@ inline BinaryGraphHeader read_binary_graph_header(MPI_File const input)
     }
 }
 
+// The MPI readers address edges by their offset within the file which is only
+// possible for raw encoded edges.
+inline void require_raw_encoding(BinaryGraphHeader const& header)
+{
+    if (header.encoding != EdgeEncoding::raw)
+    {
+        throw std::logic_error("MPI readers only support raw encoded binary graph files.");
+    }
+}
+
+//! Reads count elements of datatype into buffer collectively at the individual
+//! file pointer, also if count exceeds the maximum of the int count type of
+//! MPI_File_read_all(). Large counts are read using MPI_File_read_all_c() if
+//! the MPI library implements MPI 4, otherwise using one derived datatype
+//! composed of chunks of max_count elements (thus, every process still reads
+//! using a single collective call). Throws if less than count elements were
+//! read according to MPI_Get_count(), e.g. since the file ends early.
+void read_all(MPI_File input, void* buffer, uint64_t count, MPI_Datatype datatype, uint64_t max_count = uint64_t(std::numeric_limits<int>::max()));
+
 template <typename ReadF> bool read_binary_graph(MPI_File const input, BinaryGraphHeader const& header, ReadF&& read)
 {
+    require_raw_encoding(header);
+
     bool continue_reading = true;
     for (uint64_t e = 0; e < header.edge_count && continue_reading; ++e)
     {
@@ -80,6 +116,8 @@ std::tuple<Vertex64, uint64_t> read_binary_graph_partition(MPI_File const input,
                                                            uint32_t const partition_id,
                                                            uint32_t const partition_size)
 {
+    require_raw_encoding(data);
+
     uint64_t const edge_count = partition_batch_count(data.edge_count, partition_id, partition_size);
 
     // Header offset should be implicit since input is already read until begin of edges
@@ -112,6 +150,8 @@ std::tuple<Vertex64, uint64_t> all_read_binary_graph_partition(MPI_File const in
                                                                uint32_t const partition_id,
                                                                uint32_t const partition_size)
 {
+    require_raw_encoding(data);
+
     // Header offset should be implicit since input is already read until begin of edges
     size_t const offset = batch_offset(data.edge_count, partition_id, partition_size);
     size_t const offset_in_bytes = offset * edge_size_in_bytes;
@@ -122,14 +162,221 @@ std::tuple<Vertex64, uint64_t> all_read_binary_graph_partition(MPI_File const in
     }
 
     uint64_t const edge_count = partition_batch_count(data.edge_count, partition_id, partition_size);
-    MPI_Status status;
-    int const read_all_error = MPI_File_read_all(input, edges, edge_count, mpi_datatype, &status);
-    if (read_all_error != MPI_SUCCESS)
+    read_all(input, edges, edge_count, mpi_datatype);
+
+    return std::make_tuple(data.vertex_count, edge_count);
+}
+
+//! Reads the edges of the given vertex partition, see read_vertex_partitions().
+template <typename ReadF>
+std::tuple<Vertex64, uint64_t> read_binary_graph_partition(MPI_File const input,
+                                                           BinaryGraphHeader const& data,
+                                                           ReadF&& read,
+                                                           size_t const edge_size_in_bytes,
+                                                           VertexPartition const& partition)
+{
+    require_raw_encoding(data);
+
+    int const error = MPI_File_seek(input, partition.edge_begin * edge_size_in_bytes, MPI_SEEK_CUR);
+    if (error != MPI_SUCCESS)
+    {
+        throw std::runtime_error("Could not seek to specified offset [" + std::to_string(partition.edge_begin) +
+                                 "] within MPI file.");
+    }
+
+    bool continue_reading = true;
+    for (uint64_t e = 0; e < partition.edge_count() && continue_reading; ++e)
+    {
+        continue_reading = read(input);
+    }
+
+    return std::make_tuple(data.vertex_count, partition.edge_count());
+}
+
+//! Reads the edges of the given vertex partition collectively, see
+//! all_read_binary_graph_partition().
+template <typename Edges>
+std::tuple<Vertex64, uint64_t> all_read_binary_graph_partition(MPI_File const input,
+                                                               BinaryGraphHeader const& data,
+                                                               Edges* const edges,
+                                                               size_t const edge_size_in_bytes,
+                                                               MPI_Datatype const mpi_datatype,
+                                                               VertexPartition const& partition)
+{
+    require_raw_encoding(data);
+
+    int const seek_error = MPI_File_seek(input, partition.edge_begin * edge_size_in_bytes, MPI_SEEK_CUR);
+    if (seek_error != MPI_SUCCESS)
+    {
+        throw std::runtime_error("Could not seek to specified offset [" + std::to_string(partition.edge_begin) +
+                                 "] within MPI file.");
+    }
+
+    read_all(input, edges, partition.edge_count(), mpi_datatype);
+
+    return std::make_tuple(data.vertex_count, partition.edge_count());
+}
+
+//! Cuts the binary graph at file_path (sorted by source) into partition_count
+//! vertex partitions, see gdsb::read_vertex_partitions(). The partitions are
+//! determined by the root process and broadcast to all processes of comm.
+template <typename CostF>
+std::vector<VertexPartition> read_vertex_partitions(std::filesystem::path const& file_path,
+                                                    uint32_t const partition_count,
+                                                    CostF&& cost,
+                                                    MPI_Comm const comm = MPI_COMM_WORLD,
+                                                    int const root = 0)
+{
+    int rank = 0;
+    MPI_Comm_rank(comm, &rank);
+
+    std::vector<VertexPartition> partitions(partition_count);
+    // Exceptions of the root process are broadcast as an empty result such that
+    // no process waits for the broadcast forever.
+    int succeeded = 1;
+    if (rank == root)
+    {
+        try
+        {
+            std::ifstream input(file_path, std::ios::binary);
+            BinaryGraphHeader const header = gdsb::read_binary_graph_header(input);
+            partitions = gdsb::read_vertex_partitions(input, header, partition_count, std::forward<CostF>(cost));
+        }
+        catch (std::exception const&)
+        {
+            succeeded = 0;
+        }
+    }
+
+    MPI_Bcast(&succeeded, 1, MPI_INT, root, comm);
+    if (!succeeded)
+    {
+        throw std::runtime_error("Could not determine vertex partitions of binary graph file: " + file_path.string());
+    }
+
+    static_assert(sizeof(VertexPartition) == 4 * sizeof(uint64_t), "VertexPartition must consist of four uint64_t.");
+    MPI_Bcast(partitions.data(), int(4 * partitions.size()), MPI_UINT64_T, root, comm);
+
+    return partitions;
+}
+
+inline std::vector<VertexPartition>
+read_vertex_partitions(std::filesystem::path const& file_path, uint32_t const partition_count, MPI_Comm const comm = MPI_COMM_WORLD, int const root = 0)
+{
+    return read_vertex_partitions(
+        file_path, partition_count, [](uint64_t, Degree64 const degree) { return degree; }, comm, root);
+}
+
+//! Reads the edges of a binary graph matching the filter collectively. The
+//! root process determines the edge range holding all matching edges, see
+//! gdsb::filtered_edge_range(). The range is split evenly among the processes
+//! of comm, each reading its part block wise using MPI_File_read_at_all() and
+//! keeping the edges matching the filter, see gdsb::filter_edges(). The byte
+//! sizes of the file may differ from the edge type. Requires raw encoded
+//! edges.
+template <typename EdgeT>
+std::vector<EdgeT>
+all_read_binary_edges(std::filesystem::path const& file_path, EdgeFilter const& filter, MPI_Comm const comm = MPI_COMM_WORLD, int const root = 0)
+{
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    BinaryGraphHeader header;
+    uint64_t range[2] = { 0, 0 };
+    // Exceptions of the root process are broadcast as failure such that no
+    // process waits for the broadcast forever.
+    int succeeded = 1;
+    if (rank == root)
+    {
+        try
+        {
+            std::ifstream input(file_path, std::ios::binary);
+            header = gdsb::read_binary_graph_header(input);
+            require_raw_encoding(header);
+            check_binary_edge_type<EdgeT>(header);
+            std::tie(range[0], range[1]) = filtered_edge_range<EdgeT>(input, header, filter);
+        }
+        catch (std::exception const&)
+        {
+            succeeded = 0;
+        }
+    }
+
+    MPI_Bcast(&succeeded, 1, MPI_INT, root, comm);
+    if (!succeeded)
+    {
+        throw std::runtime_error("Could not determine the edge range to read of binary graph file: " + file_path.string());
+    }
+    MPI_Bcast(&header, int(sizeof(BinaryGraphHeader)), MPI_BYTE, root, comm);
+    MPI_Bcast(range, 2, MPI_UINT64_T, root, comm);
+    check_edge_filter<EdgeT>(filter);
+
+    MPI_File input;
+    if (MPI_File_open(comm, file_path.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &input) != MPI_SUCCESS)
+    {
+        throw std::runtime_error("Could not open file using MPI routines: " + file_path.string());
+    }
+
+    gdsb::binary::EdgeLayout const layout = gdsb::binary::edge_layout(header);
+    size_t const edge_size = layout.edge_size_in_bytes();
+    uint64_t const edges_begin = sizeof(BinaryGraphHeaderIdentifier) + sizeof(BinaryGraphHeader);
+    uint64_t const range_count = range[1] - range[0];
+    uint64_t const part_begin = range[0] + batch_offset(range_count, uint32_t(rank), uint32_t(size));
+    uint64_t const part_count = partition_batch_count(range_count, uint32_t(rank), uint32_t(size));
+
+    // The last process holds the largest part, all processes take part in as
+    // many collective reads as it needs.
+    uint64_t const block_edge_count = std::min(uint64_t(1) << 16, uint64_t(std::numeric_limits<int>::max()) / edge_size);
+    uint64_t const max_part_count = partition_batch_count(range_count, uint32_t(size - 1), uint32_t(size));
+    uint64_t const block_count = (max_part_count + block_edge_count - 1) / block_edge_count;
+
+    std::vector<EdgeT> edges;
+    std::vector<uint8_t> bytes(std::min(part_count, block_edge_count) * edge_size);
+    std::vector<EdgeT> block;
+    std::vector<uint8_t> keep;
+    bool read_failed = false;
+    // Exceptions must not skip collective reads of the remaining blocks.
+    std::exception_ptr decode_error;
+    for (uint64_t b = 0; b < block_count; ++b)
+    {
+        uint64_t const begin = std::min(part_count, b * block_edge_count);
+        uint64_t const count = std::min(part_count - begin, block_edge_count);
+
+        MPI_Status status;
+        int const error = MPI_File_read_at_all(input, MPI_Offset(edges_begin + (part_begin + begin) * edge_size), bytes.data(),
+                                               int(count * edge_size), MPI_BYTE, &status);
+        read_failed = read_failed || error != MPI_SUCCESS;
+        if (read_failed || decode_error || count == 0)
+        {
+            continue;
+        }
+
+        try
+        {
+            block.resize(count);
+            gdsb::binary::decode_edges(bytes.data(), count, layout, block.data());
+            size_t const kept = filter_edges(block.data(), block.size(), filter, keep);
+            edges.insert(edges.end(), block.begin(), block.begin() + kept);
+        }
+        catch (...)
+        {
+            decode_error = std::current_exception();
+        }
+    }
+
+    MPI_File_close(&input);
+    if (read_failed)
     {
         throw std::runtime_error("Could not successfully read all edges from MPI file.");
     }
+    if (decode_error)
+    {
+        std::rethrow_exception(decode_error);
+    }
 
-    return std::make_tuple(data.vertex_count, edge_count);
+    return edges;
 }
 
 struct ReadBatch
@@ -147,16 +394,13 @@ struct ReadBatch
 //
 // We do not read from file exceeding the edge count of 'data' (therefore, not
 // reading past EOF). Please make sure to handle 'read_batch' correctly which is
-// an in-out parameter. We set the 'read_batch.count_read_in_edges' according to
-// the edge count we could read from file.
+// an in-out parameter. We advance 'read_batch.count_read_in_edges' by the edge
+// count read, batches may exceed the int count type of MPI (see read_all()).
+// Throws if the file holds less edges than the header declares.
 template <typename Edges>
 void all_read_binary_graph_batch(MPI_File const input, BinaryGraphHeader const& data, Edges* const edges, ReadBatch& read_batch, MPI_Datatype const mpi_datatype)
 {
-    if (read_batch.batch_size > std::numeric_limits<int>::max())
-    {
-        // Have a look at the count type of MPI_File_read_all()
-        throw std::runtime_error("Count of edges exceeds MPI read count type (int) maximum.");
-    }
+    require_raw_encoding(data);
 
     if (read_batch.count_read_in_edges == data.edge_count)
     {
@@ -170,27 +414,10 @@ void all_read_binary_graph_batch(MPI_File const input, BinaryGraphHeader const&
         potential_count = data.edge_count - read_batch.count_read_in_edges;
     }
 
-    int count = static_cast<int>(potential_count);
+    // Throws if the file holds less edges than the header declares, thus
+    // count_read_in_edges is only advanced by edges actually read.
+    read_all(input, edges, potential_count, mpi_datatype);
     read_batch.count_read_in_edges += potential_count;
-
-    MPI_Status status;
-    int const read_all_error = MPI_File_read_all(input, edges, count, mpi_datatype, &status);
-    if (read_all_error != MPI_SUCCESS)
-    {
-        throw std::runtime_error("Could not successfully read all edges from MPI file.");
-    }
-
-    // It's not really clear from several MPI documentations I've read which
-    // field actually contains the number of elements read from file given the
-    // count one wants to read. The status.MPI_SOURCE field seems to
-    // surprisingly provide that data point.. However, this seems to read beyond
-    // EOF and still be equal to the requested count.
-    //
-    // Still we won't do the following since that leads to a really unclear API.
-    // return status.MPI_SOURCE == count;
-    //
-    // TODO: Find a way to check if we read exceeding EOF. Perhaps we could
-    // better model the view on the file?
 }
 
 namespace binary
@@ -208,6 +435,30 @@ bool read(MPI_File const input, gdsb::TimestampedEdge32& e);
 
 bool read(MPI_File const input, gdsb::WeightedTimestampedEdge32& e);
 
+bool read(MPI_File const input, gdsb::Edge64& e);
+
+bool read(MPI_File const input, gdsb::WeightedEdge64& e);
+
+bool read(MPI_File const input, gdsb::TimestampedEdge64& e);
+
+bool read(MPI_File const input, gdsb::WeightedTimestampedEdge64& e);
+
+//! Reads one edge stored using the given layout, e.g. the layout declared by
+//! the binary graph header, see gdsb::binary::edge_layout().
+template <typename EdgeT> bool read(MPI_File const input, gdsb::binary::EdgeLayout const& layout, EdgeT& e)
+{
+    // Two 8 byte vertex IDs, an 8 byte weight and an 8 byte timestamp at most.
+    uint8_t bytes[32];
+    int const ec = MPI_File_read(input, bytes, int(layout.edge_size_in_bytes()), MPI_BYTE, MPI_STATUS_IGNORE);
+    if (ec != MPI_SUCCESS)
+    {
+        return false;
+    }
+
+    gdsb::binary::decode_edges(bytes, 1, layout, &e);
+    return true;
+}
+
 } // namespace binary
 
 class MPIDataTypeAdapter
@@ -244,5 +495,622 @@ public:
     MPI_Datatype get() const override;
 };
 
+class MPITimestampedEdge32 : public MPIDataTypeAdapter
+{
+public:
+    MPITimestampedEdge32();
+    ~MPITimestampedEdge32() { MPI_Type_free(&m_type); }
+    MPI_Datatype get() const override;
+};
+
+class MPIEdge64 : public MPIDataTypeAdapter
+{
+public:
+    MPIEdge64();
+    ~MPIEdge64() { MPI_Type_free(&m_type); }
+    MPI_Datatype get() const override;
+};
+
+class MPIWeightedEdge64 : public MPIDataTypeAdapter
+{
+public:
+    MPIWeightedEdge64();
+    ~MPIWeightedEdge64() { MPI_Type_free(&m_type); }
+    MPI_Datatype get() const override;
+};
+
+class MPITimestampedEdge64 : public MPIDataTypeAdapter
+{
+public:
+    MPITimestampedEdge64();
+    ~MPITimestampedEdge64() { MPI_Type_free(&m_type); }
+    MPI_Datatype get() const override;
+};
+
+class MPIWeightedTimestampedEdge64 : public MPIDataTypeAdapter
+{
+public:
+    MPIWeightedTimestampedEdge64();
+    ~MPIWeightedTimestampedEdge64() { MPI_Type_free(&m_type); }
+    MPI_Datatype get() const override;
+};
+
+//! Maps an edge type of graph.h to the adapter committing its MPI datatype,
+//! e.g. MPIEdgeDataType<Edge32>::type is MPIEdge32.
+template <typename EdgeT> struct MPIEdgeDataType;
+template <> struct MPIEdgeDataType<Edge32>
+{
+    using type = MPIEdge32;
+};
+template <> struct MPIEdgeDataType<WeightedEdge32>
+{
+    using type = MPIWeightedEdge32;
+};
+template <> struct MPIEdgeDataType<TimestampedEdge32>
+{
+    using type = MPITimestampedEdge32;
+};
+template <> struct MPIEdgeDataType<WeightedTimestampedEdge32>
+{
+    using type = MPIWeightedTimestampedEdge32;
+};
+template <> struct MPIEdgeDataType<Edge64>
+{
+    using type = MPIEdge64;
+};
+template <> struct MPIEdgeDataType<WeightedEdge64>
+{
+    using type = MPIWeightedEdge64;
+};
+template <> struct MPIEdgeDataType<TimestampedEdge64>
+{
+    using type = MPITimestampedEdge64;
+};
+template <> struct MPIEdgeDataType<WeightedTimestampedEdge64>
+{
+    using type = MPIWeightedTimestampedEdge64;
+};
+
+//! Reads the edges [begin, begin + count) of a binary graph collectively,
+//! i.e. all processes of the communicator input was opened with must call
+//! this function, each passing its own range. The file view of each process
+//! is set to its range of the edge data, thus the MPI implementation may
+//! merge the requests of all processes into few large reads. If the byte
+//! sizes of the file match the edge type, the edges are read into edges using
+//! the committed datatype of the edge type, see MPIEdgeDataType. Otherwise the
+//! bytes are read and decoded, see gdsb::binary::decode_edges(). Afterwards,
+//! the view is reset to the whole file and the file pointer to its beginning.
+template <typename EdgeT>
+void all_read_binary_edges(MPI_File const input, BinaryGraphHeader const& header, uint64_t const begin, uint64_t const count, EdgeT* const edges)
+{
+    require_raw_encoding(header);
+    check_binary_edge_type<EdgeT>(header);
+
+    if (begin + count > header.edge_count)
+    {
+        throw std::out_of_range("Edge range exceeds the edge count of the binary graph.");
+    }
+
+    gdsb::binary::EdgeLayout const layout = gdsb::binary::edge_layout(header);
+    size_t const edge_size = layout.edge_size_in_bytes();
+    bool const native = layout == gdsb::binary::native_edge_layout<EdgeT>();
+
+    uint64_t const edges_begin = sizeof(BinaryGraphHeaderIdentifier) + sizeof(BinaryGraphHeader);
+    char datarep[] = "native";
+    if (MPI_File_set_view(input, MPI_Offset(edges_begin + begin * edge_size), MPI_BYTE, MPI_BYTE, datarep, MPI_INFO_NULL) != MPI_SUCCESS)
+    {
+        throw std::runtime_error("Could not set the file view to the edges to read.");
+    }
+
+    std::vector<uint8_t> bytes;
+    std::exception_ptr error;
+    try
+    {
+        if (native)
+        {
+            typename MPIEdgeDataType<EdgeT>::type const datatype;
+            read_all(input, edges, count, datatype.get());
+        }
+        else
+        {
+            bytes.resize(count * edge_size);
+            read_all(input, bytes.data(), bytes.size(), MPI_BYTE);
+        }
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+
+    MPI_File_set_view(input, 0, MPI_BYTE, MPI_BYTE, datarep, MPI_INFO_NULL);
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    if (!native)
+    {
+        gdsb::binary::decode_edges(bytes.data(), count, layout, edges);
+    }
+}
+
+//! Reads the edges of partition partition_id of partition_size partitions of
+//! equal edge count collectively, see all_read_binary_edges().
+template <typename EdgeT>
+std::vector<EdgeT>
+all_read_binary_graph_partition(MPI_File const input, BinaryGraphHeader const& header, uint32_t const partition_id, uint32_t const partition_size)
+{
+    std::vector<EdgeT> edges(partition_batch_count(header.edge_count, partition_id, partition_size));
+    all_read_binary_edges(input, header, batch_offset(header.edge_count, partition_id, partition_size), edges.size(), edges.data());
+    return edges;
+}
+
+//! Reads the edges of the given vertex partition collectively, see
+//! read_vertex_partitions() and all_read_binary_edges().
+template <typename EdgeT>
+std::vector<EdgeT> all_read_binary_graph_partition(MPI_File const input, BinaryGraphHeader const& header, VertexPartition const& partition)
+{
+    std::vector<EdgeT> edges(partition.edge_count());
+    all_read_binary_edges(input, header, partition.edge_begin, edges.size(), edges.data());
+    return edges;
+}
+
+//! Reads the edges [begin, end) of a binary graph in batches of batch_size
+//! edges using nonblocking collective reads (MPI_File_iread_at_all()), such
+//! that the following batches are read while the current one is processed,
+//! e.g. applied to the data structure under test. The prefetcher owns
+//! buffer_count buffers: the batch returned by next() occupies one of them,
+//! the reads of the following batches the others. Thus, with two buffers one
+//! read is in flight while a batch is processed.
+//!
+//! Construction and next() are collective, i.e. all processes of comm must
+//! construct a prefetcher of the file (each passing its own edge range) and
+//! call next() until it returns false. Processes with less batches than
+//! others get empty batches meanwhile. Reads use explicit offsets, assuming
+//! the default file view. Batches in the byte sizes of the file which do not
+//! match the edge type are decoded in next(), see
+//! gdsb::binary::decode_edges().
+//!
+//!   BatchPrefetcher<Edge32> batches(input.get(), header, begin, end, 1000);
+//!   while (batches.next())
+//!   {
+//!       apply(batches.edges());
+//!   }
+template <typename EdgeT> class BatchPrefetcher
+{
+public:
+    BatchPrefetcher(MPI_File const input,
+                    BinaryGraphHeader const& header,
+                    uint64_t const begin,
+                    uint64_t const end,
+                    uint64_t const batch_size,
+                    unsigned const buffer_count = 2,
+                    MPI_Comm const comm = MPI_COMM_WORLD)
+        : m_input(input)
+        , m_layout(gdsb::binary::edge_layout(header))
+        , m_native(m_layout == gdsb::binary::native_edge_layout<EdgeT>())
+        , m_begin(begin)
+        , m_end(end)
+        , m_batch_size(batch_size)
+        , m_buffers(buffer_count)
+    {
+        require_raw_encoding(header);
+        check_binary_edge_type<EdgeT>(header);
+
+        if (begin > end || end > header.edge_count)
+        {
+            throw std::out_of_range("Edge range exceeds the edge count of the binary graph.");
+        }
+        if (batch_size == 0 || buffer_count < 2)
+        {
+            throw std::invalid_argument("Batch prefetching requires a positive batch size and at least two buffers.");
+        }
+        size_t const edge_size = m_layout.edge_size_in_bytes();
+        if ((m_native ? batch_size : batch_size * edge_size) > uint64_t(std::numeric_limits<int>::max()))
+        {
+            throw std::invalid_argument("Batch size exceeds the int count type of MPI_File_iread_at_all().");
+        }
+
+        // A short file would otherwise only be noticed by some MPI libraries.
+        MPI_Offset file_size = 0;
+        MPI_File_get_size(input, &file_size);
+        if (uint64_t(file_size) < edges_begin() + end * edge_size)
+        {
+            throw std::runtime_error("Binary graph file holds less edges than the header declares.");
+        }
+
+        uint64_t const local_batch_count = (end - begin + batch_size - 1) / batch_size;
+        MPI_Allreduce(&local_batch_count, &m_batch_count, 1, MPI_UINT64_T, MPI_MAX, comm);
+
+        for (uint64_t b = 0; b < std::min(m_batch_count, uint64_t(buffer_count)); ++b)
+        {
+            issue(b);
+        }
+    }
+
+    //! Waits for the reads in flight, since they may not be cancelled.
+    ~BatchPrefetcher()
+    {
+        for (Buffer& buffer : m_buffers)
+        {
+            if (buffer.request != MPI_REQUEST_NULL)
+            {
+                MPI_Wait(&buffer.request, MPI_STATUS_IGNORE);
+            }
+        }
+    }
+
+    BatchPrefetcher(BatchPrefetcher const&) = delete;
+    BatchPrefetcher& operator=(BatchPrefetcher const&) = delete;
+
+    //! Releases the buffer of the current batch for the read of a following
+    //! batch and waits for the next batch. Returns false once all processes
+    //! returned all their batches.
+    bool next()
+    {
+        if (m_returned > 0 && m_returned - 1 + m_buffers.size() < m_batch_count)
+        {
+            issue(m_returned - 1 + m_buffers.size());
+        }
+        if (m_returned == m_batch_count)
+        {
+            m_current = nullptr;
+            return false;
+        }
+
+        Buffer& buffer = m_buffers[m_returned % m_buffers.size()];
+        MPI_Status status;
+        if (MPI_Wait(&buffer.request, &status) != MPI_SUCCESS)
+        {
+            throw std::runtime_error("Could not successfully read batch from MPI file.");
+        }
+
+        if (!m_native)
+        {
+            gdsb::binary::decode_edges(buffer.bytes.data(), buffer.edges.size(), m_layout, buffer.edges.data());
+        }
+
+        m_current = &buffer;
+        ++m_returned;
+        return true;
+    }
+
+    //! Edges of the current batch, valid until the following call of next().
+    std::vector<EdgeT>& edges()
+    {
+        if (!m_current)
+        {
+            throw std::logic_error("There is no current batch, call next() first.");
+        }
+
+        return m_current->edges;
+    }
+
+    //! Offset of the first edge of the current batch within the binary graph.
+    uint64_t offset() const { return m_current ? m_current->offset : m_end; }
+
+    //! Count of batches of the process with the most batches, i.e. how often
+    //! next() returns true.
+    uint64_t batch_count() const { return m_batch_count; }
+
+private:
+    struct Buffer
+    {
+        std::vector<EdgeT> edges;
+        // Edges as stored in the file if decoding is required.
+        std::vector<uint8_t> bytes;
+        uint64_t offset = 0;
+        MPI_Request request = MPI_REQUEST_NULL;
+    };
+
+    static uint64_t edges_begin() { return sizeof(BinaryGraphHeaderIdentifier) + sizeof(BinaryGraphHeader); }
+
+    void issue(uint64_t const batch)
+    {
+        Buffer& buffer = m_buffers[batch % m_buffers.size()];
+        buffer.offset = std::min(m_end, m_begin + batch * m_batch_size);
+        uint64_t const count = std::min(m_end, buffer.offset + m_batch_size) - buffer.offset;
+        buffer.edges.resize(count);
+
+        size_t const edge_size = m_layout.edge_size_in_bytes();
+        MPI_Offset const offset = MPI_Offset(edges_begin() + buffer.offset * edge_size);
+        int error = MPI_SUCCESS;
+        if (m_native)
+        {
+            error = MPI_File_iread_at_all(m_input, offset, buffer.edges.data(), int(count), m_datatype.get(), &buffer.request);
+        }
+        else
+        {
+            buffer.bytes.resize(count * edge_size);
+            error = MPI_File_iread_at_all(m_input, offset, buffer.bytes.data(), int(buffer.bytes.size()), MPI_BYTE, &buffer.request);
+        }
+
+        if (error != MPI_SUCCESS)
+        {
+            throw std::runtime_error("Could not start reading batch from MPI file.");
+        }
+    }
+
+    MPI_File m_input;
+    gdsb::binary::EdgeLayout m_layout;
+    bool m_native;
+    // Committed once, freed after the destructor waited for the reads.
+    typename MPIEdgeDataType<EdgeT>::type m_datatype;
+    uint64_t m_begin;
+    uint64_t m_end;
+    uint64_t m_batch_size;
+    uint64_t m_batch_count = 0;
+    // Count of batches returned by next().
+    uint64_t m_returned = 0;
+    std::vector<Buffer> m_buffers;
+    Buffer* m_current = nullptr;
+};
+
+//! Writes the edges of all processes of comm to a GDSB binary graph file
+//! collectively, the edges of process p following those of processes less
+//! than p. The offset of each process is computed using MPI_Exscan() over the
+//! local edge counts, the root process writes the header and all processes
+//! write their edges block wise using MPI_File_write_at_all(). Thus, no
+//! process holds more than its own edges. Output must be opened by all
+//! processes of comm for writing, see FileWrapper, and is truncated to the
+//! written graph. Vertex IDs and timestamps use the narrowest byte sizes
+//! sufficient for the edges of all processes if narrow_widths is set, the
+//! default as for BinaryWriteOptions, see
+//! gdsb::binary::narrowest_edge_layout(). Edges are raw encoded and no
+//! sections are written. Returns the statistics of the whole graph.
+template <typename GraphParameters, typename EdgeT>
+BinaryWriteStatistics all_write_binary_graph(MPI_File const output,
+                                             std::vector<EdgeT> const& edges,
+                                             uint64_t const vertex_count,
+                                             bool const narrow_widths = true,
+                                             MPI_Comm const comm = MPI_COMM_WORLD,
+                                             int const root = 0)
+{
+    using Traits = EdgeTraits<EdgeT>;
+    static_assert(GraphParameters::is_weighted() == Traits::is_weighted(), "Edge type must match graph parameters.");
+    static_assert(GraphParameters::is_dynamic() == Traits::is_dynamic(), "Edge type must match graph parameters.");
+
+    int rank = 0;
+    MPI_Comm_rank(comm, &rank);
+
+    gdsb::binary::EdgeLayout layout = gdsb::binary::native_edge_layout<EdgeT>();
+    if (narrow_widths)
+    {
+        gdsb::binary::EdgeLayout const local = gdsb::binary::narrowest_edge_layout(edges.data(), edges.size(), vertex_count);
+        std::array<int, 2> byte_sizes{ local.vertex_id_byte_size, local.timestamp_byte_size };
+        MPI_Allreduce(MPI_IN_PLACE, byte_sizes.data(), int(byte_sizes.size()), MPI_INT, MPI_MAX, comm);
+        layout.vertex_id_byte_size = uint8_t(byte_sizes[0]);
+        layout.timestamp_byte_size = uint8_t(byte_sizes[1]);
+    }
+    size_t const edge_size = layout.edge_size_in_bytes();
+
+    uint64_t const local_count = edges.size();
+    uint64_t offset = 0;
+    MPI_Exscan(&local_count, &offset, 1, MPI_UINT64_T, MPI_SUM, comm);
+    if (rank == 0)
+    {
+        // The receive buffer of the first process is undefined.
+        offset = 0;
+    }
+    uint64_t edge_count = 0;
+    MPI_Allreduce(&local_count, &edge_count, 1, MPI_UINT64_T, MPI_SUM, comm);
+
+    uint64_t const edges_begin = sizeof(BinaryGraphHeaderIdentifier) + sizeof(BinaryGraphHeader);
+    if (MPI_File_set_size(output, MPI_Offset(edges_begin + edge_count * edge_size)) != MPI_SUCCESS)
+    {
+        throw std::runtime_error("Could not set the size of the MPI file.");
+    }
+
+    int header_error = MPI_SUCCESS;
+    if (rank == root)
+    {
+        BinaryGraphHeader header;
+        header.vertex_count = vertex_count;
+        header.edge_count = edge_count;
+        header.vertex_id_byte_size = layout.vertex_id_byte_size;
+        header.weight_byte_size = layout.weight_byte_size;
+        header.timestamp_byte_size = layout.timestamp_byte_size;
+        header.directed = GraphParameters::is_directed();
+        header.weighted = GraphParameters::is_weighted();
+        header.dynamic = GraphParameters::is_dynamic();
+        header.encoding = EdgeEncoding::raw;
+        header.has_sections = false;
+
+        BinaryGraphHeaderIdentifier const header_id;
+        MPI_Status status;
+        header_error = MPI_File_write_at(output, 0, &header_id, sizeof(BinaryGraphHeaderIdentifier), MPI_BYTE, &status);
+        if (header_error == MPI_SUCCESS)
+        {
+            header_error =
+                MPI_File_write_at(output, sizeof(BinaryGraphHeaderIdentifier), &header, sizeof(BinaryGraphHeader), MPI_BYTE, &status);
+        }
+    }
+
+    // All processes must write the same count of blocks collectively, the
+    // last ones of processes with less edges are empty.
+    uint64_t const block_edge_count = uint64_t(1) << 16;
+    uint64_t const local_block_count = (local_count + block_edge_count - 1) / block_edge_count;
+    uint64_t block_count = 0;
+    MPI_Allreduce(&local_block_count, &block_count, 1, MPI_UINT64_T, MPI_MAX, comm);
+
+    std::vector<uint8_t> block(std::min(local_count, block_edge_count) * edge_size);
+    bool write_error = false;
+    for (uint64_t b = 0; b < block_count; ++b)
+    {
+        uint64_t const begin = std::min(local_count, b * block_edge_count);
+        uint64_t const count = std::min(local_count - begin, block_edge_count);
+        gdsb::binary::encode_edges(edges.data() + begin, count, layout, block.data());
+
+        MPI_Status status;
+        MPI_Offset const file_offset = MPI_Offset(edges_begin + (offset + begin) * edge_size);
+        write_error = MPI_File_write_at_all(output, file_offset, block.data(), int(count * edge_size), MPI_BYTE, &status) != MPI_SUCCESS ||
+            write_error;
+    }
+
+    // Errors are only thrown once all processes issued the collective calls.
+    if (header_error != MPI_SUCCESS || write_error)
+    {
+        throw std::runtime_error("Could not successfully write all edges to MPI file.");
+    }
+
+    BinaryWriteStatistics statistics;
+    statistics.edge_count = edge_count;
+    statistics.edge_bytes = edge_count * edge_size;
+    return statistics;
+}
+
+//! Reads the text file at file_path collectively: each process of comm reads
+//! an equal byte range using MPI I/O and owns the lines starting within its
+//! range. The bytes of a line crossing the end of the range (up to the first
+//! line start of a following process) are exchanged among the processes.
+//! Returns the owned lines, each terminated by a newline.
+std::vector<char> all_read_text_lines(std::filesystem::path const& file_path, MPI_Comm comm = MPI_COMM_WORLD);
+
+//! Reads an edge list or Matrix Market text graph collectively, e.g. to skip
+//! the conversion to a binary graph on a single node. Each process reads its
+//! byte range, see all_read_text_lines(), parses its lines using OpenMP
+//! threads and appends the edges to edges in file order, thus the edges of
+//! process p follow those of processes less than p. Lines are parsed as by
+//! read_graph() of GraphParameters, except that comment lines are skipped
+//! anywhere in the file. Returns the vertex count (largest vertex ID plus one)
+//! and the edge count of the whole graph, reduced over all processes.
+template <typename GraphParameters, typename EdgeT>
+std::tuple<Vertex64, uint64_t> all_read_graph(std::filesystem::path const& file_path, std::vector<EdgeT>& edges, MPI_Comm const comm = MPI_COMM_WORLD)
+{
+    using Traits = EdgeTraits<EdgeT>;
+    static_assert(GraphParameters::filetype() != FileType::binary, "Use the binary graph readers for binary graphs.");
+    static_assert(GraphParameters::is_weighted() == Traits::is_weighted(), "Edge type must match graph parameters.");
+    static_assert(GraphParameters::is_dynamic() == Traits::is_dynamic(), "Edge type must match graph parameters.");
+
+    std::vector<char> lines = all_read_text_lines(file_path, comm);
+    size_t const lines_end = lines.size();
+
+    auto const next_line = [&](size_t const line) -> size_t
+    { return size_t(static_cast<char const*>(std::memchr(lines.data() + line, '\n', lines_end - line)) - lines.data()) + 1; };
+    auto const is_edge_line = [&](size_t const line)
+    { return lines[line] != '\n' && lines[line] != '%' && lines[line] != '#'; };
+
+    size_t lines_begin = 0;
+    if constexpr (GraphParameters::filetype() == FileType::matrix_market)
+    {
+        // The first line following the comments holds the matrix dimensions.
+        size_t line = 0;
+        while (line < lines_end && !is_edge_line(line))
+        {
+            line = next_line(line);
+        }
+
+        int const has_edge_line = line < lines_end;
+        int previous_has_edge_line = 0;
+        MPI_Exscan(&has_edge_line, &previous_has_edge_line, 1, MPI_INT, MPI_LOR, comm);
+        int rank = 0;
+        MPI_Comm_rank(comm, &rank);
+        if (has_edge_line && (rank == 0 || !previous_has_edge_line))
+        {
+            lines_begin = next_line(line);
+        }
+    }
+
+    // Each thread parses the lines starting within its equal slice.
+    int const thread_count = omp_get_max_threads();
+    std::vector<size_t> slice_begins(thread_count + 1, lines_end);
+    slice_begins[0] = lines_begin;
+    for (int i = 1; i < thread_count; ++i)
+    {
+        size_t begin = std::max(lines_begin, batch_offset(lines_end, i, thread_count));
+        begin = begin > lines_begin && begin < lines_end && lines[begin - 1] != '\n' ? std::min(lines_end, next_line(begin)) : begin;
+        slice_begins[i] = std::max(slice_begins[i - 1], begin);
+    }
+
+    std::vector<std::vector<EdgeT>> slices(thread_count);
+    std::vector<uint64_t> max_vertices(thread_count, 0);
+    std::vector<uint64_t> edge_counts(thread_count, 0);
+
+#pragma omp parallel for schedule(static, 1)
+    for (int i = 0; i < thread_count; ++i)
+    {
+        std::vector<EdgeT>& slice = slices[i];
+        auto const emplace = [&](unsigned long const u, unsigned long const v, float const w, unsigned long const t)
+        {
+            EdgeT e{};
+            Traits::source(e) = typename Traits::Vertex(u);
+            Traits::target(e) = typename Traits::Vertex(v);
+            Traits::set_weight(e, typename Traits::Weight(w));
+            Traits::set_timestamp(e, typename Traits::Timestamp(t));
+            slice.push_back(e);
+        };
+
+        uint64_t max_vertex = 0;
+        for (size_t line = slice_begins[i]; line < slice_begins[i + 1];)
+        {
+            size_t const end = next_line(line);
+            if (!is_edge_line(line))
+            {
+                line = end;
+                continue;
+            }
+
+            // Terminates the line such that parsing stops at its end.
+            lines[end - 1] = '\0';
+            char* position = nullptr;
+            unsigned long const u = read_ulong(lines.data() + line, &position);
+            unsigned long const v = read_ulong(position, &position);
+            max_vertex = std::max(max_vertex, uint64_t(std::max(u, v)));
+            line = end;
+
+            if constexpr (!GraphParameters::loop())
+            {
+                if (u == v)
+                {
+                    continue;
+                }
+            }
+
+            float w = 1.f;
+            unsigned long t = 0;
+            if constexpr (GraphParameters::is_weighted())
+            {
+                w = read_float(position, &position);
+            }
+            if constexpr (GraphParameters::is_dynamic())
+            {
+                t = read_ulong(position, &position);
+            }
+
+            emplace(u, v, w, t);
+            if constexpr (!GraphParameters::is_directed())
+            {
+                if (u != v)
+                {
+                    emplace(v, u, w, t);
+                }
+            }
+        }
+
+        max_vertices[i] = max_vertex;
+        edge_counts[i] = slice.size();
+    }
+
+    std::vector<uint64_t> offsets(thread_count + 1, edges.size());
+    for (int i = 0; i < thread_count; ++i)
+    {
+        offsets[i + 1] = offsets[i] + edge_counts[i];
+    }
+    edges.resize(offsets.back());
+
+#pragma omp parallel for schedule(static, 1)
+    for (int i = 0; i < thread_count; ++i)
+    {
+        std::copy(slices[i].begin(), slices[i].end(), edges.begin() + offsets[i]);
+    }
+
+    uint64_t max_vertex = *std::max_element(max_vertices.begin(), max_vertices.end());
+    uint64_t edge_count = offsets.back() - offsets.front();
+    MPI_Allreduce(MPI_IN_PLACE, &max_vertex, 1, MPI_UINT64_T, MPI_MAX, comm);
+    MPI_Allreduce(MPI_IN_PLACE, &edge_count, 1, MPI_UINT64_T, MPI_SUM, comm);
+
+    return { Vertex64(max_vertex + 1), edge_count };
+}
+
 } // namespace mpi
 } // namespace gdsb
\ No newline at end of file
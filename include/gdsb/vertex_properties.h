@@ -0,0 +1,165 @@
+#pragma once
+
+//! This file contains typed per-vertex property columns, e.g. vertex labels
+//! or integer and floating point attributes, stored as sections of GDSB
+//! binary graph files. Each column is one vertex_property section:
+//! - VertexPropertyHeader (name, value type, value count)
+//! - the values in native byte order, 8 byte aligned
+//! Since the values are not encoded, the columns of a memory mapped file are
+//! used in place without parsing or copying, see MappedVertexProperties.
+
+#include <gdsb/graph_input.h>
+#include <gdsb/graph_io_parameters.h>
+#include <gdsb/graph_sections.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace gdsb
+{
+
+enum class VertexPropertyType : uint8_t
+{
+    unsigned_integer = 0,
+    signed_integer = 1,
+    floating_point = 2
+};
+
+struct VertexPropertyHeader
+{
+    // Zero terminated name of the property.
+    char name[32] = {};
+    uint64_t count = 0;
+    VertexPropertyType type = VertexPropertyType::unsigned_integer;
+    uint8_t byte_size = 0;
+    uint8_t reserved[6] = {};
+};
+
+static_assert(sizeof(VertexPropertyHeader) == 48u, "The vertex property header layout must not change.");
+
+template <typename T> constexpr VertexPropertyType vertex_property_type()
+{
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "Vertex properties must be integers or floating point values.");
+
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        return VertexPropertyType::floating_point;
+    }
+    else if constexpr (std::is_signed_v<T>)
+    {
+        return VertexPropertyType::signed_integer;
+    }
+    else
+    {
+        return VertexPropertyType::unsigned_integer;
+    }
+}
+
+//! Returns a section holding the property name (at most 31 characters) where
+//! values[v] is the property of vertex v. Pass the section to write_graph()
+//! using BinaryWriteOptions::sections.
+template <typename T> BinaryGraphSection make_vertex_property_section(std::string const& name, std::vector<T> const& values)
+{
+    if (name.empty() || name.size() >= sizeof(VertexPropertyHeader::name))
+    {
+        throw std::invalid_argument("Vertex property name must have 1 to 31 characters: " + name);
+    }
+
+    VertexPropertyHeader header;
+    std::memcpy(header.name, name.data(), name.size());
+    header.count = values.size();
+    header.type = vertex_property_type<T>();
+    header.byte_size = sizeof(T);
+
+    BinaryGraphSection section;
+    section.type = SectionType::vertex_property;
+    section.data.resize(sizeof(VertexPropertyHeader) + values.size() * sizeof(T));
+    std::memcpy(section.data.data(), &header, sizeof(VertexPropertyHeader));
+    std::memcpy(section.data.data() + sizeof(VertexPropertyHeader), values.data(), values.size() * sizeof(T));
+    return section;
+}
+
+//! Returns the headers of all vertex property columns written along with the
+//! graph. The position of input is restored afterwards.
+std::vector<VertexPropertyHeader> read_vertex_property_headers(std::istream& input, BinaryGraphHeader const& header);
+
+//! Returns the data of the vertex property section name, starting with its
+//! header. Throws if there is no such column or if its type does not match.
+std::vector<uint8_t>
+read_vertex_property_section(std::istream& input, BinaryGraphHeader const& header, std::string const& name, VertexPropertyType type, uint8_t byte_size);
+
+//! Reads the vertex property column name into a vector, see
+//! MappedVertexProperties to avoid the copy.
+template <typename T>
+std::vector<T> read_vertex_property(std::istream& input, BinaryGraphHeader const& header, std::string const& name)
+{
+    std::vector<uint8_t> const data = read_vertex_property_section(input, header, name, vertex_property_type<T>(), sizeof(T));
+
+    VertexPropertyHeader property_header;
+    std::memcpy(&property_header, data.data(), sizeof(VertexPropertyHeader));
+
+    std::vector<T> values(property_header.count);
+    std::memcpy(values.data(), data.data() + sizeof(VertexPropertyHeader), values.size() * sizeof(T));
+    return values;
+}
+
+//! Values of a vertex property column in place, valid as long as the
+//! MappedVertexProperties it was taken from.
+template <typename T> class VertexPropertyColumn
+{
+public:
+    VertexPropertyColumn() = default;
+    VertexPropertyColumn(T const* const data, uint64_t const size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    T const* data() const { return m_data; }
+    uint64_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    T const& operator[](uint64_t const vertex) const { return m_data[vertex]; }
+
+    T const* begin() const { return m_data; }
+    T const* end() const { return m_data + m_size; }
+
+private:
+    T const* m_data = nullptr;
+    uint64_t m_size = 0;
+};
+
+//! Maps a binary graph file to access its vertex property columns without
+//! reading or copying them.
+class MappedVertexProperties
+{
+public:
+    explicit MappedVertexProperties(std::filesystem::path const& file_path);
+
+    std::vector<std::string> names() const;
+    bool contains(std::string const& name) const;
+
+    //! Returns the column name, throws if there is no such column or if T
+    //! does not match its type.
+    template <typename T> VertexPropertyColumn<T> column(std::string const& name) const
+    {
+        VertexPropertyHeader const& header = find(name, vertex_property_type<T>(), sizeof(T));
+        uint8_t const* const data = reinterpret_cast<uint8_t const*>(&header) + sizeof(VertexPropertyHeader);
+        return VertexPropertyColumn<T>(reinterpret_cast<T const*>(data), header.count);
+    }
+
+private:
+    VertexPropertyHeader const& find(std::string const& name, VertexPropertyType type, uint8_t byte_size) const;
+
+    MappedFile m_file;
+    // Headers of the columns within the mapped file.
+    std::vector<VertexPropertyHeader const*> m_columns;
+};
+
+} // namespace gdsb
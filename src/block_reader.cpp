@@ -0,0 +1,628 @@
+#include <gdsb/block_reader.h>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define GDSB_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
+namespace gdsb
+{
+
+namespace
+{
+
+[[noreturn]] void throw_errno(std::string const& what, int const error)
+{
+    throw std::runtime_error(what + ": " + std::strerror(error));
+}
+
+struct FreeDeleter
+{
+    void operator()(uint8_t* const p) const { std::free(p); }
+};
+
+using Buffer = std::unique_ptr<uint8_t, FreeDeleter>;
+
+Buffer allocate_buffer(size_t const size)
+{
+    void* p = nullptr;
+    if (::posix_memalign(&p, direct_io_alignment, std::max(size, direct_io_alignment)) != 0)
+    {
+        throw std::bad_alloc();
+    }
+
+    return Buffer(static_cast<uint8_t*>(p));
+}
+
+#ifdef GDSB_IO_URING
+// Minimal io_uring submission and completion queue using the raw system calls,
+// thus there is no dependency on liburing. Used by a single thread.
+class IoUring
+{
+public:
+    //! Returns nullptr if io_uring is not available, e.g. due to an old kernel
+    //! or if it is disabled by a seccomp filter, or if it does not support the
+    //! read operations.
+    static std::unique_ptr<IoUring> create(unsigned const entries)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        int const fd = int(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+
+        std::unique_ptr<IoUring> ring(new IoUring(fd));
+        if (!ring->map(params) || !ring->supports_reads())
+        {
+            return nullptr;
+        }
+
+        return ring;
+    }
+
+    ~IoUring()
+    {
+        if (m_sqes) ::munmap(m_sqes, m_sqes_size);
+        if (m_cq_ring && m_cq_ring != m_sq_ring) ::munmap(m_cq_ring, m_cq_ring_size);
+        if (m_sq_ring) ::munmap(m_sq_ring, m_sq_ring_size);
+        ::close(m_fd);
+    }
+
+    //! Registers the buffers such that reads avoid mapping them per request.
+    //! Returns false if registering fails, e.g. due to RLIMIT_MEMLOCK.
+    bool register_buffers(std::vector<iovec> const& buffers)
+    {
+        if (m_registered)
+        {
+            ::syscall(__NR_io_uring_register, m_fd, IORING_UNREGISTER_BUFFERS, nullptr, 0u);
+        }
+        m_registered = ::syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS, buffers.data(), unsigned(buffers.size())) == 0;
+        return m_registered;
+    }
+
+    //! Queues a read of size bytes at offset into buffer buffer_index.
+    void prepare_read(int const fd, uint8_t* const buffer, unsigned const buffer_index, unsigned const size, uint64_t const offset, uint64_t const user_data)
+    {
+        unsigned const tail = *m_sq_tail;
+        unsigned const index = tail & *m_sq_mask;
+        io_uring_sqe& sqe = m_sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = m_registered ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(buffer);
+        sqe.len = size;
+        sqe.off = offset;
+        sqe.buf_index = m_registered ? uint16_t(buffer_index) : 0;
+        sqe.user_data = user_data;
+
+        m_sq_array[index] = index;
+        __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+        ++m_unsubmitted;
+    }
+
+    //! Submits all queued reads and waits for at least wait_count completions.
+    void submit_and_wait(unsigned const wait_count)
+    {
+        while (true)
+        {
+            long const ret = ::syscall(__NR_io_uring_enter, m_fd, m_unsubmitted, wait_count,
+                                       wait_count > 0 ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+            if (ret >= 0)
+            {
+                m_unsubmitted -= unsigned(ret);
+                return;
+            }
+            if (errno != EINTR)
+            {
+                throw_errno("io_uring_enter failed", errno);
+            }
+        }
+    }
+
+    bool pop(io_uring_cqe& cqe)
+    {
+        unsigned const head = *m_cq_head;
+        if (head == __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE))
+        {
+            return false;
+        }
+
+        cqe = m_cqes[head & *m_cq_mask];
+        __atomic_store_n(m_cq_head, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+private:
+    // Kernels 5.1 to 5.5 set up rings but reject IORING_OP_READ. The probe was
+    // introduced along with IORING_OP_READ, thus a failing probe means no
+    // support either.
+    bool supports_reads() const
+    {
+        unsigned constexpr op_count = 256;
+        std::vector<uint8_t> memory(sizeof(io_uring_probe) + op_count * sizeof(io_uring_probe_op), 0);
+        io_uring_probe* const probe = reinterpret_cast<io_uring_probe*>(memory.data());
+        if (::syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PROBE, probe, op_count) != 0)
+        {
+            return false;
+        }
+
+        auto supported = [&](unsigned const op)
+        { return op <= probe->last_op && op < probe->ops_len && (probe->ops[op].flags & IO_URING_OP_SUPPORTED); };
+        return supported(IORING_OP_READ) && supported(IORING_OP_READ_FIXED);
+    }
+
+    explicit IoUring(int const fd)
+        : m_fd(fd)
+    {
+    }
+
+    bool map(io_uring_params const& params)
+    {
+        m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool const single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap)
+        {
+            m_sq_ring_size = m_cq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+        }
+
+        m_sq_ring = map_region(m_sq_ring_size, IORING_OFF_SQ_RING);
+        m_cq_ring = single_mmap ? m_sq_ring : map_region(m_cq_ring_size, IORING_OFF_CQ_RING);
+        m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        m_sqes = static_cast<io_uring_sqe*>(map_region(m_sqes_size, IORING_OFF_SQES));
+        if (!m_sq_ring || !m_cq_ring || !m_sqes)
+        {
+            return false;
+        }
+
+        uint8_t* const sq = static_cast<uint8_t*>(m_sq_ring);
+        m_sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        m_sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        m_sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        uint8_t* const cq = static_cast<uint8_t*>(m_cq_ring);
+        m_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        m_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        m_cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        return true;
+    }
+
+    void* map_region(size_t const size, off_t const offset)
+    {
+        void* const p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, offset);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    int m_fd;
+    bool m_registered = false;
+    unsigned m_unsubmitted = 0;
+
+    void* m_sq_ring = nullptr;
+    void* m_cq_ring = nullptr;
+    size_t m_sq_ring_size = 0;
+    size_t m_cq_ring_size = 0;
+    io_uring_sqe* m_sqes = nullptr;
+    size_t m_sqes_size = 0;
+
+    unsigned* m_sq_tail = nullptr;
+    unsigned* m_sq_mask = nullptr;
+    unsigned* m_sq_array = nullptr;
+    unsigned* m_cq_head = nullptr;
+    unsigned* m_cq_tail = nullptr;
+    unsigned* m_cq_mask = nullptr;
+    io_uring_cqe* m_cqes = nullptr;
+};
+#endif
+
+uint64_t align_down(uint64_t const offset) { return offset / direct_io_alignment * direct_io_alignment; }
+
+uint64_t align_up(uint64_t const offset) { return align_down(offset + direct_io_alignment - 1); }
+
+// Reads up to size bytes at offset, retrying short reads until at least
+// minimum_size bytes are read. Direct reads may end short at the end of file.
+void pread_all(int const fd, uint8_t* const data, size_t const size, uint64_t const offset, size_t const minimum_size)
+{
+    size_t done = 0;
+    while (done < minimum_size)
+    {
+        ssize_t const ret = ::pread(fd, data + done, size - done, off_t(offset + done));
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw_errno("Could not read file", errno);
+        }
+        if (ret == 0)
+        {
+            throw std::runtime_error("Unexpected end of file.");
+        }
+
+        done += size_t(ret);
+    }
+}
+
+} // namespace
+
+// A block of the requested range and the range actually read, which is
+// aligned for direct reads.
+struct Block
+{
+    uint64_t offset = 0;
+    size_t size = 0;
+    uint64_t read_offset = 0;
+    size_t read_size = 0;
+
+    // Bytes at least to read to cover the block.
+    size_t minimum_read_size() const { return size_t(offset + size - read_offset); }
+};
+
+struct BlockReader::Implementation
+{
+    int fd = -1;
+    bool direct = false;
+    BlockReaderOptions options;
+    BlockReaderBackend backend = BlockReaderBackend::pread;
+#ifdef GDSB_IO_URING
+    std::unique_ptr<IoUring> ring;
+#endif
+
+    // One buffer per read in flight plus one per thread processing a block.
+    std::vector<Buffer> buffers;
+    size_t buffer_size = 0;
+    std::vector<unsigned> free_buffers;
+    std::mutex free_buffers_mutex;
+
+    std::exception_ptr error;
+    std::atomic<bool> failed{ false };
+
+    void allocate(size_t const size, unsigned const count)
+    {
+        if (size <= buffer_size && count <= buffers.size())
+        {
+            return;
+        }
+
+        buffer_size = std::max(size, buffer_size);
+        buffers.clear();
+        for (unsigned b = 0; b < count; ++b)
+        {
+            buffers.push_back(allocate_buffer(buffer_size));
+        }
+
+#ifdef GDSB_IO_URING
+        if (ring)
+        {
+            std::vector<iovec> iovecs(count);
+            for (unsigned b = 0; b < count; ++b)
+            {
+                iovecs[b].iov_base = buffers[b].get();
+                iovecs[b].iov_len = buffer_size;
+            }
+            ring->register_buffers(iovecs);
+        }
+#endif
+    }
+
+    bool acquire(unsigned& buffer)
+    {
+        std::lock_guard<std::mutex> lock(free_buffers_mutex);
+        if (free_buffers.empty())
+        {
+            return false;
+        }
+
+        buffer = free_buffers.back();
+        free_buffers.pop_back();
+        return true;
+    }
+
+    void release(unsigned const buffer)
+    {
+        std::lock_guard<std::mutex> lock(free_buffers_mutex);
+        free_buffers.push_back(buffer);
+    }
+
+    void fail()
+    {
+#pragma omp critical
+        error = std::current_exception();
+        failed = true;
+    }
+
+    void process(BlockF const& f, unsigned const buffer, Block const& block)
+    {
+        try
+        {
+            if (!failed)
+            {
+                f(block.offset, buffers[buffer].get() + (block.offset - block.read_offset), block.size);
+            }
+        }
+        catch (...)
+        {
+            fail();
+        }
+        release(buffer);
+
+        if (options.drop_page_cache && !direct)
+        {
+            uint64_t const drop_begin = align_down(block.offset);
+            ::posix_fadvise(fd, off_t(drop_begin), off_t(align_up(block.offset + block.size) - drop_begin), POSIX_FADV_DONTNEED);
+        }
+    }
+};
+
+BlockReader::BlockReader(std::filesystem::path const& file_path, BlockReaderOptions const& options)
+    : m_implementation(std::make_unique<Implementation>())
+{
+    Implementation& impl = *m_implementation;
+    impl.options = options;
+    impl.options.queue_depth = std::max(1u, options.queue_depth);
+
+    if (options.direct)
+    {
+        impl.fd = ::open(file_path.c_str(), O_RDONLY | O_DIRECT);
+        impl.direct = impl.fd >= 0;
+        if (!impl.direct && errno == EINVAL)
+        {
+            impl.options.drop_page_cache = true;
+        }
+    }
+    if (impl.fd < 0)
+    {
+        impl.fd = ::open(file_path.c_str(), O_RDONLY);
+    }
+    if (impl.fd < 0)
+    {
+        throw_errno("Could not open file: " + file_path.string(), errno);
+    }
+
+#ifdef GDSB_IO_URING
+    if (options.backend != BlockReaderBackend::pread)
+    {
+        impl.ring = IoUring::create(impl.options.queue_depth);
+        if (impl.ring)
+        {
+            impl.backend = BlockReaderBackend::io_uring;
+        }
+    }
+#endif
+
+    if (options.backend == BlockReaderBackend::io_uring && impl.backend != BlockReaderBackend::io_uring)
+    {
+        ::close(impl.fd);
+        throw std::runtime_error("io_uring is not available.");
+    }
+}
+
+BlockReader::~BlockReader()
+{
+    if (m_implementation->fd >= 0)
+    {
+        ::close(m_implementation->fd);
+    }
+}
+
+BlockReaderBackend BlockReader::backend() const { return m_implementation->backend; }
+
+bool BlockReader::direct() const { return m_implementation->direct; }
+
+void BlockReader::read(uint64_t const begin, uint64_t const end, size_t const unit, BlockF const& f)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+    if (unit == 0)
+    {
+        throw std::invalid_argument("Block unit must be greater than zero.");
+    }
+
+    Implementation& impl = *m_implementation;
+    size_t const block_size = std::max(unit, impl.options.block_size / unit * unit);
+    uint64_t const block_count = (end - begin + block_size - 1) / block_size;
+    unsigned const buffer_count = impl.options.queue_depth + unsigned(omp_get_max_threads());
+    // Aligning a block may add up to one alignment unit at either end.
+    impl.allocate(impl.direct ? align_up(block_size) + 2 * direct_io_alignment : block_size, buffer_count);
+
+    if (!impl.direct)
+    {
+        ::posix_fadvise(impl.fd, off_t(begin), off_t(end - begin), POSIX_FADV_SEQUENTIAL);
+    }
+
+    impl.free_buffers.clear();
+    for (unsigned b = 0; b < buffer_count; ++b)
+    {
+        impl.free_buffers.push_back(b);
+    }
+    impl.error = nullptr;
+    impl.failed = false;
+
+    auto make_block = [&](uint64_t const index)
+    {
+        Block block;
+        block.offset = begin + index * block_size;
+        block.size = size_t(std::min(end, block.offset + block_size) - block.offset);
+        block.read_offset = impl.direct ? align_down(block.offset) : block.offset;
+        block.read_size = size_t((impl.direct ? align_up(block.offset + block.size) : block.offset + block.size) - block.read_offset);
+        return block;
+    };
+
+#pragma omp parallel
+#pragma omp single
+    {
+        try
+        {
+            uint64_t next_block = 0;
+
+#ifdef GDSB_IO_URING
+            if (impl.ring)
+            {
+                // Block and bytes read so far of each buffer in flight.
+                std::vector<Block> buffer_block(buffer_count);
+                std::vector<size_t> buffer_done(buffer_count, 0);
+                unsigned in_flight = 0;
+
+                auto submit = [&](unsigned const b)
+                {
+                    Block const& block = buffer_block[b];
+                    impl.ring->prepare_read(impl.fd, impl.buffers[b].get() + buffer_done[b], b, unsigned(block.read_size - buffer_done[b]),
+                                            block.read_offset + buffer_done[b], b);
+                };
+
+                // Reads must not complete into buffers after returning.
+                auto drain = [&]()
+                {
+                    io_uring_cqe cqe;
+                    while (in_flight > 0)
+                    {
+                        impl.ring->submit_and_wait(1);
+                        while (impl.ring->pop(cqe))
+                        {
+                            --in_flight;
+                        }
+                    }
+                };
+
+                // Cleared if the kernel rejects the reads, the remaining blocks
+                // are read using pread() then.
+                bool use_ring = true;
+
+                try
+                {
+                    while (((use_ring && next_block < block_count) || in_flight > 0) && !impl.failed)
+                    {
+                        unsigned b = 0;
+                        while (use_ring && next_block < block_count && in_flight < impl.options.queue_depth && impl.acquire(b))
+                        {
+                            buffer_block[b] = make_block(next_block++);
+                            buffer_done[b] = 0;
+                            submit(b);
+                            ++in_flight;
+                        }
+
+                        if (in_flight == 0)
+                        {
+                            // All buffers are held by blocks being processed.
+#pragma omp taskwait
+                            continue;
+                        }
+
+                        impl.ring->submit_and_wait(1);
+
+                        io_uring_cqe cqe;
+                        while (impl.ring->pop(cqe))
+                        {
+                            unsigned const c = unsigned(cqe.user_data);
+                            --in_flight;
+                            if (cqe.res == -EINVAL)
+                            {
+                                // Read the rest of the block using pread(),
+                                // which throws if the request itself is invalid.
+                                use_ring = false;
+                                Block const block = buffer_block[c];
+                                pread_all(impl.fd, impl.buffers[c].get() + buffer_done[c], block.read_size - buffer_done[c],
+                                          block.read_offset + buffer_done[c], block.minimum_read_size() - buffer_done[c]);
+#pragma omp task firstprivate(c, block)
+                                impl.process(f, c, block);
+                                continue;
+                            }
+                            if (cqe.res < 0)
+                            {
+                                throw_errno("Could not read file", -cqe.res);
+                            }
+                            if (cqe.res == 0)
+                            {
+                                throw std::runtime_error("Unexpected end of file.");
+                            }
+
+                            buffer_done[c] += size_t(cqe.res);
+                            Block const block = buffer_block[c];
+                            if (buffer_done[c] < block.minimum_read_size())
+                            {
+                                // Short read, read the rest of the block.
+                                submit(c);
+                                ++in_flight;
+                                continue;
+                            }
+
+#pragma omp task firstprivate(c, block)
+                            impl.process(f, c, block);
+                        }
+                    }
+                }
+                catch (...)
+                {
+                    impl.fail();
+                }
+                drain();
+
+                if (!use_ring)
+                {
+                    impl.ring.reset();
+                    impl.backend = BlockReaderBackend::pread;
+                }
+            }
+#endif
+
+            for (; next_block < block_count && !impl.failed; ++next_block)
+            {
+                unsigned b = 0;
+                while (!impl.acquire(b))
+                {
+#pragma omp taskwait
+                }
+
+                Block const block = make_block(next_block);
+#pragma omp task firstprivate(b, block)
+                {
+                    try
+                    {
+                        pread_all(impl.fd, impl.buffers[b].get(), block.read_size, block.read_offset, block.minimum_read_size());
+                    }
+                    catch (...)
+                    {
+                        impl.fail();
+                    }
+                    impl.process(f, b, block);
+                }
+            }
+        }
+        catch (...)
+        {
+            impl.fail();
+        }
+    }
+
+    if (impl.error)
+    {
+        std::rethrow_exception(impl.error);
+    }
+}
+
+} // namespace gdsb
@@ -0,0 +1,75 @@
+#include <gdsb/graph_cache.h>
+
+#include <chrono>
+#include <cstdio>
+#include <system_error>
+
+#include <unistd.h>
+
+namespace gdsb
+{
+
+namespace
+{
+
+// 64 bit FNV-1a hash.
+uint64_t hash_bytes(void const* const data, size_t const size, uint64_t hash = 14695981039346656037ull)
+{
+    uint8_t const* const bytes = static_cast<uint8_t const*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+template <typename T> uint64_t hash_value(T const& value, uint64_t const hash) { return hash_bytes(&value, sizeof(T), hash); }
+
+} // namespace
+
+std::filesystem::path
+graph_cache_path(std::filesystem::path const& cache_directory, std::filesystem::path const& graph_path, GraphCacheParameters const& parameters)
+{
+    if (!std::filesystem::exists(graph_path))
+    {
+        throw std::runtime_error("Path to graph does not exist!");
+    }
+
+    std::string const absolute_path = std::filesystem::canonical(graph_path).string();
+    uint64_t const size = std::filesystem::file_size(graph_path);
+    int64_t const modified = std::filesystem::last_write_time(graph_path).time_since_epoch().count();
+
+    uint64_t hash = hash_bytes(absolute_path.data(), absolute_path.size());
+    hash = hash_value(size, hash);
+    hash = hash_value(modified, hash);
+    hash = hash_value(uint8_t(parameters.file_type), hash);
+    hash = hash_value(uint8_t(parameters.directed), hash);
+    hash = hash_value(uint8_t(parameters.weighted), hash);
+    hash = hash_value(uint8_t(parameters.dynamic), hash);
+    hash = hash_value(uint8_t(parameters.loop), hash);
+    hash = hash_value(parameters.edge_count_max, hash);
+    // Invalidates cache files of older binary graph versions.
+    hash = hash_value(binary_graph_header_version, hash);
+
+    char key[17];
+    std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+
+    return cache_directory / (graph_path.filename().string() + "." + key + ".bin");
+}
+
+std::filesystem::path default_graph_cache_directory()
+{
+    char const* const directory = std::getenv(graph_cache_directory_variable);
+    return directory ? std::filesystem::path(directory) : std::filesystem::path{};
+}
+
+std::filesystem::path temporary_graph_cache_path(std::filesystem::path const& cache_path)
+{
+    std::filesystem::path path = cache_path;
+    path += ".tmp." + std::to_string(::getpid());
+    return path;
+}
+
+} // namespace gdsb
@@ -0,0 +1,384 @@
+#include <gdsb/graph_compression.h>
+
+#include <array>
+#include <climits>
+#include <string>
+
+#ifdef GDSB_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef GDSB_ZSTD
+#include <zstd.h>
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define GDSB_STREAM_VBYTE_SSSE3
+#include <immintrin.h>
+#endif
+
+namespace gdsb
+{
+
+namespace stream_vbyte
+{
+
+namespace
+{
+
+// Each control byte describes the byte lengths (1 to 4) of a group of four
+// integers using two bits per integer.
+uint8_t byte_length(uint32_t const value)
+{
+    if (value < (1u << 8)) return 1;
+    if (value < (1u << 16)) return 2;
+    if (value < (1u << 24)) return 3;
+    return 4;
+}
+
+uint8_t control_length(uint8_t const control, size_t const idx) { return ((control >> (2 * idx)) & 3u) + 1; }
+
+size_t control_bytes_count(size_t const count) { return (count + 3) / 4; }
+
+struct DecodeTables
+{
+    // Shuffle masks to scatter the bytes of a group to four 32 bit lanes.
+    std::array<std::array<uint8_t, 16>, 256> shuffle;
+    // Total data byte length of a group.
+    std::array<uint8_t, 256> length;
+
+    DecodeTables()
+    {
+        for (size_t control = 0; control < 256; ++control)
+        {
+            uint8_t offset = 0;
+            for (size_t idx = 0; idx < 4; ++idx)
+            {
+                uint8_t const l = control_length(uint8_t(control), idx);
+                for (uint8_t b = 0; b < 4; ++b)
+                {
+                    // 0x80 zeroes the lane byte using pshufb
+                    shuffle[control][4 * idx + b] = b < l ? uint8_t(offset + b) : uint8_t(0x80);
+                }
+                offset += l;
+            }
+            length[control] = offset;
+        }
+    }
+};
+
+DecodeTables const& decode_tables()
+{
+    static DecodeTables const tables;
+    return tables;
+}
+
+// Decodes integers [begin, count) reading the data bytes starting at data.
+// Returns the position after the last consumed data byte.
+uint8_t const* decode_scalar(
+    uint8_t const* const control, uint8_t const* data, uint8_t const* const in_end, size_t const begin, size_t const count, uint32_t* const values)
+{
+    for (size_t i = begin; i < count; ++i)
+    {
+        uint8_t const l = control_length(control[i / 4], i % 4);
+        if (data + l > in_end)
+        {
+            throw std::runtime_error("Stream VByte input is truncated.");
+        }
+
+        uint32_t value = 0;
+        for (uint8_t b = 0; b < l; ++b)
+        {
+            value |= uint32_t(data[b]) << (8 * b);
+        }
+        values[i] = value;
+        data += l;
+    }
+
+    return data;
+}
+
+#ifdef GDSB_STREAM_VBYTE_SSSE3
+__attribute__((target("ssse3"))) uint8_t const* decode_ssse3(
+    uint8_t const* const control, uint8_t const* data, uint8_t const* const in_end, size_t const count, uint32_t* const values)
+{
+    DecodeTables const& tables = decode_tables();
+
+    size_t const full_groups = count / 4;
+    size_t group = 0;
+    for (; group < full_groups && data + 16 <= in_end; ++group)
+    {
+        uint8_t const c = control[group];
+        __m128i const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data));
+        __m128i const mask = _mm_loadu_si128(reinterpret_cast<__m128i const*>(tables.shuffle[c].data()));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values + 4 * group), _mm_shuffle_epi8(bytes, mask));
+        data += tables.length[c];
+    }
+
+    return decode_scalar(control, data, in_end, 4 * group, count, values);
+}
+
+bool has_ssse3()
+{
+    static bool const supported = __builtin_cpu_supports("ssse3");
+    return supported;
+}
+#endif
+
+} // namespace
+
+size_t max_encoded_size(size_t const count) { return control_bytes_count(count) + 4 * count; }
+
+size_t encode(uint32_t const* const values, size_t const count, uint8_t* const out)
+{
+    uint8_t* const control = out;
+    uint8_t* data = out + control_bytes_count(count);
+    std::fill(control, data, uint8_t(0));
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t const value = values[i];
+        uint8_t const l = byte_length(value);
+        control[i / 4] |= uint8_t((l - 1) << (2 * (i % 4)));
+        for (uint8_t b = 0; b < l; ++b)
+        {
+            data[b] = uint8_t(value >> (8 * b));
+        }
+        data += l;
+    }
+
+    return data - out;
+}
+
+size_t decode(uint8_t const* const in, uint8_t const* const in_end, size_t const count, uint32_t* const values)
+{
+    uint8_t const* const control = in;
+    uint8_t const* const data = in + control_bytes_count(count);
+    if (data > in_end)
+    {
+        throw std::runtime_error("Stream VByte input is truncated.");
+    }
+
+#ifdef GDSB_STREAM_VBYTE_SSSE3
+    if (has_ssse3())
+    {
+        return decode_ssse3(control, data, in_end, count, values) - in;
+    }
+#endif
+
+    return decode_scalar(control, data, in_end, 0, count, values) - in;
+}
+
+} // namespace stream_vbyte
+
+namespace block_codec
+{
+
+namespace
+{
+
+[[noreturn]] void throw_unsupported(EdgeEncoding const encoding)
+{
+    throw std::logic_error("GDSB has not been built with support for block codec: " + std::to_string(int(encoding)));
+}
+
+#ifdef GDSB_LZ4
+int lz4_size(size_t const size)
+{
+    if (size > size_t(LZ4_MAX_INPUT_SIZE))
+    {
+        throw std::out_of_range("Chunk exceeds the maximum LZ4 input size, use a smaller chunk edge count.");
+    }
+
+    return int(size);
+}
+#endif
+
+} // namespace
+
+bool supported(EdgeEncoding const encoding)
+{
+    switch (encoding)
+    {
+#ifdef GDSB_LZ4
+    case EdgeEncoding::lz4:
+        return true;
+#endif
+#ifdef GDSB_ZSTD
+    case EdgeEncoding::zstd:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+size_t max_compressed_size(EdgeEncoding const encoding, [[maybe_unused]] size_t const size)
+{
+    switch (encoding)
+    {
+#ifdef GDSB_LZ4
+    case EdgeEncoding::lz4:
+        return size_t(LZ4_compressBound(lz4_size(size)));
+#endif
+#ifdef GDSB_ZSTD
+    case EdgeEncoding::zstd:
+        return ZSTD_compressBound(size);
+#endif
+    default:
+        throw_unsupported(encoding);
+    }
+}
+
+size_t compress(EdgeEncoding const encoding,
+                [[maybe_unused]] uint8_t const* const src,
+                [[maybe_unused]] size_t const size,
+                [[maybe_unused]] uint8_t* const dst,
+                [[maybe_unused]] size_t const capacity,
+                [[maybe_unused]] int const level)
+{
+    switch (encoding)
+    {
+#ifdef GDSB_LZ4
+    case EdgeEncoding::lz4:
+    {
+        int const compressed_size = LZ4_compress_default(reinterpret_cast<char const*>(src), reinterpret_cast<char*>(dst),
+                                                         lz4_size(size), int(std::min(capacity, size_t(INT_MAX))));
+        if (compressed_size <= 0)
+        {
+            throw std::runtime_error("LZ4 compression failed.");
+        }
+
+        return size_t(compressed_size);
+    }
+#endif
+#ifdef GDSB_ZSTD
+    case EdgeEncoding::zstd:
+    {
+        size_t const compressed_size = ZSTD_compress(dst, capacity, src, size, level);
+        if (ZSTD_isError(compressed_size))
+        {
+            throw std::runtime_error(std::string("Zstandard compression failed: ") + ZSTD_getErrorName(compressed_size));
+        }
+
+        return compressed_size;
+    }
+#endif
+    default:
+        throw_unsupported(encoding);
+    }
+}
+
+void decompress(EdgeEncoding const encoding,
+                [[maybe_unused]] uint8_t const* const src,
+                [[maybe_unused]] size_t const size,
+                [[maybe_unused]] uint8_t* const dst,
+                [[maybe_unused]] size_t const decompressed_size)
+{
+    switch (encoding)
+    {
+#ifdef GDSB_LZ4
+    case EdgeEncoding::lz4:
+    {
+        int const read_size = LZ4_decompress_safe(reinterpret_cast<char const*>(src), reinterpret_cast<char*>(dst),
+                                                  lz4_size(size), lz4_size(decompressed_size));
+        if (read_size < 0 || size_t(read_size) != decompressed_size)
+        {
+            throw std::runtime_error("LZ4 decompression failed.");
+        }
+
+        return;
+    }
+#endif
+#ifdef GDSB_ZSTD
+    case EdgeEncoding::zstd:
+    {
+        size_t const read_size = ZSTD_decompress(dst, decompressed_size, src, size);
+        if (ZSTD_isError(read_size) || read_size != decompressed_size)
+        {
+            throw std::runtime_error("Zstandard decompression failed.");
+        }
+
+        return;
+    }
+#endif
+    default:
+        throw_unsupported(encoding);
+    }
+}
+
+} // namespace block_codec
+
+void write_chunk_directory(std::ostream& output, EdgeChunkDirectory const& directory)
+{
+    uint64_t const chunk_count = directory.chunk_count();
+    output.write(reinterpret_cast<char const*>(&directory.chunk_edge_count), sizeof(uint64_t));
+    output.write(reinterpret_cast<char const*>(&chunk_count), sizeof(uint64_t));
+    output.write(reinterpret_cast<char const*>(directory.offsets.data()), directory.offsets.size() * sizeof(uint64_t));
+}
+
+namespace
+{
+
+// Count of bytes from the current position to the end of input, the maximum
+// value if input can not be positioned.
+uint64_t remaining_bytes(std::istream& input)
+{
+    std::streampos const position = input.tellg();
+    if (position == std::streampos(-1))
+    {
+        return std::numeric_limits<uint64_t>::max();
+    }
+
+    input.seekg(0, std::ios::end);
+    std::streampos const end = input.tellg();
+    input.seekg(position);
+    if (end == std::streampos(-1) || end < position)
+    {
+        return std::numeric_limits<uint64_t>::max();
+    }
+
+    return uint64_t(end - position);
+}
+
+} // namespace
+
+EdgeChunkDirectory read_chunk_directory(std::istream& input)
+{
+    EdgeChunkDirectory directory;
+    uint64_t chunk_count = 0;
+    input.read(reinterpret_cast<char*>(&directory.chunk_edge_count), sizeof(uint64_t));
+    input.read(reinterpret_cast<char*>(&chunk_count), sizeof(uint64_t));
+    if (!input || directory.chunk_edge_count == 0)
+    {
+        throw std::runtime_error("Could not read chunk directory.");
+    }
+
+    if (chunk_count >= remaining_bytes(input) / sizeof(uint64_t))
+    {
+        throw std::runtime_error("Chunk directory exceeds the binary graph file.");
+    }
+
+    directory.offsets.resize(chunk_count + 1);
+    input.read(reinterpret_cast<char*>(directory.offsets.data()), directory.offsets.size() * sizeof(uint64_t));
+    if (!input)
+    {
+        throw std::runtime_error("Could not read chunk directory.");
+    }
+
+    // Offsets index into the edge data, a corrupt directory must not lead to
+    // reads before the first or past the last chunk.
+    if (directory.offsets.front() != 0 || !std::is_sorted(directory.offsets.begin(), directory.offsets.end()))
+    {
+        throw std::runtime_error("Chunk directory offsets are not non-decreasing from zero.");
+    }
+
+    if (directory.offsets.back() > remaining_bytes(input))
+    {
+        throw std::runtime_error("Chunk directory offsets exceed the binary graph file.");
+    }
+
+    return directory;
+}
+
+} // namespace gdsb
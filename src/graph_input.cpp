@@ -1,12 +1,18 @@
 #include <gdsb/graph_input.h>
 
 #include <cstdlib>
+#include <cstring>
 #include <limits>
 #include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-#if !defined(__clang__)
 #include <cerrno>
-#endif
 
 namespace gdsb
 {
@@ -80,6 +86,95 @@ void read(std::ifstream& input, gdsb::WeightedTimestampedEdge32& e)
     input.read(reinterpret_cast<char*>(&e.timestamp), sizeof(Timestamp32));
 }
 
+void read(std::ifstream& input, Edge64& e)
+{
+    input.read(reinterpret_cast<char*>(&e.source), sizeof(Vertex64));
+    input.read(reinterpret_cast<char*>(&e.target), sizeof(Vertex64));
+}
+
+void read(std::ifstream& input, gdsb::WeightedEdge64& e)
+{
+    input.read(reinterpret_cast<char*>(&e.source), sizeof(Vertex64));
+    input.read(reinterpret_cast<char*>(&e.target.vertex), sizeof(Vertex64));
+    input.read(reinterpret_cast<char*>(&e.target.weight), sizeof(Weight));
+}
+
+void read(std::ifstream& input, gdsb::TimestampedEdge64& e)
+{
+    input.read(reinterpret_cast<char*>(&e.edge.source), sizeof(Vertex64));
+    input.read(reinterpret_cast<char*>(&e.edge.target), sizeof(Vertex64));
+    input.read(reinterpret_cast<char*>(&e.timestamp), sizeof(Timestamp64));
+}
+
+void read(std::ifstream& input, gdsb::WeightedTimestampedEdge64& e)
+{
+    input.read(reinterpret_cast<char*>(&e.edge.source), sizeof(Vertex64));
+    input.read(reinterpret_cast<char*>(&e.edge.target.vertex), sizeof(Vertex64));
+    input.read(reinterpret_cast<char*>(&e.edge.target.weight), sizeof(Weight));
+    input.read(reinterpret_cast<char*>(&e.timestamp), sizeof(Timestamp64));
+}
+
 } // namespace binary
 
+MappedFile::MappedFile(std::filesystem::path const& file_path)
+{
+    int const fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Could not open file: " + file_path.string() + ": " + std::strerror(errno));
+    }
+
+    struct stat status;
+    if (::fstat(fd, &status) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Could not stat file: " + file_path.string() + ": " + std::strerror(errno));
+    }
+
+    m_size = size_t(status.st_size);
+    if (m_size > 0)
+    {
+        m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m_data == MAP_FAILED)
+        {
+            m_data = nullptr;
+            ::close(fd);
+            throw std::runtime_error("Could not map file: " + file_path.string() + ": " + std::strerror(errno));
+        }
+        ::madvise(m_data, m_size, MADV_SEQUENTIAL);
+    }
+
+    // The mapping remains valid after closing the file descriptor.
+    ::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+    {
+        ::munmap(m_data, m_size);
+    }
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_data)
+        {
+            ::munmap(m_data, m_size);
+        }
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+
+    return *this;
+}
+
 } // namespace gdsb
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include <gdsb/graph_log.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace gdsb
+{
+
+namespace
+{
+
+char const* const segment_prefix = "segment_";
+char const* const base_prefix = "base_";
+char const* const file_suffix = ".bin";
+
+std::string file_name(char const* const prefix, uint64_t const sequence)
+{
+    // Zero padded such that the file names sort by sequence.
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s%020llu%s", prefix, static_cast<unsigned long long>(sequence), file_suffix);
+    return name;
+}
+
+// Returns true and sets sequence if name is a file name of the given prefix.
+bool parse_file_name(std::string const& name, char const* const prefix, uint64_t& sequence)
+{
+    size_t const prefix_length = std::strlen(prefix);
+    size_t const suffix_length = std::strlen(file_suffix);
+    if (name.size() != prefix_length + 20 + suffix_length || name.compare(0, prefix_length, prefix) != 0 ||
+        name.compare(name.size() - suffix_length, suffix_length, file_suffix) != 0)
+    {
+        return false;
+    }
+
+    std::string const digits = name.substr(prefix_length, 20);
+    if (digits.find_first_not_of("0123456789") != std::string::npos)
+    {
+        return false;
+    }
+
+    sequence = std::stoull(digits);
+    return true;
+}
+
+} // namespace
+
+std::filesystem::path segment_path(std::filesystem::path const& directory, uint64_t const sequence)
+{
+    return directory / file_name(segment_prefix, sequence);
+}
+
+std::filesystem::path base_path(std::filesystem::path const& directory, uint64_t const sequence)
+{
+    return directory / file_name(base_prefix, sequence);
+}
+
+SegmentHeader read_segment_header(std::istream& input)
+{
+    SegmentHeader header;
+    input.read(reinterpret_cast<char*>(&header), sizeof(SegmentHeader));
+    if (!input)
+    {
+        throw std::runtime_error("Could not read segment header.");
+    }
+
+    SegmentHeader const expected;
+    if (std::memcmp(header.identifier, expected.identifier, sizeof(header.identifier)) != 0 || header.version != expected.version)
+    {
+        throw std::runtime_error("Segment identifier or version is not supported.");
+    }
+
+    return header;
+}
+
+std::vector<SegmentFile> list_segments(std::filesystem::path const& directory, uint64_t const after, uint64_t const until)
+{
+    std::vector<SegmentFile> segments;
+    for (std::filesystem::directory_entry const& entry : std::filesystem::directory_iterator(directory))
+    {
+        uint64_t sequence = 0;
+        if (!entry.is_regular_file() || !parse_file_name(entry.path().filename().string(), segment_prefix, sequence) ||
+            sequence <= after || sequence > until)
+        {
+            continue;
+        }
+
+        std::ifstream input(entry.path(), std::ios::binary);
+        SegmentFile segment{ entry.path(), read_segment_header(input) };
+        if (segment.header.sequence != sequence)
+        {
+            throw std::runtime_error("Segment sequence does not match its file name: " + entry.path().string());
+        }
+        segments.push_back(std::move(segment));
+    }
+
+    std::sort(std::begin(segments), std::end(segments),
+              [](SegmentFile const& a, SegmentFile const& b) { return a.header.sequence < b.header.sequence; });
+
+    return segments;
+}
+
+std::pair<std::filesystem::path, uint64_t> latest_base(std::filesystem::path const& directory)
+{
+    std::pair<std::filesystem::path, uint64_t> base{ std::filesystem::path{}, 0u };
+    for (std::filesystem::directory_entry const& entry : std::filesystem::directory_iterator(directory))
+    {
+        uint64_t sequence = 0;
+        if (entry.is_regular_file() && parse_file_name(entry.path().filename().string(), base_prefix, sequence) &&
+            (base.first.empty() || sequence > base.second))
+        {
+            base = { entry.path(), sequence };
+        }
+    }
+
+    return base;
+}
+
+} // namespace gdsb
@@ -0,0 +1,46 @@
+#include <gdsb/graph_output.h>
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace gdsb
+{
+
+ParallelFileWriter::ParallelFileWriter(std::filesystem::path const& file_path)
+    : m_fd(::open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644))
+{
+    if (m_fd < 0)
+    {
+        throw std::runtime_error("Could not open file for writing: " + file_path.string() + ": " + std::strerror(errno));
+    }
+}
+
+ParallelFileWriter::~ParallelFileWriter() { ::close(m_fd); }
+
+void ParallelFileWriter::write(void const* const data, size_t const size, uint64_t const offset) const
+{
+    char const* bytes = static_cast<char const*>(data);
+    size_t written = 0;
+    while (written < size)
+    {
+        ssize_t const ret = ::pwrite(m_fd, bytes + written, size - written, off_t(offset + written));
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            throw std::runtime_error(std::string("Could not write to file: ") + std::strerror(errno));
+        }
+
+        written += size_t(ret);
+    }
+}
+
+} // namespace gdsb
@@ -0,0 +1,229 @@
+#include <gdsb/graph_sections.h>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace gdsb
+{
+
+namespace
+{
+
+uint64_t align_section(uint64_t const offset) { return (offset + 7u) & ~uint64_t(7u); }
+
+void append(std::vector<uint8_t>& bytes, void const* const data, size_t const size)
+{
+    uint8_t const* const begin = static_cast<uint8_t const*>(data);
+    bytes.insert(std::end(bytes), begin, begin + size);
+}
+
+// Restores the position (and state) of the input stream on destruction.
+class StreamPositionGuard
+{
+public:
+    explicit StreamPositionGuard(std::istream& input)
+        : m_input(input)
+        , m_position(input.tellg())
+    {
+    }
+
+    ~StreamPositionGuard()
+    {
+        m_input.clear();
+        m_input.seekg(m_position);
+    }
+
+private:
+    std::istream& m_input;
+    std::streampos m_position;
+};
+
+} // namespace
+
+std::vector<uint8_t> serialize_sections(std::vector<BinaryGraphSection> const& sections, uint64_t const begin)
+{
+    std::vector<uint8_t> bytes;
+    std::vector<SectionEntry> table;
+
+    for (BinaryGraphSection const& section : sections)
+    {
+        bytes.resize(align_section(begin + bytes.size()) - begin, 0u);
+
+        SectionEntry entry;
+        entry.type = section.type;
+        entry.offset = begin + bytes.size();
+        entry.size = section.data.size();
+        table.push_back(entry);
+
+        append(bytes, section.data.data(), section.data.size());
+    }
+
+    bytes.resize(align_section(begin + bytes.size()) - begin, 0u);
+
+    SectionFooter footer;
+    footer.table_offset = begin + bytes.size();
+    footer.section_count = table.size();
+
+    append(bytes, table.data(), table.size() * sizeof(SectionEntry));
+    append(bytes, &footer, sizeof(SectionFooter));
+
+    return bytes;
+}
+
+std::vector<SectionEntry> read_section_table(std::istream& input)
+{
+    StreamPositionGuard const guard(input);
+
+    SectionFooter footer;
+    input.seekg(-std::streamoff(sizeof(SectionFooter)), std::ios_base::end);
+    input.read(reinterpret_cast<char*>(&footer), sizeof(SectionFooter));
+    if (!input || std::memcmp(footer.magic, SectionFooter{}.magic, sizeof(footer.magic)) != 0)
+    {
+        throw std::runtime_error("Could not read section footer of binary graph file.");
+    }
+
+    std::vector<SectionEntry> table(footer.section_count);
+    input.seekg(std::streamoff(footer.table_offset));
+    input.read(reinterpret_cast<char*>(table.data()), table.size() * sizeof(SectionEntry));
+    if (!input)
+    {
+        throw std::runtime_error("Could not read section table of binary graph file.");
+    }
+
+    return table;
+}
+
+std::optional<SectionEntry> find_section(std::vector<SectionEntry> const& table, SectionType const type)
+{
+    auto const it = std::find_if(std::begin(table), std::end(table), [&](SectionEntry const& e) { return e.type == type; });
+    if (it == std::end(table))
+    {
+        return std::nullopt;
+    }
+
+    return *it;
+}
+
+std::vector<uint8_t> read_section(std::istream& input, SectionEntry const& entry)
+{
+    StreamPositionGuard const guard(input);
+
+    std::vector<uint8_t> data(entry.size);
+    input.seekg(std::streamoff(entry.offset));
+    input.read(reinterpret_cast<char*>(data.data()), data.size());
+    if (!input)
+    {
+        throw std::runtime_error("Could not read section of binary graph file.");
+    }
+
+    return data;
+}
+
+std::vector<BinaryGraphSection> make_statistics_sections(BinaryGraphStatistics statistics, std::vector<Degree64> const& degrees)
+{
+    std::vector<BinaryGraphSection> sections;
+
+    if (!degrees.empty())
+    {
+        statistics.degree_byte_size = binary::byte_width(statistics.max_degree);
+
+        BinaryGraphSection degrees_section;
+        degrees_section.type = SectionType::degrees;
+        degrees_section.data.resize(degrees.size() * statistics.degree_byte_size);
+        binary::encode_uint_field(statistics.degree_byte_size, degrees_section.data.data(), statistics.degree_byte_size,
+                                  degrees.size(), [&](size_t i) { return degrees[i]; });
+        sections.push_back(std::move(degrees_section));
+    }
+
+    BinaryGraphSection statistics_section;
+    statistics_section.type = SectionType::statistics;
+    statistics_section.data.resize(sizeof(BinaryGraphStatistics));
+    std::memcpy(statistics_section.data.data(), &statistics, sizeof(BinaryGraphStatistics));
+    sections.insert(std::begin(sections), std::move(statistics_section));
+
+    return sections;
+}
+
+std::optional<BinaryGraphStatistics> read_binary_graph_statistics(std::istream& input, BinaryGraphHeader const& header)
+{
+    if (!header.has_sections)
+    {
+        return std::nullopt;
+    }
+
+    std::optional<SectionEntry> const entry = find_section(read_section_table(input), SectionType::statistics);
+    if (!entry)
+    {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> const data = read_section(input, *entry);
+    if (data.size() < sizeof(BinaryGraphStatistics))
+    {
+        throw std::runtime_error("Statistics section of binary graph file is truncated.");
+    }
+
+    BinaryGraphStatistics statistics;
+    std::memcpy(&statistics, data.data(), sizeof(BinaryGraphStatistics));
+    return statistics;
+}
+
+std::vector<Degree64> read_binary_graph_degrees(std::istream& input, BinaryGraphHeader const& header)
+{
+    std::optional<BinaryGraphStatistics> const statistics = read_binary_graph_statistics(input, header);
+    if (!statistics || statistics->degree_byte_size == 0)
+    {
+        return {};
+    }
+
+    std::optional<SectionEntry> const entry = find_section(read_section_table(input), SectionType::degrees);
+    if (!entry)
+    {
+        throw std::runtime_error("Binary graph file has no degrees section.");
+    }
+
+    std::vector<uint8_t> const data = read_section(input, *entry);
+    uint8_t const width = statistics->degree_byte_size;
+    std::vector<Degree64> degrees(data.size() / width);
+    binary::decode_uint_field(width, data.data(), width, degrees.size(), [&](size_t i, uint64_t d) { degrees[i] = d; });
+
+    return degrees;
+}
+
+BinaryGraphSection make_timestamp_index_section(TimestampIndex const& index)
+{
+    BinaryGraphSection section;
+    section.type = SectionType::timestamp_index;
+    section.data.resize(sizeof(uint64_t) * (1 + index.timestamps.size()));
+    std::memcpy(section.data.data(), &index.stride, sizeof(uint64_t));
+    std::memcpy(section.data.data() + sizeof(uint64_t), index.timestamps.data(), sizeof(uint64_t) * index.timestamps.size());
+    return section;
+}
+
+std::optional<TimestampIndex> read_timestamp_index(std::istream& input, BinaryGraphHeader const& header)
+{
+    if (!header.has_sections)
+    {
+        return std::nullopt;
+    }
+
+    std::optional<SectionEntry> const entry = find_section(read_section_table(input), SectionType::timestamp_index);
+    if (!entry)
+    {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> const data = read_section(input, *entry);
+    if (data.size() < sizeof(uint64_t) || data.size() % sizeof(uint64_t) != 0)
+    {
+        throw std::runtime_error("Timestamp index section of binary graph file is corrupt.");
+    }
+
+    TimestampIndex index;
+    std::memcpy(&index.stride, data.data(), sizeof(uint64_t));
+    index.timestamps.resize(data.size() / sizeof(uint64_t) - 1);
+    std::memcpy(index.timestamps.data(), data.data() + sizeof(uint64_t), sizeof(uint64_t) * index.timestamps.size());
+    return index;
+}
+
+} // namespace gdsb
@@ -0,0 +1,185 @@
+#include <gdsb/mpi_distribution.h>
+
+#include <cstring>
+
+namespace gdsb
+{
+namespace mpi
+{
+
+RangeOwner::RangeOwner(std::vector<uint64_t> vertex_begins)
+    : m_vertex_begins(std::move(vertex_begins))
+{
+    if (m_vertex_begins.empty() || m_vertex_begins.front() != 0 || !std::is_sorted(m_vertex_begins.begin(), m_vertex_begins.end()))
+    {
+        throw std::invalid_argument("Vertex ranges must start at vertex 0 and must not decrease.");
+    }
+}
+
+namespace
+{
+
+int grid_rows(int const process_count)
+{
+    int rows = 1;
+    for (int r = 1; r * r <= process_count; ++r)
+    {
+        if (process_count % r == 0)
+        {
+            rows = r;
+        }
+    }
+    return rows;
+}
+
+int comm_size(MPI_Comm const comm)
+{
+    int size = 1;
+    MPI_Comm_size(comm, &size);
+    return size;
+}
+
+} // namespace
+
+ProcessGrid::ProcessGrid(uint64_t const vertex_count, MPI_Comm const comm)
+    : m_rows(grid_rows(comm_size(comm)))
+    , m_columns(comm_size(comm) / m_rows)
+    , m_row_owner(vertex_count, m_rows)
+    , m_column_owner(vertex_count, m_columns)
+{
+    int rank = 0;
+    MPI_Comm_rank(comm, &rank);
+    m_row = rank / m_columns;
+    m_column = rank % m_columns;
+
+    if (MPI_Comm_split(comm, m_row, m_column, &m_row_comm) != MPI_SUCCESS ||
+        MPI_Comm_split(comm, m_column, m_row, &m_column_comm) != MPI_SUCCESS)
+    {
+        throw std::runtime_error("Could not create the row and column communicators of the process grid.");
+    }
+}
+
+ProcessGrid::~ProcessGrid()
+{
+    if (m_row_comm != MPI_COMM_NULL)
+    {
+        MPI_Comm_free(&m_row_comm);
+    }
+    if (m_column_comm != MPI_COMM_NULL)
+    {
+        MPI_Comm_free(&m_column_comm);
+    }
+}
+
+void alltoallv(void const* const send,
+               std::vector<uint64_t> const& send_counts,
+               std::vector<uint64_t> const& send_displacements,
+               void* const receive,
+               std::vector<uint64_t> const& receive_counts,
+               std::vector<uint64_t> const& receive_displacements,
+               MPI_Datatype const datatype,
+               MPI_Comm const comm,
+               uint64_t const max_count)
+{
+    int size = 1;
+    MPI_Comm_size(comm, &size);
+
+    uint64_t const send_total = send_displacements.back() + send_counts.back();
+    uint64_t const receive_total = receive_displacements.back() + receive_counts.back();
+    int fits = int(send_total <= max_count && receive_total <= max_count);
+    MPI_Allreduce(MPI_IN_PLACE, &fits, 1, MPI_INT, MPI_LAND, comm);
+
+    if (fits)
+    {
+        std::vector<int> const sc(send_counts.begin(), send_counts.end());
+        std::vector<int> const sd(send_displacements.begin(), send_displacements.end());
+        std::vector<int> const rc(receive_counts.begin(), receive_counts.end());
+        std::vector<int> const rd(receive_displacements.begin(), receive_displacements.end());
+        if (MPI_Alltoallv(send, sc.data(), sd.data(), datatype, receive, rc.data(), rd.data(), datatype, comm) != MPI_SUCCESS)
+        {
+            throw std::runtime_error("Could not exchange elements among MPI processes.");
+        }
+        return;
+    }
+
+#if MPI_VERSION >= 4
+    std::vector<MPI_Count> const sc(send_counts.begin(), send_counts.end());
+    std::vector<MPI_Aint> const sd(send_displacements.begin(), send_displacements.end());
+    std::vector<MPI_Count> const rc(receive_counts.begin(), receive_counts.end());
+    std::vector<MPI_Aint> const rd(receive_displacements.begin(), receive_displacements.end());
+    if (MPI_Alltoallv_c(send, sc.data(), sd.data(), datatype, receive, rc.data(), rd.data(), datatype, comm) != MPI_SUCCESS)
+    {
+        throw std::runtime_error("Could not exchange elements among MPI processes.");
+    }
+#else
+    MPI_Aint lower_bound = 0;
+    MPI_Aint extent = 0;
+    MPI_Type_get_extent(datatype, &lower_bound, &extent);
+
+    // In each round at most chunk elements are exchanged per pair of
+    // processes. The elements are described by derived datatypes at their
+    // absolute addresses, thus they are sent from send and received into
+    // receive directly without staging buffers.
+    uint64_t const chunk = std::max(uint64_t(1), max_count / uint64_t(size));
+    uint64_t rounds = 0;
+    for (int p = 0; p < size; ++p)
+    {
+        rounds = std::max(rounds, (std::max(send_counts[p], receive_counts[p]) + chunk - 1) / chunk);
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &rounds, 1, MPI_UINT64_T, MPI_MAX, comm);
+
+    std::vector<int> sc(size);
+    std::vector<int> rc(size);
+    std::vector<int> const zero_displacements(size, 0);
+    std::vector<MPI_Datatype> send_types(size, datatype);
+    std::vector<MPI_Datatype> receive_types(size, datatype);
+    std::vector<MPI_Datatype> created;
+
+    // Returns the count of derived datatypes (0 or 1) describing the elements
+    // [begin, begin + count) of buffer, stored to type.
+    auto const describe = [&](void const* const buffer, uint64_t const begin, int const count, MPI_Datatype& type)
+    {
+        if (count == 0)
+        {
+            type = datatype;
+            return 0;
+        }
+
+        MPI_Aint address = 0;
+        MPI_Get_address(static_cast<uint8_t const*>(buffer) + begin * uint64_t(extent), &address);
+        MPI_Type_create_hindexed(1, &count, &address, datatype, &type);
+        MPI_Type_commit(&type);
+        created.push_back(type);
+        return 1;
+    };
+
+    auto const round_count = [&](uint64_t const count, uint64_t const round)
+    { return int(std::min(chunk, count - std::min(count, round * chunk))); };
+
+    for (uint64_t round = 0; round < rounds; ++round)
+    {
+        for (int p = 0; p < size; ++p)
+        {
+            sc[p] = describe(send, send_displacements[p] + round * chunk, round_count(send_counts[p], round), send_types[p]);
+            rc[p] = describe(receive, receive_displacements[p] + round * chunk, round_count(receive_counts[p], round),
+                             receive_types[p]);
+        }
+
+        int const error = MPI_Alltoallw(MPI_BOTTOM, sc.data(), zero_displacements.data(), send_types.data(), MPI_BOTTOM,
+                                        rc.data(), zero_displacements.data(), receive_types.data(), comm);
+        for (MPI_Datatype& type : created)
+        {
+            MPI_Type_free(&type);
+        }
+        created.clear();
+
+        if (error != MPI_SUCCESS)
+        {
+            throw std::runtime_error("Could not exchange elements among MPI processes.");
+        }
+    }
+#endif
+}
+
+} // namespace mpi
+} // namespace gdsb
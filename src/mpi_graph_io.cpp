@@ -1,6 +1,10 @@
 #include <gdsb/mpi_graph_io.h>
 
+#include <algorithm>
+#include <array>
 #include <cstddef>     // for: offsetof()
+#include <cstring>
+#include <limits>
 #include <type_traits> // for: is
 
 namespace gdsb
@@ -61,9 +65,130 @@ FileWrapper::FileWrapper(std::filesystem::path const& file_path, bool const over
 
 FileWrapper::~FileWrapper() { MPI_File_close(&m_file); }
 
+void read_all(MPI_File const input, void* const buffer, uint64_t const count, MPI_Datatype const datatype, uint64_t const max_count)
+{
+    MPI_Status status;
+    uint64_t read_count = 0;
+
+#if MPI_VERSION >= 4
+    (void)max_count;
+    if (MPI_File_read_all_c(input, buffer, MPI_Count(count), datatype, &status) != MPI_SUCCESS)
+    {
+        throw std::runtime_error("Could not successfully read all elements from MPI file.");
+    }
+
+    MPI_Count elements = 0;
+    MPI_Get_count_c(&status, datatype, &elements);
+    read_count = elements == MPI_UNDEFINED ? 0 : uint64_t(elements);
+#else
+    if (count <= max_count)
+    {
+        if (MPI_File_read_all(input, buffer, int(count), datatype, &status) != MPI_SUCCESS)
+        {
+            throw std::runtime_error("Could not successfully read all elements from MPI file.");
+        }
+
+        int elements = 0;
+        MPI_Get_count(&status, datatype, &elements);
+        read_count = elements == MPI_UNDEFINED ? 0 : uint64_t(elements);
+    }
+    else
+    {
+        // One element of count / max_count chunks of max_count elements each,
+        // followed by the remaining elements.
+        uint64_t const chunk_count = count / max_count;
+        uint64_t const rest_count = count % max_count;
+        if (chunk_count > uint64_t(std::numeric_limits<int>::max()))
+        {
+            throw std::runtime_error("Count of elements exceeds the maximum of the MPI count type.");
+        }
+
+        MPI_Aint lower_bound = 0;
+        MPI_Aint extent = 0;
+        MPI_Type_get_extent(datatype, &lower_bound, &extent);
+
+        MPI_Datatype chunk_type;
+        MPI_Datatype chunks_type;
+        MPI_Datatype rest_type;
+        MPI_Type_contiguous(int(max_count), datatype, &chunk_type);
+        MPI_Type_contiguous(int(chunk_count), chunk_type, &chunks_type);
+        MPI_Type_contiguous(int(rest_count), datatype, &rest_type);
+
+        int const block_lengths[2] = { 1, 1 };
+        MPI_Aint const displacements[2] = { 0, MPI_Aint(chunk_count * max_count) * extent };
+        MPI_Datatype const types[2] = { chunks_type, rest_type };
+        MPI_Datatype large_type;
+        handle_type_create_struct_error(MPI_Type_create_struct(2, block_lengths, displacements, types, &large_type));
+        MPI_Type_commit(&large_type);
+
+        int const error = MPI_File_read_all(input, buffer, 1, large_type, &status);
+        int elements = 0;
+        if (error == MPI_SUCCESS)
+        {
+            MPI_Get_count(&status, large_type, &elements);
+        }
+
+        MPI_Type_free(&large_type);
+        MPI_Type_free(&rest_type);
+        MPI_Type_free(&chunks_type);
+        MPI_Type_free(&chunk_type);
+
+        if (error != MPI_SUCCESS)
+        {
+            throw std::runtime_error("Could not successfully read all elements from MPI file.");
+        }
+
+        // The large type is read either completely or partially.
+        read_count = elements == 1 ? count : 0;
+    }
+#endif
+
+    // Some MPI libraries (e.g. OMPIO of Open MPI) report the requested count
+    // also if the file ends early, yet advance the file pointer beyond its
+    // end.
+    MPI_Offset position = 0;
+    MPI_Offset byte_offset = 0;
+    MPI_Offset file_size = 0;
+    MPI_File_get_position(input, &position);
+    MPI_File_get_byte_offset(input, position, &byte_offset);
+    MPI_File_get_size(input, &file_size);
+
+    if (read_count != count || byte_offset > file_size)
+    {
+        throw std::runtime_error("Could not read all requested elements from MPI file, the file ends early.");
+    }
+}
+
 MPI_File FileWrapper::get() { return m_file; }
 
 
+namespace
+{
+
+// Commits a struct data type of the given fields resized to the extent of
+// EdgeT, thus arrays of edges are read including the padding of the struct.
+template <typename EdgeT, size_t N>
+MPI_Datatype commit_edge_type(std::array<MPI_Aint, N> const& displacements, std::array<MPI_Datatype, N> const& types)
+{
+    static_assert(std::is_standard_layout<EdgeT>(), "Edge type must be of standard layout to be committed as MPI data type.");
+
+    std::array<int, N> block_lengths;
+    block_lengths.fill(1);
+
+    MPI_Datatype type;
+    int const error = MPI_Type_create_struct(int(N), block_lengths.data(), displacements.data(), types.data(), &type);
+    handle_type_create_struct_error(error);
+
+    MPI_Datatype resized_type;
+    MPI_Type_create_resized(type, 0, MPI_Aint(sizeof(EdgeT)), &resized_type);
+    MPI_Type_free(&type);
+    MPI_Type_commit(&resized_type);
+
+    return resized_type;
+}
+
+} // namespace
+
 //! More information on registering MPI data types:
 //! - https://stackoverflow.com/questions/33618937/trouble-understanding-mpi-type-create-struct
 //! - https://docs.open-mpi.org/en/v5.0.x/man-openmpi/man3/MPI_Type_create_struct.3.html
@@ -159,82 +284,209 @@ MPIWeightedTimestampedEdge32::MPIWeightedTimestampedEdge32()
 
 MPI_Datatype MPIWeightedTimestampedEdge32::get() const { return m_type; }
 
-namespace binary
+MPITimestampedEdge32::MPITimestampedEdge32()
 {
+    std::array<MPI_Aint, 3> const displacements = { MPI_Aint(offsetof(gdsb::TimestampedEdge32, edge.source)),
+                                                    MPI_Aint(offsetof(gdsb::TimestampedEdge32, edge.target)),
+                                                    MPI_Aint(offsetof(gdsb::TimestampedEdge32, timestamp)) };
+    std::array<MPI_Datatype, 3> const types = { MPI_INT32_T, MPI_INT32_T, MPI_INT32_T };
+    m_type = commit_edge_type<TimestampedEdge32>(displacements, types);
+}
 
-// For every call to MPI_File_read() we pass MPI_STATUS_IGNORE since we do not
-// investigate any issues using the status but the returned error codes.
-bool read(MPI_File const input, gdsb::Edge32& e)
+MPI_Datatype MPITimestampedEdge32::get() const { return m_type; }
+
+MPIEdge64::MPIEdge64()
 {
-    int ec = MPI_File_read(input, &e.source, 1, MPI_INT32_T, MPI_STATUS_IGNORE);
-    if (ec != MPI_SUCCESS)
-    {
-        return false;
-    }
+    std::array<MPI_Aint, 2> const displacements = { MPI_Aint(offsetof(gdsb::Edge64, source)),
+                                                    MPI_Aint(offsetof(gdsb::Edge64, target)) };
+    std::array<MPI_Datatype, 2> const types = { MPI_UINT64_T, MPI_UINT64_T };
+    m_type = commit_edge_type<Edge64>(displacements, types);
+}
 
-    ec = MPI_File_read(input, &e.target, 1, MPI_INT32_T, MPI_STATUS_IGNORE);
-    return ec == MPI_SUCCESS;
+MPI_Datatype MPIEdge64::get() const { return m_type; }
+
+MPIWeightedEdge64::MPIWeightedEdge64()
+{
+    std::array<MPI_Aint, 3> const displacements = { MPI_Aint(offsetof(gdsb::WeightedEdge64, source)),
+                                                    MPI_Aint(offsetof(gdsb::WeightedEdge64, target.vertex)),
+                                                    MPI_Aint(offsetof(gdsb::WeightedEdge64, target.weight)) };
+    std::array<MPI_Datatype, 3> const types = { MPI_UINT64_T, MPI_UINT64_T, MPI_FLOAT };
+    m_type = commit_edge_type<WeightedEdge64>(displacements, types);
 }
 
-bool read(MPI_File const input, gdsb::WeightedEdge32& e)
+MPI_Datatype MPIWeightedEdge64::get() const { return m_type; }
+
+MPITimestampedEdge64::MPITimestampedEdge64()
 {
-    int ec = MPI_File_read(input, &e.source, 1, MPI_INT32_T, MPI_STATUS_IGNORE);
-    if (ec != MPI_SUCCESS)
-    {
-        return false;
-    }
+    std::array<MPI_Aint, 3> const displacements = { MPI_Aint(offsetof(gdsb::TimestampedEdge64, edge.source)),
+                                                    MPI_Aint(offsetof(gdsb::TimestampedEdge64, edge.target)),
+                                                    MPI_Aint(offsetof(gdsb::TimestampedEdge64, timestamp)) };
+    std::array<MPI_Datatype, 3> const types = { MPI_UINT64_T, MPI_UINT64_T, MPI_UINT64_T };
+    m_type = commit_edge_type<TimestampedEdge64>(displacements, types);
+}
 
-    ec = MPI_File_read(input, &e.target.vertex, 1, MPI_INT32_T, MPI_STATUS_IGNORE);
-    if (ec != MPI_SUCCESS)
-    {
-        return false;
-    }
+MPI_Datatype MPITimestampedEdge64::get() const { return m_type; }
 
-    ec = MPI_File_read(input, &e.target.weight, 1, MPI_FLOAT, MPI_STATUS_IGNORE);
-    return ec == MPI_SUCCESS;
+MPIWeightedTimestampedEdge64::MPIWeightedTimestampedEdge64()
+{
+    std::array<MPI_Aint, 4> const displacements = { MPI_Aint(offsetof(gdsb::WeightedTimestampedEdge64, edge.source)),
+                                                    MPI_Aint(offsetof(gdsb::WeightedTimestampedEdge64, edge.target.vertex)),
+                                                    MPI_Aint(offsetof(gdsb::WeightedTimestampedEdge64, edge.target.weight)),
+                                                    MPI_Aint(offsetof(gdsb::WeightedTimestampedEdge64, timestamp)) };
+    std::array<MPI_Datatype, 4> const types = { MPI_UINT64_T, MPI_UINT64_T, MPI_FLOAT, MPI_UINT64_T };
+    m_type = commit_edge_type<WeightedTimestampedEdge64>(displacements, types);
 }
 
-bool read(MPI_File const input, gdsb::TimestampedEdge32& e)
+MPI_Datatype MPIWeightedTimestampedEdge64::get() const { return m_type; }
+
+std::vector<char> all_read_text_lines(std::filesystem::path const& file_path, MPI_Comm const comm)
 {
-    int ec = MPI_File_read(input, &e.edge.source, 1, MPI_INT32_T, MPI_STATUS_IGNORE);
-    if (ec != MPI_SUCCESS)
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    MPI_File input;
+    if (MPI_File_open(comm, file_path.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &input) != MPI_SUCCESS)
     {
-        return false;
+        throw std::runtime_error("Could not open file using MPI routines: " + file_path.string());
     }
 
-    ec = MPI_File_read(input, &e.edge.target, 1, MPI_INT32_T, MPI_STATUS_IGNORE);
-    if (ec != MPI_SUCCESS)
+    MPI_Offset file_size = 0;
+    MPI_File_get_size(input, &file_size);
+    uint64_t const begin = batch_offset(uint64_t(file_size), rank, size);
+    uint64_t const end = begin + partition_batch_count(uint64_t(file_size), rank, size);
+
+    // The byte preceding the range tells if a line starts at its beginning.
+    uint64_t const read_begin = begin > 0 ? begin - 1 : 0;
+    std::vector<char> bytes(end - read_begin);
+    std::exception_ptr error;
+    try
+    {
+        MPI_File_seek(input, MPI_Offset(read_begin), MPI_SEEK_SET);
+        read_all(input, bytes.data(), bytes.size(), MPI_CHAR);
+    }
+    catch (...)
     {
-        return false;
+        error = std::current_exception();
+    }
+    MPI_File_close(&input);
+    if (error)
+    {
+        std::rethrow_exception(error);
     }
 
-    ec = MPI_File_read(input, &e.timestamp, 1, MPI_INT32_T, MPI_STATUS_IGNORE);
-    return ec == MPI_SUCCESS;
-}
+    // Index of the first line starting within the range, the bytes before it
+    // (the head) belong to the last line of a previous process.
+    size_t const own_begin = size_t(begin - read_begin);
+    size_t first_line = bytes.size();
+    if (begin == 0)
+    {
+        first_line = 0;
+    }
+    else if (bytes.size() > 1)
+    {
+        void const* const newline = std::memchr(bytes.data(), '\n', bytes.size() - 1);
+        if (newline)
+        {
+            first_line = size_t(static_cast<char const*>(newline) - bytes.data()) + 1;
+        }
+    }
 
-bool read(MPI_File const input, gdsb::WeightedTimestampedEdge32& e)
-{
-    int ec = MPI_File_read(input, &e.edge.source, 1, MPI_INT32_T, MPI_STATUS_IGNORE);
-    if (ec != MPI_SUCCESS)
+    uint64_t const head_size = std::max(first_line, own_begin) - own_begin;
+    if (head_size > uint64_t(std::numeric_limits<int>::max()))
     {
-        return false;
+        throw std::runtime_error("Text line exceeds the maximum of the MPI count type.");
     }
 
-    ec = MPI_File_read(input, &e.edge.target.vertex, 1, MPI_INT32_T, MPI_STATUS_IGNORE);
-    if (ec != MPI_SUCCESS)
+    std::array<int, 2> const head{ int(head_size), int(first_line < bytes.size()) };
+    std::vector<int> heads(2 * size_t(size));
+    MPI_Allgather(head.data(), 2, MPI_INT, heads.data(), 2, MPI_INT, comm);
+
+    std::vector<int> head_sizes(size);
+    std::vector<int> head_displacements(size);
+    int head_bytes = 0;
+    for (int r = 0; r < size; ++r)
     {
-        return false;
+        head_sizes[r] = heads[2 * r];
+        head_displacements[r] = head_bytes;
+        head_bytes += head_sizes[r];
     }
+    std::vector<char> all_heads(head_bytes);
+    MPI_Allgatherv(bytes.data() + own_begin, head[0], MPI_CHAR, all_heads.data(), head_sizes.data(), head_displacements.data(),
+                   MPI_CHAR, comm);
 
-    ec = MPI_File_read(input, &e.edge.target.weight, 1, MPI_FLOAT, MPI_STATUS_IGNORE);
-    if (ec != MPI_SUCCESS)
+    std::vector<char> lines;
+    if (first_line < bytes.size())
     {
-        return false;
+        lines.assign(bytes.begin() + first_line, bytes.end());
+
+        // The last line continues within the heads of the following processes
+        // up to the first one a line starts in.
+        for (int r = rank + 1; r < size; ++r)
+        {
+            lines.insert(lines.end(), all_heads.begin() + head_displacements[r],
+                         all_heads.begin() + head_displacements[r] + head_sizes[r]);
+            if (heads[2 * r + 1])
+            {
+                break;
+            }
+        }
+
+        if (lines.back() != '\n')
+        {
+            lines.push_back('\n');
+        }
     }
 
-    ec = MPI_File_read(input, &e.timestamp, 1, MPI_INT32_T, MPI_STATUS_IGNORE);
-    return ec == MPI_SUCCESS;
+    return lines;
+}
+
+namespace binary
+{
+
+// Each edge is read using a single MPI_File_read() of its bytes instead of one
+// read per field, see read(MPI_File, EdgeLayout const&, EdgeT&).
+bool read(MPI_File const input, gdsb::Edge32& e)
+{
+    return read(input, gdsb::binary::native_edge_layout<gdsb::Edge32>(), e);
+}
+
+bool read(MPI_File const input, gdsb::WeightedEdge32& e)
+{
+    return read(input, gdsb::binary::native_edge_layout<gdsb::WeightedEdge32>(), e);
+}
+
+bool read(MPI_File const input, gdsb::TimestampedEdge32& e)
+{
+    return read(input, gdsb::binary::native_edge_layout<gdsb::TimestampedEdge32>(), e);
+}
+
+bool read(MPI_File const input, gdsb::WeightedTimestampedEdge32& e)
+{
+    return read(input, gdsb::binary::native_edge_layout<gdsb::WeightedTimestampedEdge32>(), e);
+}
+
+bool read(MPI_File const input, gdsb::Edge64& e)
+{
+    return read(input, gdsb::binary::native_edge_layout<gdsb::Edge64>(), e);
+}
+
+bool read(MPI_File const input, gdsb::WeightedEdge64& e)
+{
+    return read(input, gdsb::binary::native_edge_layout<gdsb::WeightedEdge64>(), e);
+}
+
+bool read(MPI_File const input, gdsb::TimestampedEdge64& e)
+{
+    return read(input, gdsb::binary::native_edge_layout<gdsb::TimestampedEdge64>(), e);
 }
+
+bool read(MPI_File const input, gdsb::WeightedTimestampedEdge64& e)
+{
+    return read(input, gdsb::binary::native_edge_layout<gdsb::WeightedTimestampedEdge64>(), e);
+}
+
 } // namespace binary
 
 } // namespace mpi
@@ -0,0 +1,160 @@
+#include <gdsb/vertex_properties.h>
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace gdsb
+{
+
+namespace
+{
+
+std::string property_name(VertexPropertyHeader const& header)
+{
+    return std::string(header.name, strnlen(header.name, sizeof(header.name)));
+}
+
+void check_property_type(VertexPropertyHeader const& header, VertexPropertyType const type, uint8_t const byte_size)
+{
+    if (header.type != type || header.byte_size != byte_size)
+    {
+        throw std::logic_error("Value type does not match the vertex property: " + property_name(header));
+    }
+}
+
+VertexPropertyHeader parse_property_header(uint8_t const* const data, uint64_t const size)
+{
+    VertexPropertyHeader header;
+    if (size < sizeof(VertexPropertyHeader))
+    {
+        throw std::runtime_error("Vertex property section of binary graph file is truncated.");
+    }
+    std::memcpy(&header, data, sizeof(VertexPropertyHeader));
+
+    if (header.byte_size == 0 || size < sizeof(VertexPropertyHeader) + header.count * header.byte_size)
+    {
+        throw std::runtime_error("Vertex property section of binary graph file is corrupt: " + property_name(header));
+    }
+
+    return header;
+}
+
+} // namespace
+
+std::vector<VertexPropertyHeader> read_vertex_property_headers(std::istream& input, BinaryGraphHeader const& header)
+{
+    std::vector<VertexPropertyHeader> headers;
+    if (!header.has_sections)
+    {
+        return headers;
+    }
+
+    for (SectionEntry const& entry : read_section_table(input))
+    {
+        if (entry.type != SectionType::vertex_property)
+        {
+            continue;
+        }
+
+        SectionEntry header_entry = entry;
+        header_entry.size = std::min(entry.size, uint64_t(sizeof(VertexPropertyHeader)));
+        std::vector<uint8_t> const data = read_section(input, header_entry);
+        if (data.size() < sizeof(VertexPropertyHeader))
+        {
+            throw std::runtime_error("Vertex property section of binary graph file is truncated.");
+        }
+
+        VertexPropertyHeader property_header;
+        std::memcpy(&property_header, data.data(), sizeof(VertexPropertyHeader));
+        headers.push_back(property_header);
+    }
+
+    return headers;
+}
+
+std::vector<uint8_t> read_vertex_property_section(
+    std::istream& input, BinaryGraphHeader const& header, std::string const& name, VertexPropertyType const type, uint8_t const byte_size)
+{
+    if (header.has_sections)
+    {
+        for (SectionEntry const& entry : read_section_table(input))
+        {
+            if (entry.type != SectionType::vertex_property)
+            {
+                continue;
+            }
+
+            std::vector<uint8_t> data = read_section(input, entry);
+            VertexPropertyHeader const property_header = parse_property_header(data.data(), data.size());
+            if (property_name(property_header) == name)
+            {
+                check_property_type(property_header, type, byte_size);
+                return data;
+            }
+        }
+    }
+
+    throw std::out_of_range("Binary graph file has no vertex property: " + name);
+}
+
+MappedVertexProperties::MappedVertexProperties(std::filesystem::path const& file_path)
+    : m_file(file_path)
+{
+    std::ifstream input(file_path, std::ios::binary);
+    BinaryGraphHeader const header = read_binary_graph_header(input);
+    if (!header.has_sections)
+    {
+        return;
+    }
+
+    for (SectionEntry const& entry : read_section_table(input))
+    {
+        if (entry.type != SectionType::vertex_property)
+        {
+            continue;
+        }
+
+        if (entry.offset + entry.size > m_file.size())
+        {
+            throw std::runtime_error("Vertex property section exceeds the binary graph file: " + file_path.string());
+        }
+
+        uint8_t const* const data = m_file.data() + entry.offset;
+        parse_property_header(data, entry.size);
+        m_columns.push_back(reinterpret_cast<VertexPropertyHeader const*>(data));
+    }
+}
+
+std::vector<std::string> MappedVertexProperties::names() const
+{
+    std::vector<std::string> names;
+    for (VertexPropertyHeader const* column : m_columns)
+    {
+        names.push_back(property_name(*column));
+    }
+
+    return names;
+}
+
+bool MappedVertexProperties::contains(std::string const& name) const
+{
+    return std::any_of(std::begin(m_columns), std::end(m_columns),
+                       [&](VertexPropertyHeader const* column) { return property_name(*column) == name; });
+}
+
+VertexPropertyHeader const& MappedVertexProperties::find(std::string const& name, VertexPropertyType const type, uint8_t const byte_size) const
+{
+    for (VertexPropertyHeader const* column : m_columns)
+    {
+        if (property_name(*column) == name)
+        {
+            check_property_type(*column, type, byte_size);
+            return *column;
+        }
+    }
+
+    throw std::out_of_range("Binary graph file has no vertex property: " + name);
+}
+
+} // namespace gdsb
@@ -270,4 +270,54 @@ TEST_CASE("fair_batch_offset()")
         CHECK(begin == 0u);
         CHECK(count == 30u);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("vertex_partitions")
+{
+    std::vector<Degree64> const degrees{ 3, 0, 1, 4, 2, 2, 0, 4 };
+
+    SECTION("balanced by edges")
+    {
+        std::vector<VertexPartition> const partitions = vertex_partitions(degrees, 3);
+        REQUIRE(partitions.size() == 3);
+
+        CHECK(partitions[0].vertex_begin == 0);
+        CHECK(partitions[0].vertex_end == 3);
+        CHECK(partitions[0].edge_begin == 0);
+        CHECK(partitions[0].edge_end == 4);
+
+        CHECK(partitions[1].vertex_begin == 3);
+        CHECK(partitions[1].vertex_end == 5);
+        CHECK(partitions[1].edge_begin == 4);
+        CHECK(partitions[1].edge_end == 10);
+
+        CHECK(partitions[2].vertex_begin == 5);
+        CHECK(partitions[2].vertex_end == 8);
+        CHECK(partitions[2].edge_begin == 10);
+        CHECK(partitions[2].edge_end == 16);
+    }
+
+    SECTION("balanced by vertices")
+    {
+        std::vector<VertexPartition> const partitions =
+            vertex_partitions(degrees, 2, [](uint64_t, Degree64) { return 1.; });
+        REQUIRE(partitions.size() == 2);
+        CHECK(partitions[0].vertex_end == 4);
+        CHECK(partitions[0].edge_count() == 8);
+        CHECK(partitions[1].vertex_begin == 4);
+        CHECK(partitions[1].edge_count() == 8);
+    }
+
+    SECTION("more partitions than vertices")
+    {
+        std::vector<VertexPartition> const partitions = vertex_partitions(std::vector<Degree64>{ 5 }, 3);
+        REQUIRE(partitions.size() == 3);
+        CHECK(partitions[0].vertex_begin == 0);
+        CHECK(partitions[2].vertex_end == 1);
+        CHECK(partitions[0].edge_count() + partitions[1].edge_count() + partitions[2].edge_count() == 5);
+        for (VertexPartition const& partition : partitions)
+        {
+            CHECK((partition.edge_count() == 0 || partition.edge_count() == 5));
+        }
+    }
+}
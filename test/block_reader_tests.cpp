@@ -0,0 +1,109 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_graph.h"
+
+#include <gdsb/block_reader.h>
+#include <gdsb/graph.h>
+#include <gdsb/graph_input.h>
+
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+using namespace gdsb;
+
+TEST_CASE("BlockReader")
+{
+    std::filesystem::path const file_path{ graph_path + "test_block_reader.bin" };
+    std::vector<uint8_t> bytes(100000);
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = uint8_t(i * 7 + i / 251);
+    }
+    {
+        std::ofstream output(file_path, std::ios::binary);
+        output.write(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+    }
+
+    for (auto const& [backend, direct] :
+         { std::pair{ BlockReaderBackend::automatic, false }, std::pair{ BlockReaderBackend::pread, false },
+           std::pair{ BlockReaderBackend::automatic, true }, std::pair{ BlockReaderBackend::pread, true } })
+    {
+        BlockReaderOptions options;
+        options.backend = backend;
+        options.block_size = 1000;
+        options.queue_depth = 4;
+        options.direct = direct;
+        BlockReader reader(file_path, options);
+        CHECK(reader.backend() != BlockReaderBackend::automatic);
+
+        uint64_t const begin = 5;
+        uint64_t const end = bytes.size() - 2;
+        std::vector<uint8_t> read_bytes(bytes.size(), 0);
+        std::vector<int> read_count(bytes.size(), 0);
+        // Blocks are processed concurrently, thus results are checked after
+        // reading since Catch2 assertions are not thread safe.
+        std::atomic<bool> blocks_aligned{ true };
+        reader.read(begin, end, 3,
+                    [&](uint64_t const offset, uint8_t const* const data, size_t const size)
+                    {
+                        if ((offset - begin) % 999 != 0)
+                        {
+                            blocks_aligned = false;
+                        }
+                        for (size_t i = 0; i < size; ++i)
+                        {
+                            read_bytes[offset + i] = data[i];
+                            ++read_count[offset + i];
+                        }
+                    });
+
+        bool all_read_once = true;
+        for (size_t i = 0; i < bytes.size(); ++i)
+        {
+            bool const in_range = i >= begin && i < end;
+            all_read_once = all_read_once && read_count[i] == int(in_range) && (!in_range || read_bytes[i] == bytes[i]);
+        }
+        CHECK(blocks_aligned);
+        CHECK(all_read_once);
+
+        CHECK_THROWS_AS(reader.read(0, bytes.size(), 1, [](uint64_t, uint8_t const*, size_t) { throw std::logic_error("stop"); }),
+                        std::logic_error);
+        CHECK_THROWS_AS(reader.read(0, bytes.size() + 10, 1, [](uint64_t, uint8_t const*, size_t) {}), std::runtime_error);
+    }
+
+    std::remove(file_path.c_str());
+}
+
+TEST_CASE("read_binary_edges, file path, reptilia-tortoise-network-pv")
+{
+    std::filesystem::path const file_path{ graph_path + undirected_unweighted_temporal_reptilia_tortoise_bin };
+    std::ifstream input(file_path, std::ios::binary);
+    BinaryGraphHeader const header = read_binary_graph_header(input);
+    TimestampedEdges32 const expected = read_binary_edges<TimestampedEdge32>(input, header);
+
+    for (BlockReaderBackend const backend : { BlockReaderBackend::automatic, BlockReaderBackend::pread })
+    {
+        BlockReaderOptions options;
+        options.backend = backend;
+        options.block_size = 100;
+        options.direct = backend == BlockReaderBackend::automatic;
+        options.drop_page_cache = true;
+
+        BinaryGraphHeader file_header;
+        TimestampedEdges32 const edges = read_binary_edges<TimestampedEdge32>(file_path, file_header, options);
+        CHECK(file_header.edge_count == header.edge_count);
+        REQUIRE(edges.size() == expected.size());
+
+        bool equal = true;
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            equal = equal && edges[i].edge.source == expected[i].edge.source && edges[i].edge.target == expected[i].edge.target &&
+                edges[i].timestamp == expected[i].timestamp;
+        }
+        CHECK(equal);
+    }
+}
@@ -0,0 +1,153 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_graph.h"
+
+#include "convert.h"
+
+#include <gdsb/graph.h>
+#include <gdsb/graph_input.h>
+#include <gdsb/graph_io_parameters.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace gdsb;
+
+namespace
+{
+
+void run_convert(std::vector<std::string> arguments)
+{
+    arguments.insert(arguments.begin(), "gdsb-convert");
+    std::vector<char*> argv;
+    for (std::string& argument : arguments)
+    {
+        argv.push_back(argument.data());
+    }
+
+    std::ostringstream log;
+    convert::convert(convert::parse_options(int(argv.size()), argv.data()), log);
+}
+
+using WeightedLine = std::tuple<uint64_t, uint64_t, float>;
+
+std::vector<WeightedLine> read_weighted_lines(std::filesystem::path const& path)
+{
+    std::vector<WeightedLine> lines;
+    std::ifstream input(path);
+    std::string line;
+    while (std::getline(input, line))
+    {
+        if (line.empty() || line.front() == '%' || line.front() == '#')
+        {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        uint64_t u = 0;
+        uint64_t v = 0;
+        float w = 0.f;
+        fields >> u >> v >> w;
+        lines.emplace_back(u, v, w);
+    }
+
+    return lines;
+}
+
+} // namespace
+
+TEST_CASE("convert, spilled runs are sorted and deduplicated")
+{
+    std::filesystem::path const directory{ graph_path + "test_convert_spill" };
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::filesystem::path const input_path = directory / "random.edges";
+    std::filesystem::path const output_path = directory / "random.bin";
+    std::filesystem::path const run_directory = directory / "runs";
+    std::filesystem::create_directories(run_directory);
+
+    // Using --memory 0, text is parsed in blocks of 64 KiB, thus about 300 KiB
+    // of input result in several blocks which are spilled to run files. The
+    // small vertex ID range yields duplicates within and across runs.
+    std::mt19937_64 generator(42);
+    std::uniform_int_distribution<uint32_t> vertex(0, 149);
+    std::vector<std::pair<uint32_t, uint32_t>> expected;
+    {
+        std::ofstream input(input_path);
+        for (size_t i = 0; i < 48000; ++i)
+        {
+            uint32_t const u = vertex(generator);
+            uint32_t const v = vertex(generator);
+            input << u << ' ' << v << '\n';
+            expected.emplace_back(u, v);
+        }
+    }
+    REQUIRE(std::filesystem::file_size(input_path) > 4 * (uint64_t(1) << 16));
+
+    std::sort(std::begin(expected), std::end(expected));
+    expected.erase(std::unique(std::begin(expected), std::end(expected)), std::end(expected));
+
+    run_convert({ "--directed", "--memory", "0", "--dedupe", "--sort", "source", "--tmp", run_directory.string(),
+                  input_path.string(), output_path.string() });
+
+    std::ifstream output(output_path, std::ios::binary);
+    BinaryGraphHeader const header = read_binary_graph_header(output);
+    CHECK(header.directed);
+    REQUIRE(header.edge_count == expected.size());
+
+    Edges32 const edges = read_binary_edges<Edge32>(output, header);
+    bool all_equal = true;
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        all_equal = all_equal && edges[i].source == expected[i].first && edges[i].target == expected[i].second;
+    }
+    CHECK(all_equal);
+
+    // Run files are removed once merged.
+    CHECK(std::filesystem::is_empty(run_directory));
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("convert, text to binary to text round trip")
+{
+    std::filesystem::path const directory{ graph_path + "test_convert_round_trip" };
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::filesystem::path const input_path{ graph_path + undirected_weighted_aves_songbird_social };
+    std::filesystem::path const binary_path = directory / "aves.bin";
+    std::filesystem::path const text_path = directory / "aves.edges";
+
+    run_convert({ "--weighted", input_path.string(), binary_path.string() });
+
+    std::ifstream binary(binary_path, std::ios::binary);
+    BinaryGraphHeader const header = read_binary_graph_header(binary);
+    CHECK(header.weighted);
+    CHECK(header.vertex_count == aves_songbird_social_vertex_count);
+    CHECK(header.edge_count == aves_songbird_social_edge_count / 2);
+
+    run_convert({ binary_path.string(), text_path.string() });
+
+    std::vector<WeightedLine> const original = read_weighted_lines(input_path);
+    std::vector<WeightedLine> const round_trip = read_weighted_lines(text_path);
+    REQUIRE(round_trip.size() == original.size());
+
+    bool all_equal = true;
+    for (size_t i = 0; i < original.size(); ++i)
+    {
+        auto const [u, v, w] = original[i];
+        auto const [x, y, z] = round_trip[i];
+        all_equal = all_equal && u == x && v == y && std::abs(w - z) <= 1e-6f * std::max(1.f, std::abs(w));
+    }
+    CHECK(all_equal);
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,157 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_graph.h"
+
+#include <gdsb/edge_filter.h>
+#include <gdsb/graph.h>
+#include <gdsb/graph_input.h>
+#include <gdsb/graph_io_parameters.h>
+#include <gdsb/graph_output.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+using namespace gdsb;
+
+namespace
+{
+
+template <typename EdgeT> std::vector<EdgeT> copy_matching(std::vector<EdgeT> const& edges, EdgeFilter const& filter)
+{
+    std::vector<EdgeT> matching;
+    std::copy_if(std::begin(edges), std::end(edges), std::back_inserter(matching), filter);
+    return matching;
+}
+
+bool equal_edges(TimestampedEdges32 const& a, TimestampedEdges32 const& b)
+{
+    return std::equal(std::begin(a), std::end(a), std::begin(b), std::end(b),
+                      [](TimestampedEdge32 const& x, TimestampedEdge32 const& y)
+                      { return x.edge.source == y.edge.source && x.edge.target == y.edge.target && x.timestamp == y.timestamp; });
+}
+
+} // namespace
+
+TEST_CASE("EdgeFilter")
+{
+    TimestampedEdges32 edges;
+    auto emplace = [&](Vertex32 u, Vertex32 v, Timestamp32 t) { edges.push_back(TimestampedEdge32{ Edge32{ u, v }, t }); };
+    std::ifstream graph_input(graph_path + undirected_unweighted_temporal_reptilia_tortoise);
+    read_graph<Vertex32, decltype(emplace), EdgeListUndirectedUnweightedLoopDynamic>(graph_input, std::move(emplace));
+
+    VertexBitmap bitmap(20);
+    for (Vertex32 v = 0; v < 20; v += 2)
+    {
+        bitmap.set(v);
+    }
+    CHECK(bitmap.test(4));
+    CHECK(!bitmap.test(5));
+    CHECK(!bitmap.test(100));
+
+    EdgeFilter const chained = EdgeFilter{}.sources(2, 30).targets(0, 25).window(2008, 2012).within(bitmap);
+    EdgeFilter const combined = EdgeFilter{}.sources(2, 30) && EdgeFilter{}.targets(0, 25).window(2008, 2012) && EdgeFilter{}.within(bitmap);
+
+    TimestampedEdges32 const expected = copy_matching(edges, chained);
+    REQUIRE(!expected.empty());
+    CHECK(expected.size() < edges.size());
+    CHECK(equal_edges(copy_matching(edges, combined), expected));
+
+    TimestampedEdges32 filtered = edges;
+    std::vector<uint8_t> keep;
+    filtered.resize(filter_edges(filtered.data(), filtered.size(), chained, keep));
+    CHECK(equal_edges(filtered, expected));
+
+    // Disjoint ranges match nothing.
+    EdgeFilter const empty = EdgeFilter{}.sources(0, 5) && EdgeFilter{}.sources(10, 20);
+    CHECK(copy_matching(edges, empty).empty());
+
+    CHECK_THROWS_AS(check_edge_filter<Edge32>(EdgeFilter{}.window(0, 5)), std::logic_error);
+    CHECK_THROWS_AS(check_edge_filter<TimestampedEdge32>(EdgeFilter{}.min_weight(1.f)), std::logic_error);
+    CHECK_NOTHROW(check_edge_filter<WeightedEdge32>(EdgeFilter{}.min_weight(1.f).sources(0, 5)));
+
+    Subgraph<Vertex32> subgraph;
+    subgraph.source_begin = 3;
+    subgraph.source_end = 7;
+    EdgeFilter const from_subgraph = subgraph_filter(subgraph);
+    CHECK(from_subgraph.source_begin == 3);
+    CHECK(from_subgraph.source_end == 7);
+    CHECK(from_subgraph.target_end == std::numeric_limits<Vertex32>::max());
+}
+
+TEST_CASE("read_binary_edges, EdgeFilter, reptilia-tortoise-network-pv")
+{
+    TimestampedEdges32 edges;
+    auto emplace = [&](Vertex32 u, Vertex32 v, Timestamp32 t) { edges.push_back(TimestampedEdge32{ Edge32{ u, v }, t }); };
+    std::ifstream graph_input(graph_path + undirected_unweighted_temporal_reptilia_tortoise);
+    auto const [vertex_count, edge_count] =
+        read_graph<Vertex32, decltype(emplace), EdgeListUndirectedUnweightedLoopDynamic>(graph_input, std::move(emplace));
+
+    std::filesystem::path const file_path{ graph_path + "test_edge_filter.bin" };
+
+    SECTION("Sorted by timestamp")
+    {
+        std::stable_sort(std::begin(edges), std::end(edges),
+                         [](TimestampedEdge32 const& a, TimestampedEdge32 const& b) { return a.timestamp < b.timestamp; });
+        BinaryWriteOptions options;
+        options.timestamp_index_stride = 16;
+        write_graph<BinaryUndirectedUnweightedDynamic>(file_path, edges, vertex_count, options);
+
+        std::ifstream input(file_path, std::ios::binary);
+        BinaryGraphHeader const header = read_binary_graph_header(input);
+
+        EdgeFilter const filter = EdgeFilter{}.window(2009, 2012).sources(0, 30);
+        auto const [begin, end] = filtered_edge_range<TimestampedEdge32>(input, header, filter);
+        CHECK(end - begin < edges.size());
+
+        TimestampedEdges32 const expected = copy_matching(edges, filter);
+        REQUIRE(!expected.empty());
+        CHECK(equal_edges(read_binary_edges<TimestampedEdge32>(input, header, filter), expected));
+    }
+
+    SECTION("Sorted by source, stream_vbyte")
+    {
+        std::stable_sort(std::begin(edges), std::end(edges),
+                         [](TimestampedEdge32 const& a, TimestampedEdge32 const& b) { return a.edge.source < b.edge.source; });
+        BinaryWriteOptions options;
+        options.encoding = EdgeEncoding::stream_vbyte;
+        options.chunk_edge_count = 16;
+        write_graph<BinaryUndirectedUnweightedDynamic>(file_path, edges, vertex_count, options);
+
+        std::ifstream input(file_path, std::ios::binary);
+        BinaryGraphHeader const header = read_binary_graph_header(input);
+
+        VertexBitmap bitmap(vertex_count);
+        for (Vertex32 v = 0; v < vertex_count; v += 3)
+        {
+            bitmap.set(v);
+        }
+        EdgeFilter const filter = EdgeFilter{}.sources(10, 20).within(bitmap);
+        auto const [begin, end] = filtered_edge_range<TimestampedEdge32>(input, header, filter);
+        CHECK(begin > 0);
+        CHECK(end < edges.size());
+
+        // The chunk wise search yields the same bounds as searching all edges.
+        auto const source = [](TimestampedEdge32 const& e) { return e.edge.source; };
+        bool all_equal = true;
+        for (Vertex32 v = 0; v <= vertex_count; ++v)
+        {
+            auto const it = std::lower_bound(std::begin(edges), std::end(edges), v,
+                                             [](TimestampedEdge32 const& e, Vertex32 const u) { return e.edge.source < u; });
+            uint64_t const expected_bound = std::distance(std::begin(edges), it);
+            all_equal = all_equal &&
+                edge_lower_bound<TimestampedEdge32>(input, header, 0, edges.size(), source, v) == expected_bound &&
+                edge_lower_bound<TimestampedEdge32>(input, header, begin, end, source, v) ==
+                    std::clamp(expected_bound, begin, end);
+        }
+        CHECK(all_equal);
+
+        TimestampedEdges32 const expected = copy_matching(edges, filter);
+        REQUIRE(!expected.empty());
+        CHECK(equal_edges(read_binary_edges<TimestampedEdge32>(input, header, filter), expected));
+    }
+
+    REQUIRE(std::remove(file_path.c_str()) == 0);
+}
@@ -0,0 +1,61 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_graph.h"
+
+#include <gdsb/graph.h>
+#include <gdsb/graph_cache.h>
+#include <gdsb/graph_input.h>
+#include <gdsb/graph_io_parameters.h>
+
+#include <filesystem>
+
+using namespace gdsb;
+
+TEST_CASE("read_graph_cached, aves-songbird-social")
+{
+    std::filesystem::path const cache_directory{ graph_path + "test_graph_cache" };
+    std::filesystem::remove_all(cache_directory);
+
+    std::string const path = graph_path + undirected_weighted_aves_songbird_social;
+    using Parameters = EdgeListUndirectedWeightedNoLoopStatic;
+
+    WeightedEdges32 expected;
+    auto emplace_expected = [&](Vertex32 u, Vertex32 v, Weight w) { expected.push_back({ u, { v, w } }); };
+    auto const [expected_vertex_count, expected_edge_count] =
+        read_graph<Vertex32, decltype(emplace_expected), Parameters>(path, std::move(emplace_expected));
+
+    std::filesystem::path const cache_path =
+        graph_cache_path(cache_directory, path, graph_cache_parameters<Parameters>(std::numeric_limits<uint64_t>::max()));
+    CHECK(cache_path != graph_cache_path(cache_directory, path, graph_cache_parameters<Parameters>(10)));
+    CHECK(cache_path != graph_cache_path(cache_directory, path, graph_cache_parameters<EdgeListDirectedWeightedNoLoopStatic>(
+                                                                     std::numeric_limits<uint64_t>::max())));
+
+    // The first read parses the text file and writes the cache file, the
+    // second read maps the cache file.
+    for (int run = 0; run < 2; ++run)
+    {
+        CHECK(std::filesystem::exists(cache_path) == (run == 1));
+
+        WeightedEdges32 edges;
+        auto emplace = [&](Vertex32 u, Vertex32 v, Weight w) { edges.push_back({ u, { v, w } }); };
+        auto const [vertex_count, edge_count] =
+            read_graph_cached<Vertex32, decltype(emplace), Parameters>(path, std::move(emplace), cache_directory);
+
+        CHECK(vertex_count == expected_vertex_count);
+        CHECK(edge_count == expected_edge_count);
+        REQUIRE(edges.size() == expected.size());
+        bool equal = true;
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            equal = equal && edges[i].source == expected[i].source && edges[i].target.vertex == expected[i].target.vertex &&
+                edges[i].target.weight == expected[i].target.weight;
+        }
+        CHECK(equal);
+    }
+
+    MappedFile const file(cache_path);
+    CHECK(file.size() == std::filesystem::file_size(cache_path));
+    CHECK(std::string(reinterpret_cast<char const*>(file.data()), 4) == "GDSB");
+
+    std::filesystem::remove_all(cache_directory);
+}
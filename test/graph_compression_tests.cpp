@@ -0,0 +1,418 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_graph.h"
+
+#include <gdsb/graph.h>
+#include <gdsb/graph_compression.h>
+#include <gdsb/graph_input.h>
+#include <gdsb/graph_io_parameters.h>
+#include <gdsb/graph_output.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+
+using namespace gdsb;
+
+TEST_CASE("stream_vbyte")
+{
+    SECTION("encode and decode values of all byte lengths")
+    {
+        std::vector<uint32_t> values;
+        for (uint32_t v : { 0u, 1u, 255u, 256u, 65535u, 65536u, 16777215u, 16777216u, 4294967295u })
+        {
+            values.push_back(v);
+        }
+
+        // Add enough values such that the SIMD decoder (if available) is used.
+        std::mt19937 engine{ 42 };
+        std::uniform_int_distribution<uint32_t> distrib;
+        for (int i = 0; i < 1001; ++i)
+        {
+            values.push_back(distrib(engine) >> (i % 32));
+        }
+
+        std::vector<uint8_t> encoded(stream_vbyte::max_encoded_size(values.size()));
+        size_t const encoded_size = stream_vbyte::encode(values.data(), values.size(), encoded.data());
+        CHECK(encoded_size <= encoded.size());
+
+        std::vector<uint32_t> decoded(values.size());
+        size_t const decoded_size =
+            stream_vbyte::decode(encoded.data(), encoded.data() + encoded_size, values.size(), decoded.data());
+        CHECK(decoded_size == encoded_size);
+        CHECK(decoded == values);
+    }
+
+    SECTION("small values use one byte each")
+    {
+        std::vector<uint32_t> values(16, 7u);
+        std::vector<uint8_t> encoded(stream_vbyte::max_encoded_size(values.size()));
+        CHECK(stream_vbyte::encode(values.data(), values.size(), encoded.data()) == 4 + 16);
+    }
+
+    SECTION("truncated input throws")
+    {
+        std::vector<uint32_t> values(8, 1u << 20);
+        std::vector<uint8_t> encoded(stream_vbyte::max_encoded_size(values.size()));
+        size_t const encoded_size = stream_vbyte::encode(values.data(), values.size(), encoded.data());
+
+        std::vector<uint32_t> decoded(values.size());
+        CHECK_THROWS(stream_vbyte::decode(encoded.data(), encoded.data() + encoded_size - 1, values.size(), decoded.data()));
+    }
+}
+
+TEST_CASE("zigzag_delta")
+{
+    CHECK(zigzag_delta(5u, 5u) == 0u);
+    CHECK(zigzag_delta(6u, 5u) == 2u);
+    CHECK(zigzag_delta(4u, 5u) == 1u);
+    CHECK(zigzag_undelta(zigzag_delta(0u, 4294967295u), 4294967295u) == 0u);
+    CHECK(zigzag_undelta(zigzag_delta(4294967295u, 0u), 0u) == 4294967295u);
+}
+
+TEST_CASE("encode_edge_chunk, weighted temporal edges")
+{
+    WeightedTimestampedEdges32 edges{ { { 0, { 1, 0.5f } }, 1 },  { { 0, { 7, 1.f } }, 3 }, { { 0, { 3, 2.f } }, 2 },
+                                      { { 4, { 2, 1.5f } }, 8 },  { { 2, { 9, 1.f } }, 4 }, { { 2, { 9, 1.f } }, 4 },
+                                      { { 9, { 0, 0.25f } }, 7 } };
+
+    std::vector<uint8_t> encoded;
+    encode_edge_chunk(EdgeEncoding::stream_vbyte, edges.data(), edges.size(), encoded);
+
+    WeightedTimestampedEdges32 decoded(edges.size());
+    decode_edge_chunk(EdgeEncoding::stream_vbyte, encoded.data(), encoded.data() + encoded.size(), decoded.size(),
+                      decoded.data());
+
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        CHECK(decoded[i].edge.source == edges[i].edge.source);
+        CHECK(decoded[i].edge.target.vertex == edges[i].edge.target.vertex);
+        CHECK(decoded[i].edge.target.weight == edges[i].edge.target.weight);
+        CHECK(decoded[i].timestamp == edges[i].timestamp);
+    }
+}
+
+TEST_CASE("encode_edge_chunk, throws on vertex IDs exceeding 32 bit")
+{
+    Edges64 edges{ { 0, 1 }, { uint64_t(1) << 40, 2 } };
+    std::vector<uint8_t> encoded;
+    CHECK_THROWS_AS(encode_edge_chunk(EdgeEncoding::stream_vbyte, edges.data(), edges.size(), encoded), std::out_of_range);
+}
+
+TEST_CASE("read_chunk_directory, throws on corrupt offsets")
+{
+    auto directory_stream = [](std::vector<uint64_t> const& offsets, size_t const chunk_bytes)
+    {
+        EdgeChunkDirectory directory;
+        directory.chunk_edge_count = 4;
+        directory.offsets = offsets;
+        std::stringstream stream;
+        write_chunk_directory(stream, directory);
+        stream << std::string(chunk_bytes, '\0');
+        return stream;
+    };
+
+    std::stringstream valid = directory_stream({ 0, 8, 16 }, 16);
+    CHECK(read_chunk_directory(valid).chunk_count() == 2);
+
+    std::stringstream decreasing = directory_stream({ 0, 16, 8 }, 16);
+    CHECK_THROWS_AS(read_chunk_directory(decreasing), std::runtime_error);
+
+    std::stringstream nonzero_begin = directory_stream({ 4, 8, 16 }, 16);
+    CHECK_THROWS_AS(read_chunk_directory(nonzero_begin), std::runtime_error);
+
+    std::stringstream past_end = directory_stream({ 0, 8, 32 }, 16);
+    CHECK_THROWS_AS(read_chunk_directory(past_end), std::runtime_error);
+
+    std::stringstream huge_count;
+    uint64_t const header[2] = { 4, std::numeric_limits<uint64_t>::max() };
+    huge_count.write(reinterpret_cast<char const*>(header), sizeof(header));
+    CHECK_THROWS_AS(read_chunk_directory(huge_count), std::runtime_error);
+}
+
+TEST_CASE("write_graph, stream_vbyte, enzymes")
+{
+    Edges32 edges;
+    auto emplace = [&](Vertex32 u, Vertex32 v) { edges.push_back(Edge32{ u, v }); };
+    std::ifstream graph_input(graph_path + unweighted_directed_graph_enzymes);
+    auto const [vertex_count, edge_count] =
+        read_graph<Vertex32, decltype(emplace), EdgeListDirectedUnweightedNoLoopStatic>(graph_input, std::move(emplace));
+
+    gdsb::sort<Edge32>(std::begin(edges), std::end(edges));
+
+    std::filesystem::path const file_path{ graph_path + "test_graph_stream_vbyte.bin" };
+
+    BinaryWriteOptions options;
+    options.encoding = EdgeEncoding::stream_vbyte;
+    // Small chunks to test reading more than one chunk.
+    options.chunk_edge_count = 50;
+    BinaryWriteStatistics const statistics = write_graph<BinaryDirectedUnweightedStatic>(file_path, edges, vertex_count, options);
+
+    CHECK(statistics.edge_count == enzymes_g1_edge_count);
+    // Raw encoding uses 64 bits per edge.
+    CHECK(statistics.bits_per_edge() < 32.);
+
+    std::ifstream binary_graph(file_path);
+    BinaryGraphHeader const header = read_binary_graph_header(binary_graph);
+    CHECK(header.encoding == EdgeEncoding::stream_vbyte);
+    CHECK(header.vertex_count == vertex_count);
+    CHECK(header.edge_count == edge_count);
+
+    Edges32 const edges_in = read_binary_edges<Edge32>(binary_graph, header);
+    REQUIRE(edges_in.size() == edges.size());
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        CHECK(edges_in[i].source == edges[i].source);
+        CHECK(edges_in[i].target == edges[i].target);
+    }
+
+    SECTION("reading edge by edge throws")
+    {
+        std::ifstream binary_graph_again(file_path);
+        BinaryGraphHeader const header_again = read_binary_graph_header(binary_graph_again);
+        CHECK_THROWS_AS(read_binary_graph(binary_graph_again, header_again, [](std::ifstream&) { return true; }),
+                        std::logic_error);
+    }
+
+    REQUIRE(std::remove(file_path.c_str()) == 0);
+}
+
+TEST_CASE("write_graph, raw, reptilia-tortoise-network-pv")
+{
+    TimestampedEdges32 edges;
+    auto emplace = [&](Vertex32 u, Vertex32 v, Timestamp32 t) { edges.push_back(TimestampedEdge32{ Edge32{ u, v }, t }); };
+    std::ifstream graph_input(graph_path + undirected_unweighted_temporal_reptilia_tortoise);
+    auto const [vertex_count, edge_count] =
+        read_graph<Vertex32, decltype(emplace), EdgeListUndirectedUnweightedLoopDynamic>(graph_input, std::move(emplace));
+
+    std::filesystem::path const file_path{ graph_path + "test_graph_raw.bin" };
+    BinaryWriteStatistics const statistics = write_graph<BinaryUndirectedUnweightedDynamic>(file_path, edges, vertex_count);
+
+    std::ifstream binary_graph(file_path);
+    BinaryGraphHeader const header = read_binary_graph_header(binary_graph);
+    CHECK(header.encoding == EdgeEncoding::raw);
+    // Vertex IDs fit into one byte, timestamps into two bytes.
+    CHECK(header.vertex_id_byte_size == 1);
+    CHECK(header.timestamp_byte_size == 2);
+    CHECK(statistics.bits_per_edge() == 8. * 4.);
+
+    TimestampedEdges32 const edges_in = read_binary_edges<TimestampedEdge32>(binary_graph, header);
+    REQUIRE(edges_in.size() == reptilia_tortoise_network_edge_count);
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        CHECK(edges_in[i].edge.source == edges[i].edge.source);
+        CHECK(edges_in[i].edge.target == edges[i].edge.target);
+        CHECK(edges_in[i].timestamp == edges[i].timestamp);
+    }
+
+    SECTION("wrong edge type throws")
+    {
+        std::ifstream binary_graph_again(file_path);
+        BinaryGraphHeader const header_again = read_binary_graph_header(binary_graph_again);
+        CHECK_THROWS_AS(read_binary_edges<Edge32>(binary_graph_again, header_again), std::logic_error);
+    }
+
+    REQUIRE(std::remove(file_path.c_str()) == 0);
+}
+
+TEST_CASE("binary::encode_edges, all byte sizes")
+{
+    TimestampedEdges64 edges{ { { 0, 1 }, 2 }, { { 255, 256 }, 65535 }, { { 1, 0 }, 0 } };
+
+    for (uint8_t width = 1; width <= 8; ++width)
+    {
+        binary::EdgeLayout layout = binary::native_edge_layout<TimestampedEdge64>();
+        layout.vertex_id_byte_size = width;
+        layout.timestamp_byte_size = width;
+
+        // Largest value representable using width bytes.
+        uint64_t const max = width == 8 ? std::numeric_limits<uint64_t>::max() : (uint64_t(1) << (8 * width)) - 1;
+        edges[2].edge.source = max;
+        edges[2].timestamp = max;
+
+        if (width == 1)
+        {
+            // Target 256 does not fit into one byte.
+            CHECK_THROWS_AS(binary::encode_edges(edges.data(), edges.size(), layout, std::vector<uint8_t>(64).data()),
+                            std::out_of_range);
+            continue;
+        }
+
+        std::vector<uint8_t> bytes(edges.size() * layout.edge_size_in_bytes());
+        CHECK(binary::encode_edges(edges.data(), edges.size(), layout, bytes.data()) == bytes.data() + bytes.size());
+
+        TimestampedEdges64 decoded(edges.size());
+        binary::decode_edges(bytes.data(), decoded.size(), layout, decoded.data());
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            CHECK(decoded[i].edge.source == edges[i].edge.source);
+            CHECK(decoded[i].edge.target == edges[i].edge.target);
+            CHECK(decoded[i].timestamp == edges[i].timestamp);
+        }
+
+        TimestampedEdges32 narrow(edges.size());
+        if (width > 4)
+        {
+            CHECK_THROWS_AS(binary::decode_edges(bytes.data(), narrow.size(), layout, narrow.data()), std::out_of_range);
+        }
+        else
+        {
+            binary::decode_edges(bytes.data(), narrow.size(), layout, narrow.data());
+            CHECK(narrow[2].edge.source == max);
+        }
+    }
+}
+
+TEST_CASE("write_graph, 64 bit vertex IDs")
+{
+    WeightedEdges64 edges{ { 0, { 1, 0.5f } }, { uint64_t(1) << 36, { 2, 1.f } }, { 3, { (uint64_t(1) << 36) + 1, 2.f } } };
+    uint64_t const vertex_count = (uint64_t(1) << 36) + 2;
+
+    std::filesystem::path const file_path{ graph_path + "test_graph_64.bin" };
+    write_graph<BinaryDirectedWeightedStatic>(file_path, edges, vertex_count);
+
+    std::ifstream binary_graph(file_path);
+    BinaryGraphHeader const header = read_binary_graph_header(binary_graph);
+    CHECK(header.vertex_id_byte_size == 5);
+    CHECK(header.vertex_count == vertex_count);
+
+    WeightedEdges64 const edges_in = read_binary_edges<WeightedEdge64>(binary_graph, header);
+    REQUIRE(edges_in.size() == edges.size());
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        CHECK(edges_in[i].source == edges[i].source);
+        CHECK(edges_in[i].target.vertex == edges[i].target.vertex);
+        CHECK(edges_in[i].target.weight == edges[i].target.weight);
+    }
+
+    SECTION("reading into 32 bit edges throws")
+    {
+        std::ifstream binary_graph_again(file_path);
+        BinaryGraphHeader const header_again = read_binary_graph_header(binary_graph_again);
+        CHECK_THROWS_AS(read_binary_edges<WeightedEdge32>(binary_graph_again, header_again), std::out_of_range);
+    }
+
+    SECTION("reading edge by edge using the layout of the header")
+    {
+        std::ifstream binary_graph_again(file_path);
+        BinaryGraphHeader const header_again = read_binary_graph_header(binary_graph_again);
+        WeightedEdge64 e;
+        binary::read(binary_graph_again, binary::edge_layout(header_again), e);
+        binary::read(binary_graph_again, binary::edge_layout(header_again), e);
+        CHECK(e.source == edges[1].source);
+        CHECK(e.target.vertex == 2);
+    }
+
+    REQUIRE(std::remove(file_path.c_str()) == 0);
+}
+
+TEST_CASE("write_graph, parallel, random edges")
+{
+    // More edges than fit into one block per thread.
+    size_t const edge_count = 300000;
+    Vertex32 const vertex_count = 1u << 20;
+    std::mt19937 engine{ 7 };
+    std::uniform_int_distribution<Vertex32> distrib{ 0, vertex_count - 1 };
+    TimestampedEdges32 edges(edge_count);
+    for (size_t i = 0; i < edge_count; ++i)
+    {
+        edges[i] = { { distrib(engine), distrib(engine) }, Timestamp32(i) };
+    }
+
+    std::filesystem::path const file_path{ graph_path + "test_graph_parallel.bin" };
+
+    for (EdgeEncoding const encoding : { EdgeEncoding::raw, EdgeEncoding::stream_vbyte })
+    {
+        BinaryWriteOptions options;
+        options.encoding = encoding;
+        // Without sections the file ends with the edges.
+        options.statistics = false;
+        BinaryWriteStatistics const statistics =
+            write_graph<BinaryDirectedUnweightedDynamic>(file_path, edges, vertex_count, options);
+
+        CHECK(std::filesystem::file_size(file_path) ==
+              sizeof(BinaryGraphHeaderIdentifier) + sizeof(BinaryGraphHeader) + statistics.edge_bytes);
+
+        std::ifstream binary_graph(file_path);
+        BinaryGraphHeader const header = read_binary_graph_header(binary_graph);
+        TimestampedEdges32 const edges_in = read_binary_edges<TimestampedEdge32>(binary_graph, header);
+        REQUIRE(edges_in.size() == edges.size());
+
+        bool equal = true;
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            equal = equal && edges_in[i].edge.source == edges[i].edge.source &&
+                edges_in[i].edge.target == edges[i].edge.target && edges_in[i].timestamp == edges[i].timestamp;
+        }
+        CHECK(equal);
+
+        // Without a timestamp index the window is found by probing single edges.
+        std::ifstream binary_graph_again(file_path);
+        read_binary_graph_header(binary_graph_again);
+        TimestampedEdges32 const window =
+            read_binary_graph_window<TimestampedEdge32>(binary_graph_again, header, 1000, 250000);
+        REQUIRE(window.size() == 249000);
+        CHECK(window.front().timestamp == 1000);
+        CHECK(window.back().timestamp == 249999);
+    }
+
+    REQUIRE(std::remove(file_path.c_str()) == 0);
+}
+
+TEST_CASE("write_graph, block codecs, small weighted temporal")
+{
+    WeightedTimestampedEdges32 edges;
+    auto emplace = [&](Vertex32 u, Vertex32 v, Weight w, Timestamp32 t) { edges.push_back({ { u, { v, w } }, t }); };
+    std::ifstream graph_input(graph_path + small_weighted_temporal_graph);
+    auto const [vertex_count, edge_count] =
+        read_graph<Vertex32, decltype(emplace), EdgeListDirectedWeightedNoLoopDynamic>(graph_input, std::move(emplace));
+
+    std::filesystem::path const file_path{ graph_path + "test_graph_block_codec.bin" };
+
+    for (EdgeEncoding const encoding : { EdgeEncoding::lz4, EdgeEncoding::zstd })
+    {
+        BinaryWriteOptions options;
+        options.encoding = encoding;
+        options.chunk_edge_count = 3;
+
+        if (!block_codec::supported(encoding))
+        {
+            CHECK_THROWS_AS(write_graph<BinaryDirectedWeightedDynamic>(file_path, edges, vertex_count, options), std::logic_error);
+            continue;
+        }
+
+        write_graph<BinaryDirectedWeightedDynamic>(file_path, edges, vertex_count, options);
+
+        std::ifstream binary_graph(file_path);
+        BinaryGraphHeader const header = read_binary_graph_header(binary_graph);
+        CHECK(header.encoding == encoding);
+
+        WeightedTimestampedEdges32 const edges_in = read_binary_edges<WeightedTimestampedEdge32>(binary_graph, header);
+        REQUIRE(edges_in.size() == edges.size());
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            CHECK(edges_in[i].edge.source == edges[i].edge.source);
+            CHECK(edges_in[i].edge.target.vertex == edges[i].edge.target.vertex);
+            CHECK(edges_in[i].edge.target.weight == edges[i].edge.target.weight);
+            CHECK(edges_in[i].timestamp == edges[i].timestamp);
+        }
+    }
+
+    std::remove(file_path.c_str());
+}
+
+TEST_CASE("read_binary_edges, version 3 file")
+{
+    std::ifstream binary_graph(graph_path + small_weighted_temporal_graph_bin);
+    BinaryGraphHeader const header = read_binary_graph_header(binary_graph);
+    CHECK(header.encoding == EdgeEncoding::raw);
+
+    WeightedTimestampedEdges32 const edges = read_binary_edges<WeightedTimestampedEdge32>(binary_graph, header);
+    REQUIRE(edges.size() == 7);
+    CHECK(edges[3].edge.source == 1);
+    CHECK(edges[3].edge.target.vertex == 4);
+    CHECK(edges[3].timestamp == 8);
+}
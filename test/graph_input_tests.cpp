@@ -4,10 +4,14 @@
 #include "test_graph.h"
 
 #include <gdsb/graph_input.h>
+#include <gdsb/graph_output.h>
 
 #include <algorithm>
+#include <cstdio>
+#include <iterator>
 #include <sstream>
 #include <string>
+#include <type_traits>
 
 using namespace gdsb;
 
@@ -931,4 +935,191 @@ TEST_CASE("insert_return_edges")
         REQUIRE((original_edge_size * 2) == edges.size());
         CHECK(no_duplicates_found());
     }
-}
\ No newline at end of file
+}
+TEST_CASE("read_vertex_partitions, enzymes")
+{
+    Edges32 edges;
+    auto emplace = [&](Vertex32 u, Vertex32 v) { edges.push_back(Edge32{ u, v }); };
+    std::ifstream graph_input(graph_path + unweighted_directed_graph_enzymes);
+    auto const [vertex_count, edge_count] =
+        read_graph<Vertex32, decltype(emplace), EdgeListDirectedUnweightedNoLoopStatic>(graph_input, std::move(emplace));
+    gdsb::sort<Edge32>(std::begin(edges), std::end(edges));
+
+    std::filesystem::path const file_path{ graph_path + "test_graph_vertex_partitions.bin" };
+
+    for (bool const degrees_section : { false, true })
+    {
+        BinaryWriteOptions options;
+        options.narrow_widths = false;
+        options.degrees = degrees_section;
+        write_graph<BinaryDirectedUnweightedStatic>(file_path, edges, vertex_count, options);
+
+        std::ifstream binary_graph(file_path);
+        BinaryGraphHeader const header = read_binary_graph_header(binary_graph);
+        uint32_t const partition_count = 4;
+        std::vector<VertexPartition> const partitions = read_vertex_partitions(binary_graph, header, partition_count);
+        REQUIRE(partitions.size() == partition_count);
+        CHECK(partitions.back().edge_end == edges.size());
+
+        for (VertexPartition const& partition : partitions)
+        {
+            // No source vertex is split between two partitions.
+            if (partition.edge_begin > 0 && partition.edge_count() > 0)
+            {
+                CHECK(edges[partition.edge_begin - 1].source != edges[partition.edge_begin].source);
+            }
+
+            std::ifstream partition_input(file_path);
+            read_binary_graph_header(partition_input);
+            Edges32 partition_edges;
+            auto read_f = [&](std::ifstream& input)
+            {
+                partition_edges.push_back({});
+                binary::read(input, partition_edges.back());
+                return true;
+            };
+            read_binary_graph_partition(partition_input, header, read_f, sizeof(Edge32), partition);
+
+            REQUIRE(partition_edges.size() == partition.edge_count());
+            for (Edge32 const& e : partition_edges)
+            {
+                CHECK(e.source >= partition.vertex_begin);
+                CHECK(e.source < partition.vertex_end);
+            }
+        }
+    }
+
+    SECTION("unsorted edges throw")
+    {
+        std::swap(edges.front(), edges.back());
+        write_graph<BinaryDirectedUnweightedStatic>(file_path, edges, vertex_count);
+        std::ifstream binary_graph(file_path);
+        BinaryGraphHeader const header = read_binary_graph_header(binary_graph);
+        CHECK_THROWS_AS(read_vertex_partitions(binary_graph, header, 2), std::logic_error);
+    }
+
+    REQUIRE(std::remove(file_path.c_str()) == 0);
+}
+
+TEST_CASE("read_binary_graph_window, reptilia-tortoise-network-pv")
+{
+    TimestampedEdges32 edges;
+    auto emplace = [&](Vertex32 u, Vertex32 v, Timestamp32 t) { edges.push_back(TimestampedEdge32{ Edge32{ u, v }, t }); };
+    std::ifstream graph_input(graph_path + undirected_unweighted_temporal_reptilia_tortoise);
+    auto const [vertex_count, edge_count] =
+        read_graph<Vertex32, decltype(emplace), EdgeListUndirectedUnweightedLoopDynamic>(graph_input, std::move(emplace));
+    std::stable_sort(std::begin(edges), std::end(edges),
+                     [](TimestampedEdge32 const& a, TimestampedEdge32 const& b) { return a.timestamp < b.timestamp; });
+
+    Timestamp32 const t0 = edges[edges.size() / 3].timestamp;
+    Timestamp32 const t1 = edges[2 * edges.size() / 3].timestamp + 1;
+    TimestampedEdges32 expected;
+    std::copy_if(std::begin(edges), std::end(edges), std::back_inserter(expected),
+                 [&](TimestampedEdge32 const& e) { return e.timestamp >= t0 && e.timestamp < t1; });
+    REQUIRE(!expected.empty());
+
+    std::filesystem::path const file_path{ graph_path + "test_graph_window.bin" };
+
+    for (EdgeEncoding const encoding : { EdgeEncoding::raw, EdgeEncoding::stream_vbyte })
+    {
+        for (uint64_t const stride : { uint64_t(0), uint64_t(16) })
+        {
+            BinaryWriteOptions options;
+            options.encoding = encoding;
+            options.chunk_edge_count = 50;
+            options.timestamp_index_stride = stride;
+            write_graph<BinaryUndirectedUnweightedDynamic>(file_path, edges, vertex_count, options);
+
+            std::ifstream binary_graph(file_path);
+            BinaryGraphHeader const header = read_binary_graph_header(binary_graph);
+            CHECK(bool(read_timestamp_index(binary_graph, header)) == (stride > 0));
+
+            TimestampedEdges32 const window = read_binary_graph_window<TimestampedEdge32>(binary_graph, header, t0, t1);
+            REQUIRE(window.size() == expected.size());
+            CHECK(window.front().timestamp == expected.front().timestamp);
+            CHECK(window.back().timestamp == expected.back().timestamp);
+            CHECK(window.front().edge.source == expected.front().edge.source);
+
+            CHECK(read_binary_graph_window<TimestampedEdge32>(binary_graph, header, t1, t0).empty());
+
+            std::vector<TimePartition> const partitions = read_time_partitions<TimestampedEdge32>(binary_graph, header, 3);
+            REQUIRE(partitions.size() == 3);
+            CHECK(partitions.front().edge_begin == 0);
+            CHECK(partitions.back().edge_end == edges.size());
+            for (size_t p = 0; p < partitions.size(); ++p)
+            {
+                TimestampedEdges32 const partition_edges =
+                    read_binary_edge_range<TimestampedEdge32>(binary_graph, header, partitions[p].edge_begin, partitions[p].edge_end);
+                for (TimestampedEdge32 const& e : partition_edges)
+                {
+                    CHECK(e.timestamp >= partitions[p].timestamp_begin);
+                    CHECK(e.timestamp < partitions[p].timestamp_end);
+                }
+
+                if (p > 0)
+                {
+                    CHECK(partitions[p].edge_begin == partitions[p - 1].edge_end);
+                }
+            }
+
+            // Reading windows and partitions does not move the input away from the edges.
+            CHECK(read_binary_edges<TimestampedEdge32>(binary_graph, header).size() == edges.size());
+        }
+    }
+
+    SECTION("unsorted edges throw")
+    {
+        std::swap(edges.front(), edges.back());
+        write_graph<BinaryUndirectedUnweightedDynamic>(file_path, edges, vertex_count);
+        std::ifstream binary_graph(file_path);
+        BinaryGraphHeader const header = read_binary_graph_header(binary_graph);
+        CHECK_THROWS_AS(read_binary_graph_window<TimestampedEdge32>(binary_graph, header, t0, t1), std::logic_error);
+    }
+
+    REQUIRE(std::remove(file_path.c_str()) == 0);
+}
+
+TEST_CASE("visit_binary_graph")
+{
+    SECTION("enzymes")
+    {
+        visit_binary_graph(graph_path + directed_unweighted_graph_enzymes_bin,
+                           [](BinaryGraphHeader const& header, auto&& edges)
+                           {
+                               CHECK(std::is_same_v<std::decay_t<decltype(edges)>, Edges32>);
+                               CHECK(header.edge_count == enzymes_g1_edge_count);
+                               CHECK(edges.size() == enzymes_g1_edge_count);
+                           });
+    }
+
+    SECTION("reptilia-tortoise-network-pv")
+    {
+        size_t const edge_count =
+            visit_binary_graph(graph_path + undirected_unweighted_temporal_reptilia_tortoise_bin,
+                               [](BinaryGraphHeader const&, auto&& edges)
+                               {
+                                   CHECK(std::is_same_v<std::decay_t<decltype(edges)>, TimestampedEdges32>);
+                                   return edges.size();
+                               });
+        CHECK(edge_count == reptilia_tortoise_network_edge_count);
+    }
+
+    SECTION("64 bit vertex IDs")
+    {
+        Edges64 const edges = { { 0, Vertex64(1) << 40 }, { Vertex64(1) << 40, 1 } };
+        std::filesystem::path const file_path{ graph_path + "test_visit_binary_graph.bin" };
+        write_graph<BinaryDirectedUnweightedStatic>(file_path, edges, (Vertex64(1) << 40) + 1);
+
+        visit_binary_graph(file_path,
+                           [&](BinaryGraphHeader const& header, auto&& read_edges)
+                           {
+                               CHECK(requires_wide_edges(header));
+                               CHECK(std::is_same_v<std::decay_t<decltype(read_edges)>, Edges64>);
+                               using Traits = EdgeTraits<typename std::decay_t<decltype(read_edges)>::value_type>;
+                               REQUIRE(read_edges.size() == 2);
+                               CHECK(uint64_t(Traits::target(read_edges[0])) == edges[0].target);
+                           });
+
+        std::remove(file_path.c_str());
+    }
+}
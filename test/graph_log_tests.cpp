@@ -0,0 +1,165 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_graph.h"
+
+#include <gdsb/graph.h>
+#include <gdsb/graph_io_parameters.h>
+#include <gdsb/graph_log.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <future>
+
+using namespace gdsb;
+
+namespace
+{
+
+TimestampedEdge32 edge(Vertex32 u, Vertex32 v, Timestamp32 t) { return TimestampedEdge32{ Edge32{ u, v }, t }; }
+
+bool equal(TimestampedEdges32 const& a, TimestampedEdges32 const& b)
+{
+    return std::equal(std::begin(a), std::end(a), std::begin(b), std::end(b),
+                      [](TimestampedEdge32 const& x, TimestampedEdge32 const& y) {
+                          return x.edge.source == y.edge.source && x.edge.target == y.edge.target && x.timestamp == y.timestamp;
+                      });
+}
+
+} // namespace
+
+TEST_CASE("GraphLog, append, remove and compact")
+{
+    std::filesystem::path const directory{ graph_path + "test_graph_log" };
+    std::filesystem::remove_all(directory);
+
+    using Log = GraphLog<BinaryDirectedUnweightedDynamic, TimestampedEdge32>;
+    Log log(directory);
+
+    TimestampedEdges32 const base = { edge(0, 1, 1), edge(1, 2, 2), edge(2, 0, 3) };
+    CHECK(log.append(base) == 1u);
+    CHECK(log.append({ edge(0, 2, 4), edge(1, 2, 2) }, { EdgeOp::insert, EdgeOp::remove }) == 2u);
+
+    std::vector<SegmentFile> const segments = list_segments(directory);
+    REQUIRE(segments.size() == 2);
+    CHECK(segments[0].header.edge_count == 3);
+    CHECK(segments[0].header.min_timestamp == 1);
+    CHECK(segments[0].header.max_timestamp == 3);
+    CHECK(segments[1].header.vertex_id_byte_size == 1);
+
+    size_t op_count = 0;
+    size_t remove_count = 0;
+    log.for_each(
+        [&](TimestampedEdge32 const&, EdgeOp const op)
+        {
+            ++op_count;
+            remove_count += op == EdgeOp::remove;
+        });
+    CHECK(op_count == 5);
+    CHECK(remove_count == 1);
+
+    TimestampedEdges32 const expected = { edge(0, 1, 1), edge(2, 0, 3), edge(0, 2, 4) };
+    CHECK(equal(log.edges(), expected));
+
+    log.compact_async().get();
+    CHECK(list_segments(directory).empty());
+    CHECK(latest_base(directory).second == 2u);
+    CHECK(equal(log.edges(), expected));
+
+    // Appends continue after the compacted sequence, also for a reopened log.
+    Log reopened(directory);
+    CHECK(reopened.append({ edge(3, 0, 5) }) == 3u);
+    TimestampedEdges32 appended = expected;
+    appended.push_back(edge(3, 0, 5));
+    CHECK(equal(reopened.edges(), appended));
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("GraphLog, segment edge type mismatch")
+{
+    std::filesystem::path const directory{ graph_path + "test_graph_log_mismatch" };
+    std::filesystem::remove_all(directory);
+
+    GraphLog<BinaryDirectedUnweightedDynamic, TimestampedEdge32> log(directory);
+    log.append({ edge(0, 1, 1) });
+
+    GraphLog<BinaryDirectedUnweightedStatic, Edge32> static_log(directory);
+    CHECK_THROWS_AS(static_log.edges(), std::logic_error);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("GraphLog, concurrent append, read and compact")
+{
+    std::filesystem::path const directory{ graph_path + "test_graph_log_concurrent" };
+    std::filesystem::remove_all(directory);
+
+    using Log = GraphLog<BinaryDirectedUnweightedDynamic, TimestampedEdge32>;
+    Log log(directory);
+
+    size_t constexpr appender_count = 4;
+    size_t constexpr appends_per_appender = 25;
+    std::atomic<bool> appending{ true };
+
+    std::vector<std::future<void>> appenders;
+    for (size_t a = 0; a < appender_count; ++a)
+    {
+        appenders.push_back(std::async(std::launch::async,
+                                       [&, a]()
+                                       {
+                                           for (size_t i = 0; i < appends_per_appender; ++i)
+                                           {
+                                               Timestamp32 const t = Timestamp32(a * appends_per_appender + i);
+                                               log.append({ edge(Vertex32(a), Vertex32(i), t), edge(Vertex32(i), Vertex32(a), t) });
+                                           }
+                                       }));
+    }
+
+    // Results are checked after joining, Catch2 assertions are not thread safe.
+    auto reader = std::async(std::launch::async,
+                             [&]()
+                             {
+                                 size_t previous_size = 0;
+                                 bool grows = true;
+                                 while (appending)
+                                 {
+                                     size_t const size = log.edges().size();
+                                     grows = grows && size >= previous_size && size % 2 == 0;
+                                     previous_size = size;
+                                 }
+                                 return grows;
+                             });
+
+    auto compactor = std::async(std::launch::async,
+                                [&]()
+                                {
+                                    while (appending)
+                                    {
+                                        log.compact_async().get();
+                                    }
+                                });
+
+    for (std::future<void>& appender : appenders)
+    {
+        appender.get();
+    }
+    appending = false;
+
+    CHECK(reader.get());
+    compactor.get();
+    log.compact();
+
+    TimestampedEdges32 edges = log.edges();
+    CHECK(list_segments(directory).empty());
+    REQUIRE(edges.size() == 2 * appender_count * appends_per_appender);
+
+    std::sort(std::begin(edges), std::end(edges),
+              [](TimestampedEdge32 const& x, TimestampedEdge32 const& y) { return x.timestamp < y.timestamp; });
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        CHECK(edges[i].timestamp == Timestamp32(i / 2));
+    }
+
+    std::filesystem::remove_all(directory);
+}
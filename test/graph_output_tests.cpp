@@ -66,6 +66,10 @@ TEST_CASE("write_graph, enzymes, binary")
                                                                       sizeof(edge.target));
                                                           });
 
+    // The file holds the header and the edges only.
+    CHECK(std::filesystem::file_size(file_path) ==
+          sizeof(BinaryGraphHeaderIdentifier) + sizeof(BinaryGraphHeader) + expected_edge_count * sizeof(Edge32));
+
     // Now we read in the written graph and check if we read the expected data.
     std::ifstream binary_graph(file_path);
 
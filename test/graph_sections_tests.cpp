@@ -0,0 +1,100 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_graph.h"
+
+#include <gdsb/graph.h>
+#include <gdsb/graph_input.h>
+#include <gdsb/graph_io_parameters.h>
+#include <gdsb/graph_output.h>
+#include <gdsb/graph_sections.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace gdsb;
+
+TEST_CASE("serialize_sections")
+{
+    std::vector<BinaryGraphSection> sections(2);
+    sections[0].type = SectionType::statistics;
+    sections[0].data = { 1, 2, 3 };
+    sections[1].type = SectionType::degrees;
+    sections[1].data = { 4, 5 };
+
+    uint64_t const begin = 13;
+    std::vector<uint8_t> const bytes = serialize_sections(sections, begin);
+
+    std::stringstream file;
+    file << std::string(begin, 'x');
+    file.write(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+
+    std::vector<SectionEntry> const table = read_section_table(file);
+    REQUIRE(table.size() == 2);
+    CHECK(table[0].offset == 16);
+    CHECK(table[1].offset == 24);
+
+    std::optional<SectionEntry> const degrees = find_section(table, SectionType::degrees);
+    REQUIRE(degrees);
+    CHECK(read_section(file, *degrees) == sections[1].data);
+}
+
+TEST_CASE("write_graph, statistics, reptilia-tortoise-network-pv")
+{
+    TimestampedEdges32 edges;
+    auto emplace = [&](Vertex32 u, Vertex32 v, Timestamp32 t) { edges.push_back(TimestampedEdge32{ Edge32{ u, v }, t }); };
+    std::ifstream graph_input(graph_path + undirected_unweighted_temporal_reptilia_tortoise);
+    auto const [vertex_count, edge_count] =
+        read_graph<Vertex32, decltype(emplace), EdgeListUndirectedUnweightedLoopDynamic>(graph_input, std::move(emplace));
+
+    std::filesystem::path const file_path{ graph_path + "test_graph_statistics.bin" };
+    BinaryWriteOptions options;
+    options.degrees = true;
+    write_graph<BinaryUndirectedUnweightedDynamic>(file_path, edges, vertex_count, options);
+
+    std::ifstream binary_graph(file_path);
+    BinaryGraphHeader const header = read_binary_graph_header(binary_graph);
+    CHECK(header.has_sections);
+
+    std::optional<BinaryGraphStatistics> const statistics = read_binary_graph_statistics(binary_graph, header);
+    REQUIRE(statistics);
+    CHECK(statistics->vertex_count == gdsb::vertex_count(edges));
+    CHECK(statistics->edge_count == edges.size());
+    CHECK(statistics->max_degree == max_nnz(edges));
+    CHECK(!statistics->sorted_by_source);
+    // The maximum degree does not depend on computing the degree array.
+    CHECK(compute_statistics(edges.data(), edges.size()).max_degree == statistics->max_degree);
+
+    auto const [min_t, max_t] = std::minmax_element(std::begin(edges), std::end(edges),
+                                                    [](TimestampedEdge32 const& a, TimestampedEdge32 const& b)
+                                                    { return a.timestamp < b.timestamp; });
+    CHECK(statistics->min_timestamp == min_t->timestamp);
+    CHECK(statistics->max_timestamp == max_t->timestamp);
+
+    std::vector<Degree64> const degrees = read_binary_graph_degrees(binary_graph, header);
+    REQUIRE(degrees.size() == statistics->vertex_count);
+    Degree64 degree_sum = 0;
+    for (Degree64 const d : degrees)
+    {
+        degree_sum += d;
+    }
+    CHECK(degree_sum == edges.size());
+
+    // Reading the sections does not move the input away from the edges.
+    TimestampedEdges32 const edges_in = read_binary_edges<TimestampedEdge32>(binary_graph, header);
+    REQUIRE(edges_in.size() == edges.size());
+    CHECK(edges_in.back().timestamp == edges.back().timestamp);
+
+    REQUIRE(std::remove(file_path.c_str()) == 0);
+}
+
+TEST_CASE("read_binary_graph_statistics, version 3 file")
+{
+    std::ifstream binary_graph(graph_path + small_weighted_temporal_graph_bin);
+    BinaryGraphHeader const header = read_binary_graph_header(binary_graph);
+    CHECK(!header.has_sections);
+    CHECK(!read_binary_graph_statistics(binary_graph, header));
+    CHECK(read_binary_graph_degrees(binary_graph, header).empty());
+}
@@ -35,6 +35,19 @@ TEST_CASE("Vertex Counting")
 
         CHECK(vertex_count(edges) == 36);
     }
+
+    SECTION("Using unweighted temporal Edges")
+    {
+        TimestampedEdges32 edges{ { { 0, 4 }, 1 }, { { 2, 1 }, 2 }, { { 0, 3 }, 3 } };
+        CHECK(vertex_count(edges) == 5);
+    }
+}
+
+TEST_CASE("max_nnz")
+{
+    Edges32 edges{ { 3, 0 }, { 1, 2 }, { 3, 1 }, { 3, 2 }, { 1, 0 } };
+    CHECK(max_nnz(edges) == 3);
+    CHECK(max_nnz(Edges32{}) == 0);
 }
 
 TEST_CASE("Graph")
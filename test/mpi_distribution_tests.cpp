@@ -0,0 +1,444 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_graph.h"
+
+#include <gdsb/batcher.h>
+#include <gdsb/graph_input.h>
+#include <gdsb/graph_output.h>
+#include <gdsb/mpi_distribution.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <numeric>
+
+using namespace gdsb;
+
+namespace
+{
+
+// Reads reptilia and returns the slice of its edges of this process, as
+// all_read_binary_graph_partition() would, along with all edges.
+std::tuple<TimestampedEdges32, TimestampedEdges32, Vertex32> reptilia_slice(int const rank, int const size)
+{
+    TimestampedEdges32 edges;
+    auto emplace = [&](Vertex32 u, Vertex32 v, Timestamp32 t) { edges.push_back(TimestampedEdge32{ Edge32{ u, v }, t }); };
+    std::ifstream graph_input(graph_path + undirected_unweighted_temporal_reptilia_tortoise);
+    auto const [vertex_count, edge_count] =
+        read_graph<Vertex32, decltype(emplace), EdgeListUndirectedUnweightedLoopDynamic>(graph_input, std::move(emplace));
+
+    uint64_t const begin = batch_offset(edges.size(), rank, size);
+    TimestampedEdges32 slice(edges.begin() + begin, edges.begin() + begin + partition_batch_count(edges.size(), rank, size));
+    return { std::move(slice), std::move(edges), vertex_count };
+}
+
+bool equal_edges(TimestampedEdge32 const& a, TimestampedEdge32 const& b)
+{
+    return a.edge.source == b.edge.source && a.edge.target == b.edge.target && a.timestamp == b.timestamp;
+}
+
+} // namespace
+
+TEST_CASE("MPI, redistribute_edges, owners")
+{
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    auto const [slice, edges, vertex_count] = reptilia_slice(rank, size);
+
+    auto const check_redistribution = [&](auto const& owner)
+    {
+        TimestampedEdges32 const owned = mpi::redistribute_edges(slice, owner);
+
+        bool owner_correct = true;
+        for (TimestampedEdge32 const& e : owned)
+        {
+            owner_correct = owner_correct && owner(e.edge.source) == rank;
+        }
+        CHECK(owner_correct);
+        CHECK(std::is_sorted(owned.begin(), owned.end(), EdgeLess{}));
+
+        // This process owns exactly the edges of its source vertices.
+        TimestampedEdges32 expected;
+        std::copy_if(edges.begin(), edges.end(), std::back_inserter(expected),
+                     [&](TimestampedEdge32 const& e) { return owner(e.edge.source) == rank; });
+        std::sort(expected.begin(), expected.end(), EdgeLess{});
+        CHECK(std::equal(owned.begin(), owned.end(), expected.begin(), expected.end(), equal_edges));
+    };
+
+    SECTION("block") { check_redistribution(mpi::BlockOwner(vertex_count, size)); }
+    SECTION("hash") { check_redistribution(mpi::HashOwner(size)); }
+
+    SECTION("degree balanced")
+    {
+        mpi::RangeOwner const owner = mpi::degree_balanced_owner(slice, vertex_count);
+        CHECK(owner.vertex_begins().size() == size_t(size));
+        check_redistribution(owner);
+
+        // Ranges balance the edges up to the degree of a vertex.
+        std::vector<Degree64> const degrees = mpi::all_source_degrees(slice, vertex_count);
+        CHECK(std::accumulate(degrees.begin(), degrees.end(), Degree64(0)) == edges.size());
+        Degree64 const max_degree = *std::max_element(degrees.begin(), degrees.end());
+        uint64_t const owned = mpi::redistribute_edges(slice, owner).size();
+        CHECK(owned <= edges.size() / size + max_degree);
+    }
+
+    SECTION("invalid owner")
+    {
+        CHECK_THROWS_AS(mpi::redistribute_edges(slice, [&](uint64_t) { return size; }), std::out_of_range);
+    }
+}
+
+TEST_CASE("MPI, alltoallv, exchange in rounds")
+{
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // Process r sends r + p + 1 values to process p, value i being
+    // 1000 * r + i.
+    std::vector<uint64_t> send_counts(size);
+    std::vector<uint64_t> send_displacements(size, 0);
+    std::vector<uint64_t> receive_counts(size);
+    std::vector<uint64_t> receive_displacements(size, 0);
+    for (int p = 0; p < size; ++p)
+    {
+        send_counts[p] = uint64_t(rank + p + 1);
+        receive_counts[p] = uint64_t(p + rank + 1);
+        if (p > 0)
+        {
+            send_displacements[p] = send_displacements[p - 1] + send_counts[p - 1];
+            receive_displacements[p] = receive_displacements[p - 1] + receive_counts[p - 1];
+        }
+    }
+
+    std::vector<uint64_t> send;
+    for (int p = 0; p < size; ++p)
+    {
+        for (uint64_t i = 0; i < send_counts[p]; ++i)
+        {
+            send.push_back(1000u * uint64_t(rank) + i);
+        }
+    }
+
+    // Small maximum counts force exchanges in several rounds.
+    for (uint64_t const max_count : { uint64_t(std::numeric_limits<int>::max()), uint64_t(3), uint64_t(1) })
+    {
+        std::vector<uint64_t> receive(receive_displacements.back() + receive_counts.back(), 0);
+        mpi::alltoallv(send.data(), send_counts, send_displacements, receive.data(), receive_counts, receive_displacements,
+                       MPI_UINT64_T, MPI_COMM_WORLD, max_count);
+
+        bool equal = true;
+        for (int p = 0; p < size; ++p)
+        {
+            for (uint64_t i = 0; i < receive_counts[p]; ++i)
+            {
+                equal = equal && receive[receive_displacements[p] + i] == 1000u * uint64_t(p) + i;
+            }
+        }
+        CHECK(equal);
+    }
+}
+
+TEST_CASE("MPI, ProcessGrid, checkerboard blocks of enzymes")
+{
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    mpi::FileWrapper binary_graph{ std::filesystem::path(graph_path + directed_unweighted_graph_enzymes_bin) };
+    BinaryGraphHeader const header = mpi::read_binary_graph_header(binary_graph.get());
+
+    mpi::ProcessGrid const grid(header.vertex_count);
+    CHECK(grid.rows() * grid.columns() == size);
+    CHECK(grid.rows() <= grid.columns());
+    CHECK(grid.row() * grid.columns() + grid.column() == rank);
+    if (size == 4)
+    {
+        CHECK(grid.rows() == 2);
+        CHECK(grid.columns() == 2);
+    }
+
+    int row_size = 0;
+    int column_size = 0;
+    MPI_Comm_size(grid.row_comm(), &row_size);
+    MPI_Comm_size(grid.column_comm(), &column_size);
+    CHECK(row_size == grid.columns());
+    CHECK(column_size == grid.rows());
+
+    Edges32 const block = mpi::all_read_binary_graph_block<Edge32>(binary_graph.get(), header, grid);
+    bool owner_correct = true;
+    for (Edge32 const& e : block)
+    {
+        owner_correct = owner_correct && grid.vertex_row(e.source) == grid.row() && grid.vertex_column(e.target) == grid.column();
+    }
+    CHECK(owner_correct);
+    CHECK(std::is_sorted(block.begin(), block.end(), EdgeLess{}));
+
+    // The blocks of a row hold all edges of the sources of the row.
+    uint64_t row_edge_count = block.size();
+    MPI_Allreduce(MPI_IN_PLACE, &row_edge_count, 1, MPI_UINT64_T, MPI_SUM, grid.row_comm());
+    uint64_t edge_count = 0;
+    MPI_Allreduce(&row_edge_count, &edge_count, 1, MPI_UINT64_T, MPI_SUM, grid.column_comm());
+    CHECK(edge_count == header.edge_count);
+
+    std::ifstream input(graph_path + directed_unweighted_graph_enzymes_bin, std::ios::binary);
+    read_binary_graph_header(input);
+    Edges32 const edges = read_binary_edges<Edge32>(input, header);
+    CHECK(row_edge_count ==
+          uint64_t(std::count_if(edges.begin(), edges.end(), [&](Edge32 const& e) { return grid.vertex_row(e.source) == grid.row(); })));
+}
+
+TEST_CASE("MPI, SharedGraph, enzymes")
+{
+    std::ifstream input(graph_path + directed_unweighted_graph_enzymes_bin, std::ios::binary);
+    BinaryGraphHeader const header = read_binary_graph_header(input);
+    Edges32 const expected = read_binary_edges<Edge32>(input, header);
+
+    mpi::SharedGraph<Edge32> const graph(graph_path + directed_unweighted_graph_enzymes_bin);
+    CHECK(graph.header().vertex_count == header.vertex_count);
+    CHECK(graph.size() == expected.size());
+    CHECK(std::equal(graph.begin(), graph.end(), expected.begin(), expected.end(),
+                     [](Edge32 const& a, Edge32 const& b) { return a.source == b.source && a.target == b.target; }));
+
+    // All processes of this test run on one node, thus share one copy.
+    int size = 1;
+    int node_size = 0;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    MPI_Comm_size(graph.node_comm(), &node_size);
+    CHECK(node_size == size);
+
+    CHECK_THROWS_AS(mpi::SharedGraph<Edge32>(graph_path + "this_graph_does_not_exist.bin"), std::runtime_error);
+
+    SECTION("one copy per process")
+    {
+        // Every process leads a node of its own, thus the leaders broadcast
+        // their slices among each other.
+        mpi::SharedGraph<Edge32> const copies(graph_path + directed_unweighted_graph_enzymes_bin, MPI_COMM_WORLD, 1);
+        MPI_Comm_size(copies.node_comm(), &node_size);
+        CHECK(node_size == 1);
+        CHECK(std::equal(copies.begin(), copies.end(), expected.begin(), expected.end(),
+                         [](Edge32 const& a, Edge32 const& b) { return a.source == b.source && a.target == b.target; }));
+    }
+}
+
+TEST_CASE("MPI, SharedGraph, throws on all processes if one leader fails")
+{
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    // The file lacks the last edges, thus only the leader reading the last
+    // slice fails while the others read their slices.
+    std::filesystem::path const file_path{ graph_path + "test_shared_graph_truncated.bin" };
+    if (rank == 0)
+    {
+        std::filesystem::copy_file(graph_path + directed_unweighted_graph_enzymes_bin, file_path,
+                                   std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::resize_file(file_path, std::filesystem::file_size(file_path) - 2 * sizeof(Edge32));
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    CHECK_THROWS_AS(mpi::SharedGraph<Edge32>(file_path, MPI_COMM_WORLD, 1), std::runtime_error);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0)
+    {
+        std::filesystem::remove(file_path);
+    }
+}
+
+TEST_CASE("MPI, sample_sort, reptilia-tortoise-network-pv")
+{
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    auto const [slice, edges, vertex_count] = reptilia_slice(rank, size);
+
+    // Gathers the edges of all processes in rank order.
+    auto const all_edges = [&](TimestampedEdges32 const& local)
+    {
+        int const bytes = int(local.size() * sizeof(TimestampedEdge32));
+        std::vector<int> counts(size);
+        MPI_Allgather(&bytes, 1, MPI_INT, counts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+        std::vector<int> displacements(size, 0);
+        for (int r = 1; r < size; ++r)
+        {
+            displacements[r] = displacements[r - 1] + counts[r - 1];
+        }
+        TimestampedEdges32 gathered((displacements.back() + counts.back()) / sizeof(TimestampedEdge32));
+        MPI_Allgatherv(local.data(), bytes, MPI_BYTE, gathered.data(), counts.data(), displacements.data(), MPI_BYTE, MPI_COMM_WORLD);
+        return gathered;
+    };
+
+    auto const check_sorted = [&](auto const cmp, TimestampedEdges32 const& local)
+    {
+        TimestampedEdges32 const sorted = all_edges(local);
+        CHECK(std::is_sorted(sorted.begin(), sorted.end(), cmp));
+
+        // Same edges as before, compared in a total order.
+        TimestampedEdges32 a = sorted;
+        TimestampedEdges32 b = edges;
+        std::sort(a.begin(), a.end(), EdgeLess{});
+        std::sort(b.begin(), b.end(), EdgeLess{});
+        CHECK(std::equal(a.begin(), a.end(), b.begin(), b.end(), equal_edges));
+    };
+
+    SECTION("source") { check_sorted(SourceLess{}, mpi::sample_sort(slice, SourceLess{})); }
+    SECTION("source, target") { check_sorted(EdgeLess{}, mpi::sample_sort(slice)); }
+    SECTION("timestamp") { check_sorted(TimestampLess{}, mpi::sample_sort(slice, TimestampLess{})); }
+
+    SECTION("all edges on one process, few samples")
+    {
+        TimestampedEdges32 const local = rank == 0 ? edges : TimestampedEdges32{};
+        check_sorted(TimestampLess{}, mpi::sample_sort(local, TimestampLess{}, MPI_COMM_WORLD, 2));
+    }
+
+    SECTION("fewer samples than processes")
+    {
+        // Two samples in total yield fewer splitters than processes from three
+        // processes on.
+        TimestampedEdges32 const few(edges.begin(), edges.begin() + 2);
+        TimestampedEdges32 const local = rank == 0 ? few : TimestampedEdges32{};
+        TimestampedEdges32 const sorted = all_edges(mpi::sample_sort(local, TimestampLess{}));
+        CHECK(std::is_sorted(sorted.begin(), sorted.end(), TimestampLess{}));
+        CHECK(std::is_permutation(sorted.begin(), sorted.end(), few.begin(), few.end(), equal_edges));
+    }
+
+    SECTION("no samples")
+    {
+        CHECK_THROWS_AS(mpi::sample_sort(slice, TimestampLess{}, MPI_COMM_WORLD, 0), std::invalid_argument);
+    }
+
+    SECTION("no edges")
+    {
+        TimestampedEdges32 const sorted = mpi::sample_sort(TimestampedEdges32{});
+        CHECK(sorted.empty());
+    }
+
+    SECTION("collective write of the sorted edges")
+    {
+        TimestampedEdges32 const sorted = mpi::sample_sort(slice, TimestampLess{});
+        std::filesystem::path const file_path{ graph_path + "test_graph_mpi_sample_sort.bin" };
+        {
+            mpi::FileWrapper output{ file_path, true };
+            mpi::all_write_binary_graph<BinaryUndirectedUnweightedDynamic>(output.get(), sorted, vertex_count);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        std::ifstream input(file_path, std::ios::binary);
+        BinaryGraphHeader const header = read_binary_graph_header(input);
+        TimestampedEdges32 const read = read_binary_edges<TimestampedEdge32>(input, header);
+        CHECK(read.size() == edges.size());
+        CHECK(std::is_sorted(read.begin(), read.end(), TimestampLess{}));
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        if (rank == 0)
+        {
+            std::remove(file_path.c_str());
+        }
+    }
+}
+
+TEST_CASE("parallel_sort, merge_runs")
+{
+    std::vector<uint64_t> values(10007);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        values[i] = (i * 7919u) % 1009u;
+    }
+
+    std::vector<uint64_t> sorted = values;
+    mpi::parallel_sort(sorted.begin(), sorted.end(), std::less<uint64_t>{});
+    CHECK(std::is_sorted(sorted.begin(), sorted.end()));
+
+    // Five sorted runs, one of them empty.
+    std::vector<uint64_t> runs = values;
+    std::vector<uint64_t> const run_begins{ 0, 10, 10, 3000, 7000 };
+    for (size_t r = 0; r < run_begins.size(); ++r)
+    {
+        std::sort(runs.begin() + run_begins[r], r + 1 < run_begins.size() ? runs.begin() + run_begins[r + 1] : runs.end());
+    }
+    mpi::merge_runs(runs.begin(), runs.end(), run_begins, std::less<uint64_t>{});
+    CHECK(runs == sorted);
+}
+
+TEST_CASE("MPI, symmetrize_edges, enzymes")
+{
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    mpi::FileWrapper binary_graph{ std::filesystem::path(graph_path + directed_unweighted_graph_enzymes_bin) };
+    BinaryGraphHeader const header = mpi::read_binary_graph_header(binary_graph.get());
+    Edges32 slice = mpi::all_read_binary_graph_partition<Edge32>(binary_graph.get(), header, rank, size);
+
+    // A self loop and a duplicate edge on every process.
+    slice.push_back(Edge32{ 3, 3 });
+    slice.push_back(Edge32{ 2, 1 });
+
+    std::ifstream input(graph_path + directed_unweighted_graph_enzymes_bin, std::ios::binary);
+    read_binary_graph_header(input);
+    Edges32 const edges = read_binary_edges<Edge32>(input, header);
+
+    auto const check_symmetrization = [&](auto const& owner)
+    {
+        Edges32 const symmetric = mpi::symmetrize_edges(slice, owner);
+
+        Edges32 expected;
+        for (Edge32 const& e : edges)
+        {
+            if (e.source != e.target)
+            {
+                expected.push_back(e);
+                expected.push_back(Edge32{ e.target, e.source });
+            }
+        }
+        expected.push_back(Edge32{ 1, 2 });
+        expected.push_back(Edge32{ 2, 1 });
+        std::sort(expected.begin(), expected.end(), EdgeLess{});
+        expected.erase(std::unique(expected.begin(), expected.end(),
+                                   [](Edge32 const& a, Edge32 const& b) { return a.source == b.source && a.target == b.target; }),
+                       expected.end());
+        expected.erase(std::remove_if(expected.begin(), expected.end(), [&](Edge32 const& e) { return owner(e.source) != rank; }),
+                       expected.end());
+
+        CHECK(std::equal(symmetric.begin(), symmetric.end(), expected.begin(), expected.end(),
+                         [](Edge32 const& a, Edge32 const& b) { return a.source == b.source && a.target == b.target; }));
+    };
+
+    SECTION("block") { check_symmetrization(mpi::BlockOwner(header.vertex_count, size)); }
+    SECTION("hash") { check_symmetrization(mpi::HashOwner(size)); }
+}
+
+TEST_CASE("MPI, symmetrize_edges, keeps the earliest of temporal duplicates")
+{
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // Every process holds (0, 1) at time 10 + rank and (1, 0) at time 5 + rank.
+    TimestampedEdges32 const local{ TimestampedEdge32{ Edge32{ 0, 1 }, Timestamp32(10 + rank) },
+                                    TimestampedEdge32{ Edge32{ 1, 0 }, Timestamp32(5 + rank) } };
+    TimestampedEdges32 const symmetric = mpi::symmetrize_edges(local, mpi::BlockOwner(2, size));
+
+    uint64_t count = symmetric.size();
+    MPI_Allreduce(MPI_IN_PLACE, &count, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+    CHECK(count == 2u);
+
+    bool earliest = true;
+    for (TimestampedEdge32 const& e : symmetric)
+    {
+        earliest = earliest && e.timestamp == 5u;
+    }
+    CHECK(earliest);
+}
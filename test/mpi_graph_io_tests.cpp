@@ -8,7 +8,9 @@
 #include <gdsb/batcher.h>
 #include <gdsb/mpi_error_handler.h>
 #include <gdsb/mpi_graph_io.h>
+#include <gdsb/graph_output.h>
 
+#include <cstdio>
 #include <filesystem>
 
 using namespace gdsb;
@@ -288,6 +290,24 @@ TEST_CASE("MPI, register structs")
     SECTION("register_weighted_edge_32") { CHECK_NOTHROW(mpi::MPIWeightedEdge32()); }
 
     SECTION("register_edge_32") { CHECK_NOTHROW(mpi::MPIEdge32()); }
+
+    SECTION("register_timestamped_edge_32") { CHECK_NOTHROW(mpi::MPITimestampedEdge32()); }
+
+    SECTION("register_64 bit edges")
+    {
+        CHECK_NOTHROW(mpi::MPIEdge64());
+        CHECK_NOTHROW(mpi::MPIWeightedEdge64());
+        CHECK_NOTHROW(mpi::MPITimestampedEdge64());
+        CHECK_NOTHROW(mpi::MPIWeightedTimestampedEdge64());
+    }
+
+    SECTION("extent matches the edge type")
+    {
+        MPI_Aint lower_bound = 0;
+        MPI_Aint extent = 0;
+        MPI_Type_get_extent(mpi::MPIWeightedTimestampedEdge64().get(), &lower_bound, &extent);
+        CHECK(extent == MPI_Aint(sizeof(WeightedTimestampedEdge64)));
+    }
 }
 
 TEST_CASE("MPI, handle_type_create_struct_error, throws when expected")
@@ -1023,11 +1043,23 @@ TEST_CASE("MPI, all_read_binary_graph_batch, read issues")
         CHECK(read_batch.count_read_in_edges == header.edge_count);
     }
 
-    SECTION("Read exceeds counter")
+    SECTION("Batch size exceeds the int count type")
     {
         Edges32 edges(header.edge_count);
         read_batch.batch_size = std::numeric_limits<uint32_t>::max();
-        CHECK_THROWS(mpi::all_read_binary_graph_batch(binary_graph.get(), header, &(edges[0]), read_batch, mpi_edge_t.get()));
+        CHECK_NOTHROW(mpi::all_read_binary_graph_batch(binary_graph.get(), header, &(edges[0]), read_batch, mpi_edge_t.get()));
+        CHECK(read_batch.count_read_in_edges == header.edge_count);
+    }
+
+    SECTION("Header declares more edges than the file holds")
+    {
+        BinaryGraphHeader truncated_header = header;
+        truncated_header.edge_count = header.edge_count + 10;
+        read_batch.batch_size = truncated_header.edge_count;
+        Edges32 edges(truncated_header.edge_count);
+        CHECK_THROWS_AS(mpi::all_read_binary_graph_batch(binary_graph.get(), truncated_header, &(edges[0]), read_batch, mpi_edge_t.get()),
+                        std::runtime_error);
+        CHECK(read_batch.count_read_in_edges == 0);
     }
 
     SECTION("Read exceeds counter")
@@ -1038,4 +1070,485 @@ TEST_CASE("MPI, all_read_binary_graph_batch, read issues")
         CHECK(edges[header.edge_count].source == 0u);
         CHECK(read_batch.count_read_in_edges == header.edge_count);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("MPI, all_read_binary_graph_partition, vertex partitions, enzymes")
+{
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    std::filesystem::path const file_path{ graph_path + "test_graph_mpi_vertex_partitions.bin" };
+
+    if (rank == 0)
+    {
+        Edges32 edges;
+        auto emplace = [&](Vertex32 u, Vertex32 v) { edges.push_back(Edge32{ u, v }); };
+        std::ifstream graph_input(graph_path + unweighted_directed_graph_enzymes);
+        auto const [vertex_count, edge_count] =
+            read_graph<Vertex32, decltype(emplace), EdgeListDirectedUnweightedNoLoopStatic>(graph_input, std::move(emplace));
+        gdsb::sort<Edge32>(std::begin(edges), std::end(edges));
+
+        BinaryWriteOptions options;
+        options.narrow_widths = false;
+        write_graph<BinaryDirectedUnweightedStatic>(file_path, edges, vertex_count, options);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    std::vector<VertexPartition> const partitions = mpi::read_vertex_partitions(file_path, size);
+    REQUIRE(partitions.size() == size_t(size));
+    VertexPartition const& partition = partitions[rank];
+
+    {
+        mpi::FileWrapper input{ file_path };
+        BinaryGraphHeader const header = mpi::read_binary_graph_header(input.get());
+
+        Edges32 edges(partition.edge_count());
+        mpi::MPIEdge32 mpi_edge_t;
+        mpi::all_read_binary_graph_partition(input.get(), header, edges.data(), sizeof(Edge32), mpi_edge_t.get(), partition);
+
+        for (Edge32 const& e : edges)
+        {
+            CHECK(e.source >= partition.vertex_begin);
+            CHECK(e.source < partition.vertex_end);
+        }
+
+        uint64_t const local_edge_count = edges.size();
+        uint64_t edge_count = 0;
+        MPI_Allreduce(&local_edge_count, &edge_count, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+        CHECK(edge_count == header.edge_count);
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0)
+    {
+        std::remove(file_path.c_str());
+    }
+}
+
+TEST_CASE("MPI, all_read_binary_edges, EdgeFilter, enzymes")
+{
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    std::filesystem::path const file_path{ graph_path + "test_graph_mpi_edge_filter.bin" };
+
+    Edges32 edges;
+    auto emplace = [&](Vertex32 u, Vertex32 v) { edges.push_back(Edge32{ u, v }); };
+    std::ifstream graph_input(graph_path + unweighted_directed_graph_enzymes);
+    auto const [vertex_count, edge_count] =
+        read_graph<Vertex32, decltype(emplace), EdgeListDirectedUnweightedNoLoopStatic>(graph_input, std::move(emplace));
+    gdsb::sort<Edge32>(std::begin(edges), std::end(edges));
+
+    if (rank == 0)
+    {
+        write_graph<BinaryDirectedUnweightedStatic>(file_path, edges, vertex_count);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    EdgeFilter const filter = EdgeFilter{}.sources(5, 20).targets(0, 30);
+    Edges32 const local_edges = mpi::all_read_binary_edges<Edge32>(file_path, filter);
+
+    bool all_match = true;
+    for (Edge32 const& e : local_edges)
+    {
+        all_match = all_match && filter(e);
+    }
+    CHECK(all_match);
+
+    uint64_t const local_edge_count = local_edges.size();
+    uint64_t matching_edge_count = 0;
+    MPI_Allreduce(&local_edge_count, &matching_edge_count, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+    CHECK(matching_edge_count == uint64_t(std::count_if(std::begin(edges), std::end(edges), filter)));
+
+    CHECK_THROWS_AS(mpi::all_read_binary_edges<Edge32>(file_path, EdgeFilter{}.window(0, 1)), std::logic_error);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0)
+    {
+        std::remove(file_path.c_str());
+    }
+}
+
+TEST_CASE("MPI, all_read_binary_graph_partition, all edge types, reptilia-tortoise-network-pv")
+{
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    WeightedTimestampedEdges64 edges;
+    auto emplace = [&](Vertex32 u, Vertex32 v, Timestamp32 t)
+    { edges.push_back(WeightedTimestampedEdge64{ WeightedEdge64{ u, { v, float(u + v) / 2.f } }, t }); };
+    std::ifstream graph_input(graph_path + undirected_unweighted_temporal_reptilia_tortoise);
+    auto const [vertex_count, edge_count] =
+        read_graph<Vertex32, decltype(emplace), EdgeListUndirectedUnweightedLoopDynamic>(graph_input, std::move(emplace));
+
+    uint64_t const begin = batch_offset(edges.size(), rank, size);
+    uint64_t const count = partition_batch_count(edges.size(), rank, size);
+
+    auto equal_part = [&](auto const& part)
+    {
+        using Traits = EdgeTraits<typename std::decay_t<decltype(part)>::value_type>;
+        bool equal = part.size() == count;
+        for (size_t i = 0; equal && i < part.size(); ++i)
+        {
+            WeightedTimestampedEdge64 const& e = edges[begin + i];
+            equal = uint64_t(Traits::source(part[i])) == e.edge.source && uint64_t(Traits::target(part[i])) == e.edge.target.vertex &&
+                uint64_t(Traits::timestamp(part[i])) == e.timestamp;
+        }
+        return equal;
+    };
+
+    std::filesystem::path const file_path{ graph_path + "test_graph_mpi_edge_types.bin" };
+    for (bool const narrow_widths : { false, true })
+    {
+        if (rank == 0)
+        {
+            BinaryWriteOptions options;
+            options.narrow_widths = narrow_widths;
+            write_graph<BinaryUndirectedWeightedDynamic>(file_path, edges, vertex_count, options);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        {
+            mpi::FileWrapper input{ file_path };
+            BinaryGraphHeader const header = mpi::read_binary_graph_header(input.get());
+
+            // Native byte sizes are read using the committed data type,
+            // narrow ones are decoded.
+            WeightedTimestampedEdges64 const part =
+                mpi::all_read_binary_graph_partition<WeightedTimestampedEdge64>(input.get(), header, rank, size);
+            CHECK(equal_part(part));
+            bool weights_equal = true;
+            for (size_t i = 0; i < part.size(); ++i)
+            {
+                weights_equal = weights_equal && part[i].edge.target.weight == edges[begin + i].edge.target.weight;
+            }
+            CHECK(weights_equal);
+
+            if (narrow_widths)
+            {
+                CHECK(equal_part(mpi::all_read_binary_graph_partition<WeightedTimestampedEdge32>(input.get(), header, rank, size)));
+            }
+        }
+
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+
+    if (rank == 0)
+    {
+        std::remove(file_path.c_str());
+    }
+}
+
+TEST_CASE("MPI, read_all, count exceeds max count")
+{
+    std::filesystem::path file_path(graph_path + directed_unweighted_graph_enzymes_bin);
+    mpi::FileWrapper binary_graph{ file_path };
+    BinaryGraphHeader const header = mpi::read_binary_graph_header(binary_graph.get());
+    REQUIRE(header.vertex_id_byte_size == sizeof(Vertex32));
+
+    std::ifstream input(file_path, std::ios::binary);
+    read_binary_graph_header(input);
+    Edges32 const expected = read_binary_edges<Edge32>(input, header);
+
+    // Forces the composed derived datatype of chunks of 10 edges plus the
+    // remaining edges, as used for counts beyond the int count type.
+    mpi::MPIEdge32 mpi_edge_t;
+    Edges32 edges(header.edge_count);
+    mpi::read_all(binary_graph.get(), edges.data(), edges.size(), mpi_edge_t.get(), 10);
+
+    bool equal = true;
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        equal = equal && edges[i].source == expected[i].source && edges[i].target == expected[i].target;
+    }
+    CHECK(equal);
+
+    // Nothing is left to read.
+    CHECK_THROWS_AS(mpi::read_all(binary_graph.get(), edges.data(), 25, mpi_edge_t.get(), 10), std::runtime_error);
+}
+
+TEST_CASE("MPI, BatchPrefetcher, reptilia-tortoise-network-pv")
+{
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    TimestampedEdges32 edges;
+    auto emplace = [&](Vertex32 u, Vertex32 v, Timestamp32 t) { edges.push_back(TimestampedEdge32{ Edge32{ u, v }, t }); };
+    std::ifstream graph_input(graph_path + undirected_unweighted_temporal_reptilia_tortoise);
+    auto const [vertex_count, edge_count] =
+        read_graph<Vertex32, decltype(emplace), EdgeListUndirectedUnweightedLoopDynamic>(graph_input, std::move(emplace));
+
+    // Ranges of different length, thus processes read different batch counts.
+    uint64_t const begin = batch_offset(edges.size(), rank, size);
+    uint64_t const end = begin + partition_batch_count(edges.size(), rank, size) / uint64_t(rank + 1);
+
+    std::filesystem::path const file_path{ graph_path + "test_graph_mpi_batch_prefetcher.bin" };
+    for (bool const narrow_widths : { false, true })
+    {
+        if (rank == 0)
+        {
+            BinaryWriteOptions options;
+            options.narrow_widths = narrow_widths;
+            write_graph<BinaryUndirectedUnweightedDynamic>(file_path, edges, vertex_count, options);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        {
+            mpi::FileWrapper input{ file_path };
+            BinaryGraphHeader const header = mpi::read_binary_graph_header(input.get());
+
+            for (unsigned const buffer_count : { 2u, 3u })
+            {
+                mpi::BatchPrefetcher<TimestampedEdge32> batches(input.get(), header, begin, end, 97, buffer_count);
+                CHECK(batches.batch_count() == (partition_batch_count(edges.size(), 0, size) + 96) / 97);
+
+                TimestampedEdges32 read;
+                uint64_t batch_count = 0;
+                bool offsets_equal = true;
+                while (batches.next())
+                {
+                    offsets_equal = offsets_equal && (batches.edges().empty() || batches.offset() == begin + read.size());
+                    read.insert(read.end(), batches.edges().begin(), batches.edges().end());
+                    ++batch_count;
+                }
+                CHECK(batch_count == batches.batch_count());
+                CHECK(offsets_equal);
+
+                bool equal = read.size() == end - begin;
+                for (size_t i = 0; equal && i < read.size(); ++i)
+                {
+                    TimestampedEdge32 const& e = edges[begin + i];
+                    equal = read[i].edge.source == e.edge.source && read[i].edge.target == e.edge.target && read[i].timestamp == e.timestamp;
+                }
+                CHECK(equal);
+                CHECK_THROWS_AS(batches.edges(), std::logic_error);
+            }
+
+            CHECK_THROWS_AS(mpi::BatchPrefetcher<TimestampedEdge32>(input.get(), header, begin, end, 97, 1), std::invalid_argument);
+            CHECK_THROWS_AS(mpi::BatchPrefetcher<TimestampedEdge32>(input.get(), header, 0, header.edge_count + 1, 97),
+                            std::out_of_range);
+        }
+
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+
+    if (rank == 0)
+    {
+        std::remove(file_path.c_str());
+    }
+}
+
+TEST_CASE("MPI, all_write_binary_graph, reptilia-tortoise-network-pv")
+{
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    TimestampedEdges32 edges;
+    auto emplace = [&](Vertex32 u, Vertex32 v, Timestamp32 t) { edges.push_back(TimestampedEdge32{ Edge32{ u, v }, t }); };
+    std::ifstream graph_input(graph_path + undirected_unweighted_temporal_reptilia_tortoise);
+    auto const [vertex_count, edge_count] =
+        read_graph<Vertex32, decltype(emplace), EdgeListUndirectedUnweightedLoopDynamic>(graph_input, std::move(emplace));
+
+    // Parts of different sizes.
+    auto const part_begin = [&](int r) { return edges.size() * uint64_t(r) * uint64_t(r) / (uint64_t(size) * uint64_t(size)); };
+    TimestampedEdges32 const part(edges.begin() + part_begin(rank), edges.begin() + part_begin(rank + 1));
+
+    std::filesystem::path const file_path{ graph_path + "test_graph_mpi_write.bin" };
+    for (bool const narrow_widths : { false, true })
+    {
+        BinaryWriteStatistics statistics;
+        {
+            mpi::FileWrapper output{ file_path, true };
+            statistics = mpi::all_write_binary_graph<BinaryUndirectedUnweightedDynamic>(output.get(), part, vertex_count, narrow_widths);
+        }
+        CHECK(statistics.edge_count == edges.size());
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        std::ifstream input(file_path, std::ios::binary);
+        BinaryGraphHeader const header = read_binary_graph_header(input);
+        CHECK(header.vertex_count == vertex_count);
+        CHECK(header.edge_count == edges.size());
+        CHECK(header.dynamic);
+        CHECK(!header.directed);
+        CHECK(header.vertex_id_byte_size == (narrow_widths ? 1u : sizeof(Vertex32)));
+        CHECK(std::filesystem::file_size(file_path) == 32u + statistics.edge_bytes);
+
+        TimestampedEdges32 const read = read_binary_edges<TimestampedEdge32>(input, header);
+        bool equal = read.size() == edges.size();
+        for (size_t i = 0; equal && i < read.size(); ++i)
+        {
+            equal = read[i].edge.source == edges[i].edge.source && read[i].edge.target == edges[i].edge.target &&
+                read[i].timestamp == edges[i].timestamp;
+        }
+        CHECK(equal);
+
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+
+    if (rank == 0)
+    {
+        std::remove(file_path.c_str());
+    }
+}
+
+TEST_CASE("MPI, all_read_graph, text graphs")
+{
+    int size = 1;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // Gathers the edges read by all processes in rank order.
+    auto const all_edges = [&](auto const& local)
+    {
+        using Edge_t = typename std::decay_t<decltype(local)>::value_type;
+        int const bytes = int(local.size() * sizeof(Edge_t));
+        std::vector<int> counts(size);
+        MPI_Allgather(&bytes, 1, MPI_INT, counts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+        std::vector<int> displacements(size, 0);
+        for (int r = 1; r < size; ++r)
+        {
+            displacements[r] = displacements[r - 1] + counts[r - 1];
+        }
+        std::vector<Edge_t> edges((displacements.back() + counts.back()) / sizeof(Edge_t));
+        MPI_Allgatherv(local.data(), bytes, MPI_BYTE, edges.data(), counts.data(), displacements.data(), MPI_BYTE, MPI_COMM_WORLD);
+        return edges;
+    };
+
+    SECTION("edge list, undirected, unweighted, dynamic")
+    {
+        TimestampedEdges32 expected;
+        auto emplace = [&](Vertex32 u, Vertex32 v, Timestamp32 t) { expected.push_back(TimestampedEdge32{ Edge32{ u, v }, t }); };
+        std::ifstream input(graph_path + undirected_unweighted_temporal_reptilia_tortoise);
+        auto const [vertex_count, edge_count] =
+            read_graph<Vertex32, decltype(emplace), EdgeListUndirectedUnweightedLoopDynamic>(input, std::move(emplace));
+
+        TimestampedEdges32 local;
+        auto const [n, m] =
+            mpi::all_read_graph<EdgeListUndirectedUnweightedLoopDynamic>(graph_path + undirected_unweighted_temporal_reptilia_tortoise, local);
+        CHECK(n == vertex_count);
+        CHECK(m == edge_count);
+
+        TimestampedEdges32 const edges = all_edges(local);
+        bool equal = edges.size() == expected.size();
+        for (size_t i = 0; equal && i < edges.size(); ++i)
+        {
+            equal = edges[i].edge.source == expected[i].edge.source && edges[i].edge.target == expected[i].edge.target &&
+                edges[i].timestamp == expected[i].timestamp;
+        }
+        CHECK(equal);
+    }
+
+    SECTION("edge list, undirected, weighted")
+    {
+        WeightedEdges32 expected;
+        auto emplace = [&](Vertex32 u, Vertex32 v, Weight w) { expected.push_back(WeightedEdge32{ u, { v, w } }); };
+        std::ifstream input(graph_path + undirected_weighted_aves_songbird_social);
+        auto const [vertex_count, edge_count] =
+            read_graph<Vertex32, decltype(emplace), EdgeListUndirectedWeightedNoLoopStatic>(input, std::move(emplace));
+
+        WeightedEdges32 local;
+        auto const [n, m] =
+            mpi::all_read_graph<EdgeListUndirectedWeightedNoLoopStatic>(graph_path + undirected_weighted_aves_songbird_social, local);
+        CHECK(n == vertex_count);
+        CHECK(m == edge_count);
+
+        WeightedEdges32 const edges = all_edges(local);
+        bool equal = edges.size() == expected.size();
+        for (size_t i = 0; equal && i < edges.size(); ++i)
+        {
+            equal = edges[i].source == expected[i].source && edges[i].target.vertex == expected[i].target.vertex &&
+                edges[i].target.weight == expected[i].target.weight;
+        }
+        CHECK(equal);
+    }
+
+    SECTION("edge list, loops")
+    {
+        for (bool const loops : { true, false })
+        {
+            uint64_t edge_count_expected = 0;
+            auto emplace = [&](Vertex32, Vertex32) { ++edge_count_expected; };
+            std::ifstream input(graph_path + undirected_unweighted_loops_ia_southernwomen);
+            auto const [vertex_count, edge_count] = loops
+                ? read_graph<Vertex32, decltype(emplace), EdgeListUndirectedUnweightedLoopStatic>(input, std::move(emplace))
+                : read_graph<Vertex32, decltype(emplace), EdgeListUndirectedUnweightedNoLoopStatic>(input, std::move(emplace));
+
+            Edges32 local;
+            auto const [n, m] = loops
+                ? mpi::all_read_graph<EdgeListUndirectedUnweightedLoopStatic>(graph_path + undirected_unweighted_loops_ia_southernwomen, local)
+                : mpi::all_read_graph<EdgeListUndirectedUnweightedNoLoopStatic>(graph_path + undirected_unweighted_loops_ia_southernwomen, local);
+            CHECK(n == vertex_count);
+            CHECK(m == edge_count);
+            CHECK(all_edges(local).size() == edge_count_expected);
+        }
+    }
+
+    SECTION("matrix market, directed")
+    {
+        Edges32 expected;
+        auto emplace = [&](Vertex32 u, Vertex32 v) { expected.push_back(Edge32{ u, v }); };
+        std::ifstream input(graph_path + undirected_unweighted_soc_dolphins);
+        auto const [vertex_count, edge_count] =
+            read_graph<Vertex32, decltype(emplace), MatrixMarketDirectedUnweightedNoLoopStatic>(input, std::move(emplace));
+
+        Edges32 local;
+        auto const [n, m] = mpi::all_read_graph<MatrixMarketDirectedUnweightedNoLoopStatic>(graph_path + undirected_unweighted_soc_dolphins, local);
+        CHECK(n == vertex_count);
+        CHECK(m == edge_count);
+
+        Edges32 const edges = all_edges(local);
+        bool equal = edges.size() == expected.size();
+        for (size_t i = 0; equal && i < edges.size(); ++i)
+        {
+            equal = edges[i].source == expected[i].source && edges[i].target == expected[i].target;
+        }
+        CHECK(equal);
+    }
+}
+
+TEST_CASE("MPI, all_read_text_lines, lines spanning several processes")
+{
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    std::string const text = "% " + std::string(300, 'x') + "\n1 2\n\n3 4 " + std::string(200, ' ') + "5\n6 7";
+    std::filesystem::path const file_path{ graph_path + "test_mpi_text_lines.edges" };
+    if (rank == 0)
+    {
+        std::ofstream output(file_path, std::ios::binary);
+        output << text;
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    std::vector<char> const local = mpi::all_read_text_lines(file_path);
+    CHECK((local.empty() || local.back() == '\n'));
+
+    int const local_size = int(local.size());
+    int size = 1;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    std::vector<int> sizes(size);
+    MPI_Allgather(&local_size, 1, MPI_INT, sizes.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    std::vector<int> displacements(size, 0);
+    for (int r = 1; r < size; ++r)
+    {
+        displacements[r] = displacements[r - 1] + sizes[r - 1];
+    }
+    std::string lines(displacements.back() + sizes.back(), '\0');
+    MPI_Allgatherv(local.data(), local_size, MPI_CHAR, lines.data(), sizes.data(), displacements.data(), MPI_CHAR, MPI_COMM_WORLD);
+
+    // Only the last line gets its newline appended.
+    CHECK(lines == text + "\n");
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0)
+    {
+        std::remove(file_path.c_str());
+    }
+}
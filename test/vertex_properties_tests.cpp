@@ -0,0 +1,92 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "test_graph.h"
+
+#include <gdsb/graph.h>
+#include <gdsb/graph_input.h>
+#include <gdsb/graph_io_parameters.h>
+#include <gdsb/graph_output.h>
+#include <gdsb/vertex_properties.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace gdsb;
+
+TEST_CASE("vertex properties, ENZYMES_g1")
+{
+    Edges32 edges;
+    auto emplace = [&](Vertex32 u, Vertex32 v) { edges.push_back(Edge32{ u, v }); };
+    std::ifstream graph_input(graph_path + unweighted_directed_graph_enzymes);
+    auto const [vertex_count, edge_count] =
+        read_graph<Vertex32, decltype(emplace), EdgeListDirectedUnweightedNoLoopStatic>(graph_input, std::move(emplace));
+
+    // Labels as stored by text label files, see read_labels().
+    std::stringstream label_input;
+    for (Vertex32 v = 0; v < vertex_count; ++v)
+    {
+        label_input << v << " " << v % 3 << "\n";
+    }
+    std::vector<uint32_t> labels(vertex_count);
+    read_labels<Vertex32, uint32_t>(label_input, [&](Vertex32 v, uint32_t l) { labels[v] = l; });
+
+    std::vector<double> weights(vertex_count);
+    std::vector<int16_t> offsets(vertex_count);
+    for (Vertex32 v = 0; v < vertex_count; ++v)
+    {
+        weights[v] = 0.5 * v;
+        offsets[v] = int16_t(v) - 10;
+    }
+
+    std::filesystem::path const file_path{ graph_path + "test_vertex_properties.bin" };
+    BinaryWriteOptions options;
+    options.sections.push_back(make_vertex_property_section("label", labels));
+    options.sections.push_back(make_vertex_property_section("weight", weights));
+    options.sections.push_back(make_vertex_property_section("offset", offsets));
+    write_graph<BinaryDirectedUnweightedStatic>(file_path, edges, vertex_count, options);
+
+    CHECK_THROWS_AS(make_vertex_property_section("a_vertex_property_name_of_32_chars", labels), std::invalid_argument);
+
+    SECTION("read_vertex_property")
+    {
+        std::ifstream input(file_path, std::ios::binary);
+        BinaryGraphHeader const header = read_binary_graph_header(input);
+
+        std::vector<VertexPropertyHeader> const headers = read_vertex_property_headers(input, header);
+        REQUIRE(headers.size() == 3);
+        CHECK(std::string(headers[1].name) == "weight");
+        CHECK(headers[1].type == VertexPropertyType::floating_point);
+        CHECK(headers[1].count == vertex_count);
+
+        CHECK(read_vertex_property<uint32_t>(input, header, "label") == labels);
+        CHECK(read_vertex_property<double>(input, header, "weight") == weights);
+        CHECK_THROWS_AS(read_vertex_property<float>(input, header, "weight"), std::logic_error);
+        CHECK_THROWS_AS(read_vertex_property<uint32_t>(input, header, "color"), std::out_of_range);
+
+        // The statistics and the edges are not affected by the columns.
+        CHECK(read_binary_graph_statistics(input, header)->edge_count == edges.size());
+        CHECK(read_binary_edges<Edge32>(input, header).size() == edges.size());
+    }
+
+    SECTION("MappedVertexProperties")
+    {
+        MappedVertexProperties const properties(file_path);
+        CHECK(properties.names() == std::vector<std::string>{ "label", "weight", "offset" });
+        CHECK(properties.contains("offset"));
+        CHECK(!properties.contains("color"));
+
+        VertexPropertyColumn<int16_t> const offset_column = properties.column<int16_t>("offset");
+        REQUIRE(offset_column.size() == vertex_count);
+        CHECK(std::vector<int16_t>(offset_column.begin(), offset_column.end()) == offsets);
+
+        VertexPropertyColumn<double> const weight_column = properties.column<double>("weight");
+        CHECK(weight_column[vertex_count - 1] == weights.back());
+        CHECK(reinterpret_cast<uintptr_t>(weight_column.data()) % alignof(double) == 0);
+
+        CHECK_THROWS_AS(properties.column<uint16_t>("offset"), std::logic_error);
+    }
+
+    REQUIRE(std::remove(file_path.c_str()) == 0);
+}
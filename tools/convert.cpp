@@ -0,0 +1,1141 @@
+//! gdsb-convert converts graph files between the edge list, Matrix Market and
+//! GDSB binary formats. The conversion is a pipeline of three stages:
+//! - parse: the input is read in blocks of bounded size, text blocks are cut
+//!   at line boundaries and parsed by all threads in parallel
+//! - transform: optionally removes loops, relabels vertices to dense IDs in
+//!   order of first appearance, symmetrizes, and sorts and deduplicates each
+//!   block in parallel. If the graph does not fit into one block, blocks are
+//!   spilled to temporary run files.
+//! - write: the runs are merged (or concatenated if not sorted) and written,
+//!   text output is formatted by all threads in parallel.
+//! The memory in use is bounded by --memory plus the vertex map of --relabel,
+//! thus graphs larger than the main memory can be converted. Each stage prints
+//! its throughput.
+
+#include "convert.h"
+
+#include <gdsb/binary_codec.h>
+#include <gdsb/graph.h>
+#include <gdsb/graph_compression.h>
+#include <gdsb/graph_input.h>
+#include <gdsb/graph_io_parameters.h>
+#include <gdsb/graph_output.h>
+#include <gdsb/timer.h>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <unistd.h>
+
+namespace gdsb
+{
+
+namespace convert
+{
+
+namespace
+{
+
+// All fields of every input are held using the widest edge type, fields not
+// present in the input remain at their default value.
+using ConvertEdge = WeightedTimestampedEdge64;
+using ConvertTraits = EdgeTraits<ConvertEdge>;
+
+} // namespace
+
+void print_usage(std::ostream& out)
+{
+    out << "Usage: gdsb-convert [options] <input> <output>\n"
+           "\n"
+           "Converts graph files between the edge list (.edges), Matrix Market (.mtx)\n"
+           "and GDSB binary (.bin) formats.\n"
+           "\n"
+           "Options:\n"
+           "  --from edges|mtx|bin      input format, default by file extension\n"
+           "  --to edges|mtx|bin        output format, default by file extension\n"
+           "  --directed                the text input graph is directed\n"
+           "  --weighted                the text input graph is weighted (3rd column)\n"
+           "  --dynamic                 the text input graph is dynamic (last column)\n"
+           "  --remove-loops            removes edges (u, u)\n"
+           "  --relabel                 relabels vertices to [0, n) in order of appearance\n"
+           "  --symmetrize              adds (v, u) for every edge (u, v)\n"
+           "  --dedupe                  removes duplicate edges, sorts by source if not sorted\n"
+           "  --sort source|timestamp   sorts the edges\n"
+           "  --encoding raw|stream_vbyte|lz4|zstd\n"
+           "                            edge encoding of binary output, default raw\n"
+           "  --chunk-edges N           edges per chunk of chunked encodings\n"
+           "  --level N                 compression level of Zstandard\n"
+           "  --memory MiB              memory budget of edge blocks, default 1024\n"
+           "  --threads N               count of threads\n"
+           "  --tmp DIRECTORY           directory of temporary run files\n";
+}
+
+namespace
+{
+
+Format parse_format(std::string const& name)
+{
+    if (name == "edges") return Format::edge_list;
+    if (name == "mtx") return Format::matrix_market;
+    if (name == "bin") return Format::binary;
+    throw std::invalid_argument("Unknown format: " + name);
+}
+
+Format format_of(std::filesystem::path const& path)
+{
+    std::string const extension = path.extension().string();
+    if (extension == ".mtx") return Format::matrix_market;
+    if (extension == ".bin") return Format::binary;
+    return Format::edge_list;
+}
+
+EdgeEncoding parse_encoding(std::string const& name)
+{
+    if (name == "raw") return EdgeEncoding::raw;
+    if (name == "stream_vbyte") return EdgeEncoding::stream_vbyte;
+    if (name == "lz4") return EdgeEncoding::lz4;
+    if (name == "zstd") return EdgeEncoding::zstd;
+    throw std::invalid_argument("Unknown edge encoding: " + name);
+}
+
+} // namespace
+
+Options parse_options(int const argc, char** const argv)
+{
+    Options options;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string const argument = argv[i];
+        auto value = [&]() -> std::string
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::invalid_argument("Missing value of option " + argument);
+            }
+            return argv[++i];
+        };
+
+        if (argument == "--from")
+        {
+            options.input_format = parse_format(value());
+            options.input_format_set = true;
+        }
+        else if (argument == "--to")
+        {
+            options.output_format = parse_format(value());
+            options.output_format_set = true;
+        }
+        else if (argument == "--directed") options.directed = true;
+        else if (argument == "--weighted") options.weighted = true;
+        else if (argument == "--dynamic") options.dynamic = true;
+        else if (argument == "--remove-loops") options.remove_loops = true;
+        else if (argument == "--relabel") options.relabel = true;
+        else if (argument == "--symmetrize") options.symmetrize = true;
+        else if (argument == "--dedupe") options.dedupe = true;
+        else if (argument == "--sort")
+        {
+            std::string const order = value();
+            if (order == "source") options.sort = SortOrder::source;
+            else if (order == "timestamp") options.sort = SortOrder::timestamp;
+            else throw std::invalid_argument("Unknown sort order: " + order);
+        }
+        else if (argument == "--encoding") options.encoding = parse_encoding(value());
+        else if (argument == "--chunk-edges") options.chunk_edge_count = std::stoull(value());
+        else if (argument == "--level") options.compression_level = std::stoi(value());
+        else if (argument == "--memory") options.memory = std::stoull(value()) << 20;
+        else if (argument == "--threads") omp_set_num_threads(std::stoi(value()));
+        else if (argument == "--tmp") options.temporary_directory = value();
+        else if (argument == "--help" || argument == "-h")
+        {
+            print_usage(std::cout);
+            std::exit(0);
+        }
+        else if (!argument.empty() && argument.front() == '-')
+        {
+            throw std::invalid_argument("Unknown option: " + argument);
+        }
+        else
+        {
+            paths.push_back(argument);
+        }
+    }
+
+    if (paths.size() != 2)
+    {
+        throw std::invalid_argument("Expected an input and an output path.");
+    }
+
+    options.input = paths[0];
+    options.output = paths[1];
+    if (!options.input_format_set) options.input_format = format_of(options.input);
+    if (!options.output_format_set) options.output_format = format_of(options.output);
+    if (options.temporary_directory.empty())
+    {
+        options.temporary_directory = options.output.parent_path().empty() ? "." : options.output.parent_path();
+    }
+    if (options.dedupe && options.sort == SortOrder::none)
+    {
+        options.sort = SortOrder::source;
+    }
+    if (options.output_format != Format::binary && options.encoding != EdgeEncoding::raw)
+    {
+        throw std::invalid_argument("Edge encodings are supported by binary output only.");
+    }
+
+    return options;
+}
+
+namespace
+{
+
+//! Accumulates the edges, bytes and time of a pipeline stage.
+class Stage
+{
+public:
+    explicit Stage(std::string name)
+        : m_name(std::move(name))
+    {
+    }
+
+    template <typename F> auto measure(F&& f)
+    {
+        WallTimer timer;
+        timer.start();
+        struct End
+        {
+            WallTimer& timer;
+            std::chrono::nanoseconds& duration;
+            ~End()
+            {
+                timer.end();
+                duration += timer.duration();
+            }
+        } end{ timer, m_duration };
+        return f();
+    }
+
+    void add(uint64_t const edges, uint64_t const bytes)
+    {
+        m_edges += edges;
+        m_bytes += bytes;
+    }
+
+    void print(std::ostream& out) const
+    {
+        double const seconds = std::max(1e-9, std::chrono::duration<double>(m_duration).count());
+        double const mebibytes = double(m_bytes) / double(1 << 20);
+        out << m_name << ": " << m_edges << " edges, " << mebibytes << " MiB in " << seconds << " s ("
+            << double(m_edges) / seconds / 1e6 << " Medges/s, " << mebibytes / seconds << " MiB/s)" << std::endl;
+    }
+
+private:
+    std::string m_name;
+    uint64_t m_edges = 0;
+    uint64_t m_bytes = 0;
+    std::chrono::nanoseconds m_duration{ 0 };
+};
+
+// Runs f(thread_id, thread_count) in a parallel region and rethrows the last
+// exception thrown by any thread afterwards.
+template <typename F> void parallel(F&& f)
+{
+    std::exception_ptr error;
+
+#pragma omp parallel
+    {
+        try
+        {
+            f(omp_get_thread_num(), omp_get_num_threads());
+        }
+        catch (...)
+        {
+#pragma omp critical
+            error = std::current_exception();
+        }
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+//! Parses the lines of [begin, end): u v [w] [t]. Lines starting with % or #
+//! are skipped.
+void parse_lines(char const* begin, char const* const end, Options const& options, std::vector<ConvertEdge>& edges)
+{
+    std::string line;
+    while (begin < end)
+    {
+        char const* const line_end = std::find(begin, end, '\n');
+        line.assign(begin, line_end);
+        begin = line_end + 1;
+
+        size_t const first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '%' || line[first] == '#')
+        {
+            continue;
+        }
+
+        char const* source = line.c_str();
+        char* position = nullptr;
+        ConvertEdge e{};
+        unsigned long const u = read_ulong(source, &position);
+        unsigned long const v = read_ulong(position, &position);
+        if (u == std::numeric_limits<unsigned long>::max() || v == std::numeric_limits<unsigned long>::max())
+        {
+            throw std::runtime_error("Could not parse edge: " + line);
+        }
+        ConvertTraits::source(e) = u;
+        ConvertTraits::target(e) = v;
+        if (options.weighted)
+        {
+            ConvertTraits::set_weight(e, read_float(position, &position));
+        }
+        if (options.dynamic)
+        {
+            ConvertTraits::set_timestamp(e, read_ulong(position, &position));
+        }
+        edges.push_back(e);
+    }
+}
+
+//! Reads the text input in blocks of block_bytes bytes cut at line boundaries
+//! and calls sink(edges, bytes) for the edges parsed in parallel of each block.
+template <typename SinkF>
+void parse_text(Options const& options, uint64_t const block_bytes, Stage& stage, SinkF&& sink)
+{
+    std::ifstream input(options.input, std::ios::binary);
+    if (!input)
+    {
+        throw std::runtime_error("Could not open input: " + options.input.string());
+    }
+
+    std::vector<char> buffer;
+    size_t carry = 0;
+    bool size_line_pending = options.input_format == Format::matrix_market;
+
+    while (true)
+    {
+        std::vector<ConvertEdge> block;
+        size_t consumed = 0;
+        bool const done = stage.measure(
+            [&]()
+            {
+                buffer.resize(carry + block_bytes);
+                input.read(buffer.data() + carry, std::streamsize(block_bytes));
+                size_t const size = carry + size_t(input.gcount());
+                bool const at_end = size < buffer.size();
+
+                // Only complete lines are parsed, the rest is carried over.
+                size_t end = size;
+                if (!at_end)
+                {
+                    char const* const last_newline = static_cast<char const*>(memrchr(buffer.data(), '\n', size));
+                    if (!last_newline)
+                    {
+                        throw std::runtime_error("Line exceeds the block size, use a larger --memory.");
+                    }
+                    end = size_t(last_newline - buffer.data()) + 1;
+                }
+
+                // The size line of Matrix Market files follows the comments.
+                size_t begin = 0;
+                while (size_line_pending && begin < end)
+                {
+                    char const* const line_end = std::find(buffer.data() + begin, buffer.data() + end, '\n');
+                    char const first = buffer[begin];
+                    begin = size_t(line_end - buffer.data()) + 1;
+                    size_line_pending = first == '%' || first == '#' || first == '\n';
+                }
+                begin = std::min(begin, end);
+
+                int const thread_count = omp_get_max_threads();
+                std::vector<std::vector<ConvertEdge>> thread_edges(thread_count);
+                parallel(
+                    [&](int const t, int const T)
+                    {
+                        // Slices start after the first newline following their
+                        // nominal start.
+                        char const* const data = buffer.data();
+                        auto slice_begin = [&](int const s) -> char const*
+                        {
+                            if (s == 0) return data + begin;
+                            if (s == T) return data + end;
+                            char const* const nominal = data + begin + (end - begin) * uint64_t(s) / uint64_t(T);
+                            char const* const newline = std::find(nominal, data + end, '\n');
+                            return newline == data + end ? newline : newline + 1;
+                        };
+                        char const* const b = slice_begin(t);
+                        char const* const e = std::max(b, slice_begin(t + 1));
+                        parse_lines(b, e, options, thread_edges[t]);
+                    });
+
+                size_t count = 0;
+                for (auto const& edges : thread_edges) count += edges.size();
+                block.reserve(count);
+                for (auto const& edges : thread_edges) block.insert(block.end(), edges.begin(), edges.end());
+
+                consumed = end;
+                carry = size - end;
+                std::memmove(buffer.data(), buffer.data() + end, carry);
+                return at_end;
+            });
+
+        stage.add(block.size(), consumed);
+        sink(std::move(block));
+        if (done)
+        {
+            return;
+        }
+    }
+}
+
+template <typename EdgeT> ConvertEdge to_convert_edge(EdgeT const& e)
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    ConvertEdge c{};
+    ConvertTraits::source(c) = Traits::source(e);
+    ConvertTraits::target(c) = Traits::target(e);
+    ConvertTraits::set_weight(c, Traits::weight(e));
+    ConvertTraits::set_timestamp(c, Traits::timestamp(e));
+    return c;
+}
+
+template <typename EdgeT> EdgeT from_convert_edge(ConvertEdge const& c)
+{
+    using Traits = EdgeTraits<EdgeT>;
+
+    EdgeT e{};
+    Traits::source(e) = ConvertTraits::source(c);
+    Traits::target(e) = ConvertTraits::target(c);
+    Traits::set_weight(e, ConvertTraits::weight(c));
+    Traits::set_timestamp(e, ConvertTraits::timestamp(c));
+    return e;
+}
+
+//! Calls f(EdgeT{}) using the 64 bit edge type of the given flags.
+template <typename F> void dispatch_edge_type(bool const weighted, bool const dynamic, F&& f)
+{
+    if (weighted && dynamic) f(WeightedTimestampedEdge64{});
+    else if (dynamic) f(TimestampedEdge64{});
+    else if (weighted) f(WeightedEdge64{});
+    else f(Edge64{});
+}
+
+//! Reads the binary input in blocks of block_edge_count edges.
+template <typename SinkF>
+void parse_binary(Options& options, uint64_t const block_edge_count, Stage& stage, SinkF&& sink)
+{
+    std::ifstream input(options.input, std::ios::binary);
+    if (!input)
+    {
+        throw std::runtime_error("Could not open input: " + options.input.string());
+    }
+
+    BinaryGraphHeader const header = read_binary_graph_header(input);
+    options.directed = header.directed;
+    options.weighted = header.weighted;
+    options.dynamic = header.dynamic;
+    uint64_t const edge_size = binary::edge_layout(header).edge_size_in_bytes();
+
+    dispatch_edge_type(header.weighted, header.dynamic,
+                       [&](auto const edge)
+                       {
+                           using EdgeT = std::remove_const_t<decltype(edge)>;
+                           for (uint64_t begin = 0; begin < header.edge_count; begin += block_edge_count)
+                           {
+                               uint64_t const end = std::min(header.edge_count, begin + block_edge_count);
+                               std::vector<ConvertEdge> block = stage.measure(
+                                   [&]()
+                                   {
+                                       std::vector<EdgeT> const edges =
+                                           read_binary_edge_range<EdgeT>(input, header, begin, end);
+                                       std::vector<ConvertEdge> converted(edges.size());
+#pragma omp parallel for
+                                       for (int64_t i = 0; i < int64_t(edges.size()); ++i)
+                                       {
+                                           converted[i] = to_convert_edge(edges[i]);
+                                       }
+                                       return converted;
+                                   });
+                               stage.add(block.size(), block.size() * edge_size);
+                               sink(std::move(block));
+                           }
+                       });
+}
+
+std::function<bool(ConvertEdge const&, ConvertEdge const&)> edge_less(SortOrder const order)
+{
+    using T = ConvertTraits;
+    if (order == SortOrder::timestamp)
+    {
+        return [](ConvertEdge const& a, ConvertEdge const& b)
+        {
+            return std::make_tuple(T::timestamp(a), T::source(a), T::target(a)) <
+                std::make_tuple(T::timestamp(b), T::source(b), T::target(b));
+        };
+    }
+
+    return [](ConvertEdge const& a, ConvertEdge const& b)
+    {
+        return std::make_tuple(T::source(a), T::target(a), T::timestamp(a)) <
+            std::make_tuple(T::source(b), T::target(b), T::timestamp(b));
+    };
+}
+
+bool same_edge(ConvertEdge const& a, ConvertEdge const& b)
+{
+    using T = ConvertTraits;
+    return T::source(a) == T::source(b) && T::target(a) == T::target(b) && T::timestamp(a) == T::timestamp(b);
+}
+
+//! Sorts the edges in parallel: every thread sorts a slice, the slices are
+//! merged pairwise afterwards.
+void parallel_sort(std::vector<ConvertEdge>& edges, SortOrder const order)
+{
+    auto const less = edge_less(order);
+    int const thread_count = omp_get_max_threads();
+    std::vector<size_t> bounds(thread_count + 1);
+    for (int t = 0; t <= thread_count; ++t)
+    {
+        bounds[t] = edges.size() * size_t(t) / size_t(thread_count);
+    }
+
+#pragma omp parallel for
+    for (int t = 0; t < thread_count; ++t)
+    {
+        std::sort(edges.begin() + bounds[t], edges.begin() + bounds[t + 1], less);
+    }
+
+    for (int width = 1; width < thread_count; width *= 2)
+    {
+#pragma omp parallel for
+        for (int t = 0; t < thread_count; t += 2 * width)
+        {
+            if (t + width < thread_count)
+            {
+                size_t const middle = bounds[t + width];
+                size_t const last = bounds[std::min(t + 2 * width, thread_count)];
+                std::inplace_merge(edges.begin() + bounds[t], edges.begin() + middle, edges.begin() + last, less);
+            }
+        }
+    }
+}
+
+//! Sorted (or unsorted) blocks of edges, kept in memory as long as there is a
+//! single one, spilled to temporary files otherwise.
+class Runs
+{
+public:
+    explicit Runs(Options const& options)
+        : m_options(options)
+    {
+    }
+
+    ~Runs()
+    {
+        for (std::filesystem::path const& path : m_paths)
+        {
+            std::error_code ignored;
+            std::filesystem::remove(path, ignored);
+        }
+    }
+
+    void add(std::vector<ConvertEdge>&& edges)
+    {
+        if (edges.empty())
+        {
+            return;
+        }
+
+        if (m_memory.empty() && m_paths.empty())
+        {
+            m_memory = std::move(edges);
+            return;
+        }
+
+        if (!m_memory.empty())
+        {
+            spill(m_memory);
+            m_memory = {};
+        }
+        spill(edges);
+    }
+
+    bool in_memory() const { return m_paths.empty(); }
+    std::vector<ConvertEdge>& memory() { return m_memory; }
+    std::vector<std::filesystem::path> const& paths() const { return m_paths; }
+    std::vector<uint64_t> const& counts() const { return m_counts; }
+
+private:
+    void spill(std::vector<ConvertEdge> const& edges)
+    {
+        std::filesystem::path const path = m_options.temporary_directory /
+            ("gdsb-convert." + std::to_string(::getpid()) + ".run" + std::to_string(m_paths.size()));
+        m_paths.push_back(path);
+        m_counts.push_back(edges.size());
+
+        std::ofstream output(path, std::ios::binary);
+        output.write(reinterpret_cast<char const*>(edges.data()), std::streamsize(edges.size() * sizeof(ConvertEdge)));
+        if (!output.flush())
+        {
+            throw std::runtime_error("Could not write temporary run file: " + path.string());
+        }
+    }
+
+    Options const& m_options;
+    std::vector<ConvertEdge> m_memory;
+    std::vector<std::filesystem::path> m_paths;
+    std::vector<uint64_t> m_counts;
+};
+
+//! Reads a run file using a buffer of bounded size.
+class RunReader
+{
+public:
+    RunReader(std::filesystem::path const& path, uint64_t const count, size_t const buffer_edge_count)
+        : m_input(path, std::ios::binary)
+        , m_remaining(count)
+        , m_buffer(std::max(size_t(1), buffer_edge_count))
+    {
+        refill();
+    }
+
+    bool empty() const { return m_position == m_size; }
+    ConvertEdge const& front() const { return m_buffer[m_position]; }
+
+    void pop()
+    {
+        if (++m_position == m_size)
+        {
+            refill();
+        }
+    }
+
+private:
+    void refill()
+    {
+        m_size = size_t(std::min(uint64_t(m_buffer.size()), m_remaining));
+        m_position = 0;
+        m_input.read(reinterpret_cast<char*>(m_buffer.data()), std::streamsize(m_size * sizeof(ConvertEdge)));
+        if (!m_input && m_size > 0)
+        {
+            throw std::runtime_error("Could not read temporary run file.");
+        }
+        m_remaining -= m_size;
+    }
+
+    std::ifstream m_input;
+    uint64_t m_remaining;
+    std::vector<ConvertEdge> m_buffer;
+    size_t m_size = 0;
+    size_t m_position = 0;
+};
+
+//! Output of the write stage, edges are passed block wise in order.
+class EdgeWriter
+{
+public:
+    virtual ~EdgeWriter() = default;
+    virtual void write(ConvertEdge const* edges, size_t count) = 0;
+    virtual void finish() = 0;
+    uint64_t bytes() const { return m_bytes; }
+
+protected:
+    uint64_t m_bytes = 0;
+};
+
+//! Writes edge list or Matrix Market lines formatted in parallel.
+class TextWriter : public EdgeWriter
+{
+public:
+    TextWriter(Options const& options, uint64_t const vertex_count)
+        : m_options(options)
+        , m_output(options.output, std::ios::binary)
+    {
+        if (!m_output)
+        {
+            throw std::runtime_error("Could not open output: " + options.output.string());
+        }
+
+        if (options.output_format == Format::matrix_market)
+        {
+            m_output << "%%MatrixMarket matrix coordinate " << (options.weighted ? "real" : "pattern") << " general\n";
+            // The edge count is known once all edges are written, thus the size
+            // line is padded and rewritten by finish().
+            m_size_line_position = m_output.tellp();
+            m_vertex_count = vertex_count;
+            write_size_line(0);
+        }
+    }
+
+    void write(ConvertEdge const* const edges, size_t const count) override
+    {
+        int const thread_count = omp_get_max_threads();
+        std::vector<std::string> texts(thread_count);
+        parallel(
+            [&](int const t, int const T)
+            {
+                size_t const begin = count * size_t(t) / size_t(T);
+                size_t const end = count * size_t(t + 1) / size_t(T);
+                std::string& text = texts[t];
+                text.reserve((end - begin) * 24);
+                char number[32];
+                auto append = [&](uint64_t const value, char const separator)
+                {
+                    char* const last = std::to_chars(number, number + sizeof(number), value).ptr;
+                    text.append(number, last);
+                    text.push_back(separator);
+                };
+                for (size_t i = begin; i < end; ++i)
+                {
+                    ConvertEdge const& e = edges[i];
+                    append(ConvertTraits::source(e), ' ');
+                    append(ConvertTraits::target(e), m_options.weighted || m_options.dynamic ? ' ' : '\n');
+                    if (m_options.weighted)
+                    {
+                        double const weight = double(ConvertTraits::weight(e));
+                        int const length = std::snprintf(number, sizeof(number), "%.9g", weight);
+                        text.append(number, size_t(length));
+                        text.push_back(m_options.dynamic ? ' ' : '\n');
+                    }
+                    if (m_options.dynamic)
+                    {
+                        append(ConvertTraits::timestamp(e), '\n');
+                    }
+                }
+            });
+
+        for (std::string const& text : texts)
+        {
+            m_output.write(text.data(), std::streamsize(text.size()));
+            m_bytes += text.size();
+        }
+        m_edge_count += count;
+    }
+
+    void finish() override
+    {
+        if (m_options.output_format == Format::matrix_market)
+        {
+            m_output.seekp(m_size_line_position);
+            write_size_line(m_edge_count);
+        }
+
+        if (!m_output.flush())
+        {
+            throw std::runtime_error("Could not write output: " + m_options.output.string());
+        }
+    }
+
+private:
+    void write_size_line(uint64_t const edge_count)
+    {
+        char line[80];
+        std::snprintf(line, sizeof(line), "%20llu %20llu %20llu\n", static_cast<unsigned long long>(m_vertex_count),
+                      static_cast<unsigned long long>(m_vertex_count), static_cast<unsigned long long>(edge_count));
+        m_output << line;
+    }
+
+    Options const& m_options;
+    std::ofstream m_output;
+    std::streampos m_size_line_position;
+    uint64_t m_vertex_count = 0;
+    uint64_t m_edge_count = 0;
+};
+
+//! Writes a GDSB binary graph using the narrowest layout for the largest
+//! vertex ID and timestamp. The header is written last since the edge count
+//! is known once all edges are written.
+template <typename EdgeT> class BinaryWriter : public EdgeWriter
+{
+public:
+    BinaryWriter(Options const& options, uint64_t const vertex_count, uint64_t const max_timestamp)
+        : m_options(options)
+        , m_output(options.output)
+    {
+        m_layout = binary::native_edge_layout<EdgeT>();
+        m_layout.vertex_id_byte_size = binary::byte_width(vertex_count > 0 ? vertex_count - 1 : 0);
+        m_layout.timestamp_byte_size = binary::byte_width(max_timestamp);
+
+        m_header.vertex_count = vertex_count;
+        m_header.vertex_id_byte_size = m_layout.vertex_id_byte_size;
+        m_header.weight_byte_size = m_layout.weight_byte_size;
+        m_header.timestamp_byte_size = m_layout.timestamp_byte_size;
+        m_header.directed = options.directed;
+        m_header.weighted = options.weighted;
+        m_header.dynamic = options.dynamic;
+        m_header.encoding = options.encoding;
+
+        if (is_chunked(options.encoding))
+        {
+            if (options.encoding != EdgeEncoding::stream_vbyte && !block_codec::supported(options.encoding))
+            {
+                throw std::logic_error("GDSB has not been built with support for edge encoding: " +
+                                       std::to_string(int(options.encoding)));
+            }
+
+            // The chunk directory precedes the chunks, thus chunks are written to
+            // a temporary file first.
+            m_chunks_path = options.output;
+            m_chunks_path += ".chunks." + std::to_string(::getpid());
+            m_chunks.open(m_chunks_path, std::ios::binary);
+            m_directory.chunk_edge_count = options.chunk_edge_count;
+        }
+    }
+
+    ~BinaryWriter() override
+    {
+        if (!m_chunks_path.empty())
+        {
+            std::error_code ignored;
+            std::filesystem::remove(m_chunks_path, ignored);
+        }
+    }
+
+    void write(ConvertEdge const* const edges, size_t const count) override
+    {
+        m_pending.reserve(m_pending.size() + count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            m_pending.push_back(from_convert_edge<EdgeT>(edges[i]));
+        }
+
+        // Chunks must hold chunk_edge_count edges except for the last one.
+        size_t const flush_count = is_chunked(m_options.encoding)
+            ? m_pending.size() / m_options.chunk_edge_count * m_options.chunk_edge_count
+            : m_pending.size();
+        flush(flush_count);
+    }
+
+    void finish() override
+    {
+        flush(m_pending.size());
+
+        uint64_t const edges_begin = sizeof(BinaryGraphHeaderIdentifier) + sizeof(BinaryGraphHeader);
+        m_header.edge_count = m_edge_count;
+        BinaryGraphHeaderIdentifier const id;
+        m_output.write(&id, sizeof(id), 0);
+        m_output.write(&m_header, sizeof(m_header), sizeof(id));
+
+        if (is_chunked(m_options.encoding))
+        {
+            std::ostringstream directory;
+            write_chunk_directory(directory, m_directory);
+            std::string const directory_bytes = directory.str();
+            m_output.write(directory_bytes.data(), directory_bytes.size(), edges_begin);
+
+            m_chunks.close();
+            std::ifstream chunks(m_chunks_path, std::ios::binary);
+            std::vector<char> buffer(size_t(1) << 24);
+            uint64_t offset = edges_begin + directory_bytes.size();
+            while (chunks.read(buffer.data(), std::streamsize(buffer.size())) || chunks.gcount() > 0)
+            {
+                m_output.write(buffer.data(), size_t(chunks.gcount()), offset);
+                offset += uint64_t(chunks.gcount());
+            }
+            m_bytes += directory_bytes.size();
+        }
+    }
+
+private:
+    void flush(size_t const count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (!is_chunked(m_options.encoding))
+        {
+            std::vector<uint8_t> bytes(count * m_layout.edge_size_in_bytes());
+            parallel(
+                [&](int const t, int const T)
+                {
+                    size_t const begin = count * size_t(t) / size_t(T);
+                    size_t const end = count * size_t(t + 1) / size_t(T);
+                    binary::encode_edges(m_pending.data() + begin, end - begin, m_layout,
+                                         bytes.data() + begin * m_layout.edge_size_in_bytes());
+                });
+
+            uint64_t const edges_begin = sizeof(BinaryGraphHeaderIdentifier) + sizeof(BinaryGraphHeader);
+            m_output.write(bytes.data(), bytes.size(), edges_begin + m_edge_count * m_layout.edge_size_in_bytes());
+            m_bytes += bytes.size();
+        }
+        else
+        {
+            std::vector<std::vector<uint8_t>> const chunks =
+                encode_edge_chunks(m_options.encoding, m_pending.data(), count, m_options.chunk_edge_count, m_layout,
+                                   m_options.compression_level);
+            for (std::vector<uint8_t> const& chunk : chunks)
+            {
+                m_chunks.write(reinterpret_cast<char const*>(chunk.data()), std::streamsize(chunk.size()));
+                m_directory.offsets.push_back(m_directory.offsets.back() + chunk.size());
+                m_bytes += chunk.size();
+            }
+            if (!m_chunks)
+            {
+                throw std::runtime_error("Could not write temporary chunk file: " + m_chunks_path.string());
+            }
+        }
+
+        m_edge_count += count;
+        m_pending.erase(m_pending.begin(), m_pending.begin() + count);
+    }
+
+    Options const& m_options;
+    ParallelFileWriter m_output;
+    binary::EdgeLayout m_layout;
+    BinaryGraphHeader m_header;
+    std::vector<EdgeT> m_pending;
+    uint64_t m_edge_count = 0;
+    std::filesystem::path m_chunks_path;
+    std::ofstream m_chunks;
+    EdgeChunkDirectory m_directory;
+};
+
+std::unique_ptr<EdgeWriter>
+make_writer(Options const& options, uint64_t const vertex_count, uint64_t const max_timestamp)
+{
+    if (options.output_format != Format::binary)
+    {
+        return std::make_unique<TextWriter>(options, vertex_count);
+    }
+
+    std::unique_ptr<EdgeWriter> writer;
+    dispatch_edge_type(options.weighted, options.dynamic,
+                       [&](auto const edge)
+                       {
+                           using EdgeT = std::remove_const_t<decltype(edge)>;
+                           writer = std::make_unique<BinaryWriter<EdgeT>>(options, vertex_count, max_timestamp);
+                       });
+    return writer;
+}
+
+//! Passes the edges of all runs to the writer: merged if sorted, concatenated
+//! otherwise. Duplicates are removed while merging if requested.
+void write_runs(Options const& options, Runs& runs, uint64_t const block_edge_count, EdgeWriter& writer, Stage& stage)
+{
+    if (runs.in_memory())
+    {
+        std::vector<ConvertEdge> const& edges = runs.memory();
+        for (size_t begin = 0; begin < edges.size(); begin += block_edge_count)
+        {
+            size_t const count = std::min(size_t(block_edge_count), edges.size() - begin);
+            stage.measure([&]() { writer.write(edges.data() + begin, count); });
+            stage.add(count, 0);
+        }
+        return;
+    }
+
+    size_t const run_count = runs.paths().size();
+    size_t const buffer_edge_count = block_edge_count / (2 * run_count) + 1;
+    std::vector<RunReader> readers;
+    readers.reserve(run_count);
+    for (size_t r = 0; r < run_count; ++r)
+    {
+        readers.emplace_back(runs.paths()[r], runs.counts()[r], buffer_edge_count);
+    }
+
+    size_t const block_capacity = block_edge_count / 2 + 1;
+    std::vector<ConvertEdge> block;
+    block.reserve(block_capacity);
+    ConvertEdge last{};
+    bool has_last = false;
+    auto emit = [&](ConvertEdge const& e)
+    {
+        // Duplicates are adjacent since runs are sorted if deduplicated.
+        if (options.dedupe && has_last && same_edge(last, e))
+        {
+            return;
+        }
+        last = e;
+        has_last = true;
+
+        block.push_back(e);
+        if (block.size() == block_capacity)
+        {
+            writer.write(block.data(), block.size());
+            stage.add(block.size(), 0);
+            block.clear();
+        }
+    };
+
+    stage.measure(
+        [&]()
+        {
+            if (options.sort == SortOrder::none)
+            {
+                for (RunReader& reader : readers)
+                {
+                    for (; !reader.empty(); reader.pop())
+                    {
+                        emit(reader.front());
+                    }
+                }
+            }
+            else
+            {
+                auto const less = edge_less(options.sort);
+                auto greater = [&](size_t const a, size_t const b)
+                { return less(readers[b].front(), readers[a].front()); };
+                std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(greater);
+                for (size_t r = 0; r < run_count; ++r)
+                {
+                    if (!readers[r].empty()) heap.push(r);
+                }
+
+                while (!heap.empty())
+                {
+                    size_t const r = heap.top();
+                    heap.pop();
+                    emit(readers[r].front());
+                    readers[r].pop();
+                    if (!readers[r].empty()) heap.push(r);
+                }
+            }
+
+            if (!block.empty())
+            {
+                writer.write(block.data(), block.size());
+                stage.add(block.size(), 0);
+            }
+        });
+}
+
+} // namespace
+
+void convert(Options options, std::ostream& out)
+{
+    out << "gdsb-convert: " << options.input << " -> " << options.output << " using " << omp_get_max_threads()
+        << " threads" << std::endl;
+
+    // Half of the memory budget for the block being transformed, the other
+    // half for parsing and formatting buffers.
+    uint64_t const block_edge_count = std::max(uint64_t(1) << 10, options.memory / 2 / sizeof(ConvertEdge));
+    uint64_t const block_bytes = std::max(uint64_t(1) << 16, options.memory / 4);
+
+    Stage parse("parse");
+    Stage transform("transform");
+    Stage write("write");
+
+    Runs runs(options);
+    std::unordered_map<uint64_t, uint64_t> labels;
+    uint64_t max_vertex = 0;
+    uint64_t max_timestamp = 0;
+    bool has_edges = false;
+
+    auto sink = [&](std::vector<ConvertEdge>&& block)
+    {
+        transform.measure(
+            [&]()
+            {
+                using T = ConvertTraits;
+                if (options.remove_loops)
+                {
+                    auto const is_loop = [](ConvertEdge const& e) { return T::source(e) == T::target(e); };
+                    block.erase(std::remove_if(block.begin(), block.end(), is_loop), block.end());
+                }
+
+                if (options.relabel)
+                {
+                    auto label = [&](uint64_t const vertex)
+                    { return labels.emplace(vertex, labels.size()).first->second; };
+                    for (ConvertEdge& e : block)
+                    {
+                        T::source(e) = label(T::source(e));
+                        T::target(e) = label(T::target(e));
+                    }
+                }
+
+                if (options.symmetrize)
+                {
+                    size_t const count = block.size();
+                    block.resize(2 * count);
+                    size_t reverse = count;
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        if (T::source(block[i]) != T::target(block[i]))
+                        {
+                            block[reverse] = block[i];
+                            std::swap(T::source(block[reverse]), T::target(block[reverse]));
+                            ++reverse;
+                        }
+                    }
+                    block.resize(reverse);
+                }
+
+                uint64_t block_max_vertex = 0;
+                uint64_t block_max_timestamp = 0;
+#pragma omp parallel for reduction(max : block_max_vertex, block_max_timestamp)
+                for (int64_t i = 0; i < int64_t(block.size()); ++i)
+                {
+                    block_max_vertex = std::max(block_max_vertex, std::max(T::source(block[i]), T::target(block[i])));
+                    block_max_timestamp = std::max(block_max_timestamp, uint64_t(T::timestamp(block[i])));
+                }
+                max_vertex = std::max(max_vertex, block_max_vertex);
+                max_timestamp = std::max(max_timestamp, block_max_timestamp);
+                has_edges = has_edges || !block.empty();
+
+                if (options.sort != SortOrder::none)
+                {
+                    parallel_sort(block, options.sort);
+                    if (options.dedupe)
+                    {
+                        block.erase(std::unique(block.begin(), block.end(), same_edge), block.end());
+                    }
+                }
+
+                transform.add(block.size(), block.size() * sizeof(ConvertEdge));
+                runs.add(std::move(block));
+            });
+    };
+
+    if (options.input_format == Format::binary)
+    {
+        parse_binary(options, block_edge_count, parse, sink);
+    }
+    else
+    {
+        parse_text(options, block_bytes, parse, sink);
+    }
+
+    uint64_t const vertex_count = has_edges ? max_vertex + 1 : 0;
+    std::unique_ptr<EdgeWriter> writer = make_writer(options, vertex_count, max_timestamp);
+    write_runs(options, runs, block_edge_count, *writer, write);
+    write.measure([&]() { writer->finish(); });
+    write.add(0, writer->bytes());
+
+    parse.print(out);
+    transform.print(out);
+    write.print(out);
+}
+
+} // namespace convert
+
+} // namespace gdsb
@@ -0,0 +1,68 @@
+#pragma once
+
+//! The conversion pipeline of gdsb-convert, see convert.cpp. It is a library
+//! of its own such that the tests can run conversions without the executable.
+
+#include <gdsb/graph_io_parameters.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+
+namespace gdsb
+{
+
+namespace convert
+{
+
+enum class Format
+{
+    edge_list,
+    matrix_market,
+    binary
+};
+
+enum class SortOrder
+{
+    none,
+    source,
+    timestamp
+};
+
+struct Options
+{
+    std::filesystem::path input;
+    std::filesystem::path output;
+    Format input_format = Format::edge_list;
+    Format output_format = Format::binary;
+    bool input_format_set = false;
+    bool output_format_set = false;
+    bool directed = false;
+    bool weighted = false;
+    bool dynamic = false;
+    bool remove_loops = false;
+    bool relabel = false;
+    bool symmetrize = false;
+    bool dedupe = false;
+    SortOrder sort = SortOrder::none;
+    uint64_t memory = uint64_t(1) << 30;
+    EdgeEncoding encoding = EdgeEncoding::raw;
+    uint64_t chunk_edge_count = uint64_t(1) << 16;
+    int compression_level = 1;
+    std::filesystem::path temporary_directory;
+};
+
+void print_usage(std::ostream& out);
+
+//! Parses the command line arguments of gdsb-convert and completes the options
+//! depending on others, e.g. the formats given by the file extensions.
+//! Throws std::invalid_argument on invalid arguments.
+Options parse_options(int argc, char** argv);
+
+//! Converts options.input to options.output and prints the throughput of each
+//! pipeline stage to out.
+void convert(Options options, std::ostream& out);
+
+} // namespace convert
+
+} // namespace gdsb
@@ -0,0 +1,28 @@
+//! gdsb-convert converts graph files between the edge list, Matrix Market and
+//! GDSB binary formats, see convert.cpp for the conversion pipeline.
+
+#include "convert.h"
+
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        gdsb::convert::convert(gdsb::convert::parse_options(argc, argv), std::cout);
+        return 0;
+    }
+    catch (std::invalid_argument const& e)
+    {
+        std::cerr << "gdsb-convert: " << e.what() << "\n\n";
+        gdsb::convert::print_usage(std::cerr);
+        return 2;
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "gdsb-convert: " << e.what() << std::endl;
+        return 1;
+    }
+}